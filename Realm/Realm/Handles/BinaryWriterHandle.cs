@@ -0,0 +1,72 @@
+﻿////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Runtime.InteropServices;
+
+namespace Realms
+{
+    // Collects the chunks of a binary value on the native side and sets it on the object when committed.
+    internal class BinaryWriterHandle : RealmHandle
+    {
+        private static class NativeMethods
+        {
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "binary_writer_append", CallingConvention = CallingConvention.Cdecl)]
+            public static extern void append(BinaryWriterHandle handle, IntPtr buffer, IntPtr bufferLength, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "binary_writer_commit", CallingConvention = CallingConvention.Cdecl)]
+            public static extern void commit(BinaryWriterHandle handle, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "binary_writer_destroy", CallingConvention = CallingConvention.Cdecl)]
+            public static extern void destroy(IntPtr handle);
+        }
+
+        [Preserve]
+        public BinaryWriterHandle()
+        {
+        }
+
+        public unsafe void Append(byte[] buffer, int offset, int count)
+        {
+            if (offset < 0 || count < 0 || buffer.Length - offset < count)
+            {
+                throw new ArgumentOutOfRangeException(nameof(count));
+            }
+
+            NativeException nativeException;
+            fixed (byte* bufferPtr = buffer)
+            {
+                NativeMethods.append(this, (IntPtr)(bufferPtr + offset), (IntPtr)count, out nativeException);
+            }
+
+            nativeException.ThrowIfNecessary();
+        }
+
+        public void Commit()
+        {
+            NativeException nativeException;
+            NativeMethods.commit(this, out nativeException);
+            nativeException.ThrowIfNecessary();
+        }
+
+        protected override void Unbind()
+        {
+            NativeMethods.destroy(handle);
+        }
+    }
+}
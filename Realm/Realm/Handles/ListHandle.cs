@@ -18,6 +18,7 @@
 
 using System;
 using System.Runtime.InteropServices;
+using Realms.Native;
 
 namespace Realms
 {
@@ -46,6 +47,12 @@ private static class NativeMethods
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "list_size", CallingConvention = CallingConvention.Cdecl)]
             public static extern IntPtr size(ListHandle listHandle, out NativeException ex);
 
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "list_aggregate", CallingConvention = CallingConvention.Cdecl)]
+            public static extern void aggregate(ListHandle listHandle, IntPtr propertyIndex, AggregateType type, out PrimitiveValue result, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "list_get_results", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr get_results(ListHandle listHandle, out NativeException ex);
+
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "list_destroy", CallingConvention = CallingConvention.Cdecl)]
             public static extern void destroy(IntPtr listInternalHandle);
 
@@ -150,6 +157,23 @@ public override int Count()
             return (int)result;
         }
 
+        public PrimitiveValue Aggregate(IntPtr propertyIndex, AggregateType type)
+        {
+            NativeException nativeException;
+            PrimitiveValue result;
+            NativeMethods.aggregate(this, propertyIndex, type, out result, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return result;
+        }
+
+        public ResultsHandle GetResults()
+        {
+            NativeException nativeException;
+            var result = NativeMethods.get_results(this, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return Realm.CreateResultsHandle(result);
+        }
+
         public override ThreadSafeReferenceHandle GetThreadSafeReference()
         {
             NativeException nativeException;
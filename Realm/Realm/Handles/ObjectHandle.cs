@@ -20,6 +20,7 @@
 using System.Diagnostics.CodeAnalysis;
 using System.Linq;
 using System.Runtime.InteropServices;
+using Realms.Native;
 
 namespace Realms
 {
@@ -56,9 +57,12 @@ private static class NativeMethods
             public static extern void set_string_unique(ObjectHandle handle, IntPtr propertyIndex,
                 [MarshalAs(UnmanagedType.LPWStr)] string value, IntPtr valueLen, out NativeException ex);
 
-            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "object_get_string", CallingConvention = CallingConvention.Cdecl)]
-            public static extern IntPtr get_string(ObjectHandle handle, IntPtr propertyIndex,
-                IntPtr buffer, IntPtr bufsize, [MarshalAs(UnmanagedType.I1)] out bool isNull, out NativeException ex);
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "object_get_string_view", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr get_string_view(ObjectHandle handle, IntPtr propertyIndex,
+                out IntPtr size, [MarshalAs(UnmanagedType.I1)] out bool isNull, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "object_pin_read_version", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr pin_read_version(ObjectHandle handle, out NativeException ex);
 
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "object_set_link", CallingConvention = CallingConvention.Cdecl)]
             public static extern void set_link(ObjectHandle handle, IntPtr propertyIndex, ObjectHandle targetHandle, out NativeException ex);
@@ -124,10 +128,29 @@ private static class NativeMethods
             public static extern IntPtr set_binary(ObjectHandle handle, IntPtr propertyIndex,
                 IntPtr buffer, IntPtr bufferLength, out NativeException ex);
 
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "object_get_values", CallingConvention = CallingConvention.Cdecl)]
+            public static extern unsafe IntPtr get_values(ObjectHandle handle, ulong* mask, IntPtr maskWords,
+                PrimitiveValue* values, IntPtr valuesCount, char* stringBuffer, IntPtr stringBufferSize, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "object_set_values", CallingConvention = CallingConvention.Cdecl)]
+            public static extern unsafe void set_values(ObjectHandle handle, PropertyValue* values, IntPtr valuesCount,
+                char* stringPool, byte* binaryPool, out NativeException ex);
+
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "object_get_binary", CallingConvention = CallingConvention.Cdecl)]
             public static extern IntPtr get_binary(ObjectHandle handle, IntPtr propertyIndex,
                 IntPtr buffer, IntPtr bufferLength, [MarshalAs(UnmanagedType.I1)] out bool is_null, out NativeException ex);
 
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "object_get_binary_size", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr get_binary_size(ObjectHandle handle, IntPtr propertyIndex,
+                [MarshalAs(UnmanagedType.I1)] out bool is_null, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "object_get_binary_chunk", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr get_binary_chunk(ObjectHandle handle, IntPtr propertyIndex, IntPtr offset,
+                IntPtr buffer, IntPtr bufferLength, [MarshalAs(UnmanagedType.I1)] out bool is_null, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "object_open_binary_writer", CallingConvention = CallingConvention.Cdecl)]
+            public static extern BinaryWriterHandle open_binary_writer(ObjectHandle handle, IntPtr propertyIndex, IntPtr expectedSize, out NativeException ex);
+
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "object_remove_row", CallingConvention = CallingConvention.Cdecl)]
             public static extern void remove_row(ObjectHandle handle, RealmHandle realmHandle, out NativeException ex);
 
@@ -156,13 +179,50 @@ public bool IsValid
             }
         }
 
+        public long RowIndex
+        {
+            get
+            {
+                NativeException nativeException;
+                var result = NativeMethods.get_row_index(this, out nativeException);
+                nativeException.ThrowIfNecessary();
+                return (long)result;
+            }
+        }
+
         // keep this one even though warned that it is not used. It is in fact used by marshalling
         // used by P/Invoke to automatically construct a TableHandle when returning a size_t as a TableHandle
+        // While set, the primitive setters collect their values here instead of calling into native code,
+        // so that they can all be applied with a single object_set_values call. Primary keys, links and lists
+        // are still set right away, so that the row has its key before any linked object is added.
+        private PropertyValueBuffer _pendingValues;
+
         [Preserve]
         public ObjectHandle(SharedRealmHandle sharedRealmHandle) : base(sharedRealmHandle)
         {
         }
 
+        public void BeginPendingValues(PropertyValueBuffer buffer)
+        {
+            buffer.Clear();
+            _pendingValues = buffer;
+        }
+
+        public void ApplyPendingValues()
+        {
+            var buffer = _pendingValues;
+            _pendingValues = null;
+            if (buffer?.Count > 0)
+            {
+                SetValues(buffer);
+            }
+        }
+
+        public void DiscardPendingValues()
+        {
+            _pendingValues = null;
+        }
+
         public override bool Equals(object obj)
         {
             // If parameter is null, return false. 
@@ -206,6 +266,12 @@ internal ListHandle TableLinkList(IntPtr propertyIndex)
     
         public void SetDateTimeOffset(IntPtr propertyIndex, DateTimeOffset value)
         {
+            if (_pendingValues != null)
+            {
+                _pendingValues.AddDateTimeOffset(propertyIndex, value);
+                return;
+            }
+
             NativeException nativeException;
             var ticks = value.ToUniversalTime().Ticks;
             NativeMethods.set_timestamp_ticks(this, propertyIndex, ticks, out nativeException);
@@ -214,6 +280,20 @@ public void SetDateTimeOffset(IntPtr propertyIndex, DateTimeOffset value)
 
         public void SetNullableDateTimeOffset(IntPtr propertyIndex, DateTimeOffset? value)
         {
+            if (_pendingValues != null)
+            {
+                if (value.HasValue)
+                {
+                    _pendingValues.AddDateTimeOffset(propertyIndex, value.Value);
+                }
+                else
+                {
+                    _pendingValues.AddNull(propertyIndex);
+                }
+
+                return;
+            }
+
             NativeException nativeException;
             if (value.HasValue)
             {
@@ -247,6 +327,12 @@ public DateTimeOffset GetDateTimeOffset(IntPtr propertyIndex)
 
         public void SetString(IntPtr propertyIndex, string value)
         {
+            if (_pendingValues != null)
+            {
+                _pendingValues.AddString(propertyIndex, value);
+                return;
+            }
+
             NativeException nativeException;
             if (value != null)
             {
@@ -274,7 +360,40 @@ public void SetStringUnique(IntPtr propertyIndex, string value)
 
         public string GetString(IntPtr propertyIndex)
         {
-            return MarshalHelpers.GetString((IntPtr buffer, IntPtr length, out bool isNull, out NativeException ex) => NativeMethods.get_string(this, propertyIndex, buffer, length, out isNull, out ex));
+            NativeException nativeException;
+            IntPtr size;
+            bool isNull;
+            var data = NativeMethods.get_string_view(this, propertyIndex, out size, out isNull, out nativeException);
+            nativeException.ThrowIfNecessary();
+
+            // decode straight out of the mapped file, before anything else gets a chance to touch the Realm
+            return isNull ? null : MarshalHelpers.GetUtf8String(data, (int)size);
+        }
+
+        /// <summary>
+        /// Returns the UTF-8 bytes of a string property without copying them. The view is only valid until the Realm
+        /// advances to a newer version or is written to, unless the version has been pinned with <see cref="PinReadVersion"/>.
+        /// </summary>
+        public IntPtr GetStringView(IntPtr propertyIndex, out int size, out bool isNull)
+        {
+            NativeException nativeException;
+            IntPtr nativeSize;
+            var result = NativeMethods.get_string_view(this, propertyIndex, out nativeSize, out isNull, out nativeException);
+            nativeException.ThrowIfNecessary();
+            size = (int)nativeSize;
+            return result;
+        }
+
+        // The pin shares the Realm's root, so that when it is finalized it is released on the Realm's thread.
+        public ReadVersionPinHandle PinReadVersion()
+        {
+            NativeException nativeException;
+            var result = NativeMethods.pin_read_version(this, out nativeException);
+            nativeException.ThrowIfNecessary();
+
+            var pinHandle = new ReadVersionPinHandle(Root ?? this);
+            pinHandle.SetHandle(result);
+            return pinHandle;
         }
 
         public void SetLink(IntPtr propertyIndex, ObjectHandle targetHandle)
@@ -317,6 +436,12 @@ public bool LinklistIsEmpty(IntPtr propertyIndex)
 
         public void SetBoolean(IntPtr propertyIndex, bool value)
         {
+            if (_pendingValues != null)
+            {
+                _pendingValues.AddBool(propertyIndex, value);
+                return;
+            }
+
             NativeException nativeException;
             NativeMethods.set_bool(this, propertyIndex, MarshalHelpers.BoolToIntPtr(value), out nativeException);
             nativeException.ThrowIfNecessary();
@@ -324,6 +449,20 @@ public void SetBoolean(IntPtr propertyIndex, bool value)
 
         public void SetNullableBoolean(IntPtr propertyIndex, bool? value)
         {
+            if (_pendingValues != null)
+            {
+                if (value.HasValue)
+                {
+                    _pendingValues.AddBool(propertyIndex, value.Value);
+                }
+                else
+                {
+                    _pendingValues.AddNull(propertyIndex);
+                }
+
+                return;
+            }
+
             NativeException nativeException;
             if (value.HasValue)
             {
@@ -356,6 +495,12 @@ public bool GetBoolean(IntPtr propertyIndex)
 
         public void SetInt64(IntPtr propertyIndex, long value)
         {
+            if (_pendingValues != null)
+            {
+                _pendingValues.AddInt64(propertyIndex, value);
+                return;
+            }
+
             NativeException nativeException;
             NativeMethods.set_int64(this, propertyIndex, value, out nativeException);
             nativeException.ThrowIfNecessary();
@@ -363,6 +508,20 @@ public void SetInt64(IntPtr propertyIndex, long value)
 
         public void SetNullableInt64(IntPtr propertyIndex, long? value)
         {
+            if (_pendingValues != null)
+            {
+                if (value.HasValue)
+                {
+                    _pendingValues.AddInt64(propertyIndex, value.Value);
+                }
+                else
+                {
+                    _pendingValues.AddNull(propertyIndex);
+                }
+
+                return;
+            }
+
             NativeException nativeException;
             if (value.HasValue)
             {
@@ -417,6 +576,12 @@ public long GetInt64(IntPtr propertyIndex)
 
         public void SetSingle(IntPtr propertyIndex, float value)
         {
+            if (_pendingValues != null)
+            {
+                _pendingValues.AddSingle(propertyIndex, value);
+                return;
+            }
+
             NativeException nativeException;
             NativeMethods.set_float(this, propertyIndex, value, out nativeException);
             nativeException.ThrowIfNecessary();
@@ -424,6 +589,20 @@ public void SetSingle(IntPtr propertyIndex, float value)
 
         public void SetNullableSingle(IntPtr propertyIndex, float? value)
         {
+            if (_pendingValues != null)
+            {
+                if (value.HasValue)
+                {
+                    _pendingValues.AddSingle(propertyIndex, value.Value);
+                }
+                else
+                {
+                    _pendingValues.AddNull(propertyIndex);
+                }
+
+                return;
+            }
+
             NativeException nativeException;
             if (value.HasValue)
             {
@@ -456,6 +635,12 @@ public float GetSingle(IntPtr propertyIndex)
 
         public void SetDouble(IntPtr propertyIndex, double value)
         {
+            if (_pendingValues != null)
+            {
+                _pendingValues.AddDouble(propertyIndex, value);
+                return;
+            }
+
             NativeException nativeException;
             NativeMethods.set_double(this, propertyIndex, value, out nativeException);
             nativeException.ThrowIfNecessary();
@@ -463,6 +648,20 @@ public void SetDouble(IntPtr propertyIndex, double value)
 
         public void SetNullableDouble(IntPtr propertyIndex, double? value)
         {
+            if (_pendingValues != null)
+            {
+                if (value.HasValue)
+                {
+                    _pendingValues.AddDouble(propertyIndex, value.Value);
+                }
+                else
+                {
+                    _pendingValues.AddNull(propertyIndex);
+                }
+
+                return;
+            }
+
             NativeException nativeException;
             if (value.HasValue)
             {
@@ -493,8 +692,59 @@ public double GetDouble(IntPtr propertyIndex)
             return hasValue ? value : (double?)null;
         }
 
+        /// <summary>
+        /// Reads all primitive properties selected by <paramref name="mask"/> (bit i of mask[i / 64] selects property i)
+        /// into consecutive elements of <paramref name="values"/> with a single native call. Strings are decoded into
+        /// <paramref name="stringBuffer"/>, which is replaced with a larger one if it is too small.
+        /// </summary>
+        public unsafe void GetValues(ulong[] mask, PrimitiveValue[] values, ref char[] stringBuffer)
+        {
+            while (true)
+            {
+                NativeException nativeException;
+                int stringUnits;
+                fixed (ulong* maskPtr = mask)
+                fixed (PrimitiveValue* valuesPtr = values)
+                fixed (char* stringsPtr = stringBuffer)
+                {
+                    stringUnits = (int)NativeMethods.get_values(this, maskPtr, (IntPtr)mask.Length, valuesPtr, (IntPtr)values.Length, stringsPtr, (IntPtr)stringBuffer.Length, out nativeException);
+                }
+
+                nativeException.ThrowIfNecessary();
+
+                if (stringUnits <= stringBuffer.Length)
+                {
+                    return;
+                }
+
+                stringBuffer = new char[stringUnits];
+            }
+        }
+
+        /// <summary>
+        /// Applies all values collected in <paramref name="buffer"/> to the object with a single native call.
+        /// </summary>
+        public unsafe void SetValues(PropertyValueBuffer buffer)
+        {
+            NativeException nativeException;
+            fixed (PropertyValue* valuesPtr = buffer.Values)
+            fixed (char* stringsPtr = buffer.Strings)
+            fixed (byte* binariesPtr = buffer.Binaries)
+            {
+                NativeMethods.set_values(this, valuesPtr, (IntPtr)buffer.Count, stringsPtr, binariesPtr, out nativeException);
+            }
+
+            nativeException.ThrowIfNecessary();
+        }
+
         public unsafe void SetByteArray(IntPtr propertyIndex, byte[] value)
         {
+            if (_pendingValues != null)
+            {
+                _pendingValues.AddByteArray(propertyIndex, value);
+                return;
+            }
+
             NativeException nativeException;
             if (value == null)
             {
@@ -549,6 +799,56 @@ private unsafe byte[] GetByteArrayBuffer(IntPtr propertyIndex, int size)
             return bytes;
         }
 
+        /// <summary>
+        /// Gets the size of a binary property without copying it. Returns -1 if the value is null.
+        /// </summary>
+        public long GetByteArraySize(IntPtr propertyIndex)
+        {
+            bool isNull;
+            NativeException nativeException;
+            var size = NativeMethods.get_binary_size(this, propertyIndex, out isNull, out nativeException);
+            nativeException.ThrowIfNecessary();
+
+            return isNull ? -1 : (long)size;
+        }
+
+        /// <summary>
+        /// Copies up to <paramref name="count"/> bytes of a binary property, starting at <paramref name="offset"/>, into the buffer.
+        /// Returns the number of bytes copied, which is 0 at the end of the value, or -1 if the value is null.
+        /// </summary>
+        public unsafe int ReadByteArrayChunk(IntPtr propertyIndex, long offset, byte[] buffer, int bufferOffset, int count)
+        {
+            if (bufferOffset < 0 || count < 0 || buffer.Length - bufferOffset < count)
+            {
+                throw new ArgumentOutOfRangeException(nameof(count));
+            }
+
+            bool isNull;
+            NativeException nativeException;
+
+            int read;
+            fixed (byte* bufferPtr = buffer)
+            {
+                read = (int)NativeMethods.get_binary_chunk(this, propertyIndex, (IntPtr)offset, (IntPtr)(bufferPtr + bufferOffset), (IntPtr)count, out isNull, out nativeException);
+            }
+
+            nativeException.ThrowIfNecessary();
+
+            return isNull ? -1 : read;
+        }
+
+        /// <summary>
+        /// Opens a writer that sets a binary property from chunks. Must be called inside a write transaction,
+        /// and the value is only set once the writer is committed.
+        /// </summary>
+        public BinaryWriterHandle OpenByteArrayWriter(IntPtr propertyIndex, long expectedSize = 0)
+        {
+            NativeException nativeException;
+            var result = NativeMethods.open_binary_writer(this, propertyIndex, (IntPtr)expectedSize, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return result;
+        }
+
         public void RemoveFromRealm(SharedRealmHandle realmHandle)
         {
             NativeException nativeException;
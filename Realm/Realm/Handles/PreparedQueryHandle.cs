@@ -0,0 +1,103 @@
+﻿////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Runtime.InteropServices;
+using Realms.Native;
+
+namespace Realms
+{
+    // A native PreparedQuery: a predicate program captured once, run with new literal values on every call.
+    internal class PreparedQueryHandle : RealmHandle
+    {
+        private static class NativeMethods
+        {
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "prepared_query_destroy", CallingConvention = CallingConvention.Cdecl)]
+            public static extern void destroy(IntPtr handle);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "prepared_query_count", CallingConvention = CallingConvention.Cdecl)]
+            public static extern unsafe IntPtr count(PreparedQueryHandle handle, SharedRealmHandle sharedRealm, PrimitiveValue* literals, IntPtr literalCount,
+                char* stringPool, IntPtr stringPoolSize, byte* binaryPool, IntPtr binaryPoolSize, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "prepared_query_find", CallingConvention = CallingConvention.Cdecl)]
+            public static extern unsafe IntPtr find(PreparedQueryHandle handle, SharedRealmHandle sharedRealm, PrimitiveValue* literals, IntPtr literalCount,
+                char* stringPool, IntPtr stringPoolSize, byte* binaryPool, IntPtr binaryPoolSize, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "prepared_query_create_results", CallingConvention = CallingConvention.Cdecl)]
+            public static extern unsafe IntPtr create_results(PreparedQueryHandle handle, SharedRealmHandle sharedRealm, PrimitiveValue* literals, IntPtr literalCount,
+                char* stringPool, IntPtr stringPoolSize, byte* binaryPool, IntPtr binaryPoolSize, out NativeException ex);
+        }
+
+        public PreparedQueryHandle(RealmHandle root) : base(root)
+        {
+        }
+
+        public unsafe int Count(SharedRealmHandle sharedRealm, PrimitiveValue[] literals, char[] stringPool, int stringPoolSize, byte[] binaryPool, int binaryPoolSize)
+        {
+            NativeException nativeException;
+            IntPtr result;
+            fixed (PrimitiveValue* literalsPtr = literals)
+            fixed (char* stringPoolPtr = stringPool)
+            fixed (byte* binaryPoolPtr = binaryPool)
+            {
+                result = NativeMethods.count(this, sharedRealm, literalsPtr, (IntPtr)literals.Length, stringPoolPtr, (IntPtr)stringPoolSize,
+                                             binaryPoolPtr, (IntPtr)binaryPoolSize, out nativeException);
+            }
+
+            nativeException.ThrowIfNecessary();
+            return (int)result;
+        }
+
+        public unsafe IntPtr Find(SharedRealmHandle sharedRealm, PrimitiveValue[] literals, char[] stringPool, int stringPoolSize, byte[] binaryPool, int binaryPoolSize)
+        {
+            NativeException nativeException;
+            IntPtr result;
+            fixed (PrimitiveValue* literalsPtr = literals)
+            fixed (char* stringPoolPtr = stringPool)
+            fixed (byte* binaryPoolPtr = binaryPool)
+            {
+                result = NativeMethods.find(this, sharedRealm, literalsPtr, (IntPtr)literals.Length, stringPoolPtr, (IntPtr)stringPoolSize,
+                                            binaryPoolPtr, (IntPtr)binaryPoolSize, out nativeException);
+            }
+
+            nativeException.ThrowIfNecessary();
+            return result;
+        }
+
+        public unsafe IntPtr CreateResults(SharedRealmHandle sharedRealm, PrimitiveValue[] literals, char[] stringPool, int stringPoolSize, byte[] binaryPool, int binaryPoolSize)
+        {
+            NativeException nativeException;
+            IntPtr result;
+            fixed (PrimitiveValue* literalsPtr = literals)
+            fixed (char* stringPoolPtr = stringPool)
+            fixed (byte* binaryPoolPtr = binaryPool)
+            {
+                result = NativeMethods.create_results(this, sharedRealm, literalsPtr, (IntPtr)literals.Length, stringPoolPtr, (IntPtr)stringPoolSize,
+                                                      binaryPoolPtr, (IntPtr)binaryPoolSize, out nativeException);
+            }
+
+            nativeException.ThrowIfNecessary();
+            return result;
+        }
+
+        protected override void Unbind()
+        {
+            NativeMethods.destroy(handle);
+        }
+    }
+}
@@ -17,7 +17,9 @@
 ////////////////////////////////////////////////////////////////////////////
 
 using System;
+using System.Collections.Generic;
 using System.Diagnostics.CodeAnalysis;
+using System.Linq;
 using System.Runtime.InteropServices;
 using Realms.Native;
 
@@ -32,9 +34,6 @@ namespace Realms
     [SuppressMessage("StyleCop.CSharp.DocumentationRules", "SA1611:ElementParametersMustBeDocumented")]
     internal class QueryHandle : RealmHandle
     {
-        // This is a delegate type meant to represent one of the "query operator" methods such as float_less and bool_equal
-        internal delegate void Operation<T>(QueryHandle queryPtr, IntPtr columnIndex, T value);
-
         [SuppressMessage("StyleCop.CSharp.ReadabilityRules", "SA1121:UseBuiltInTypeAlias")]
         private static class NativeMethods
         {
@@ -232,14 +231,83 @@ private static class NativeMethods
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_count", CallingConvention = CallingConvention.Cdecl)]
             public static extern IntPtr count(QueryHandle QueryHandle, out NativeException ex);
 
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_aggregate", CallingConvention = CallingConvention.Cdecl)]
+            public static extern void aggregate(QueryHandle queryHandle, IntPtr columnIndex, AggregateType type, out PrimitiveValue result, out NativeException ex);
+
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_create_results", CallingConvention = CallingConvention.Cdecl)]
             public static extern IntPtr create_results(QueryHandle queryPtr, SharedRealmHandle sharedRealm, out NativeException ex);
 
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_create_windowed_results", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr create_windowed_results(QueryHandle queryPtr, SharedRealmHandle sharedRealm, IntPtr offset, IntPtr limit, out NativeException ex);
+
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_create_sorted_results", CallingConvention = CallingConvention.Cdecl)]
             public static extern IntPtr create_sorted_results(QueryHandle queryPtr, SharedRealmHandle sharedRealm, TableHandle tablePtr,
                 [MarshalAs(UnmanagedType.LPArray), In]SortDescriptorBuilder.Clause.Marshalable[] sortClauses, IntPtr clauseCount,
                 [MarshalAs(UnmanagedType.LPArray), In]IntPtr[] flattenedPropertyIndices,
                 out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_create_top_k_results", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr create_top_k_results(QueryHandle queryPtr, SharedRealmHandle sharedRealm, TableHandle tablePtr,
+                [MarshalAs(UnmanagedType.LPArray), In]SortDescriptorBuilder.Clause.Marshalable[] sortClauses, IntPtr clauseCount,
+                [MarshalAs(UnmanagedType.LPArray), In]IntPtr[] flattenedPropertyIndices, IntPtr k,
+                out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_int_in", CallingConvention = CallingConvention.Cdecl)]
+            public static extern void int_in(QueryHandle queryHandle, IntPtr columnIndex,
+                [MarshalAs(UnmanagedType.LPArray), In]long[] values, IntPtr count,
+                [MarshalAs(UnmanagedType.I1)] bool matchNull, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_string_in", CallingConvention = CallingConvention.Cdecl)]
+            public static extern unsafe void string_in(QueryHandle queryHandle, IntPtr columnIndex, char* stringPool,
+                [MarshalAs(UnmanagedType.LPArray), In]IntPtr[] valueLengths, IntPtr count,
+                [MarshalAs(UnmanagedType.I1)] bool matchNull, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_apply_predicate_program", CallingConvention = CallingConvention.Cdecl)]
+            public static extern unsafe void apply_predicate_program(QueryHandle queryHandle,
+                [MarshalAs(UnmanagedType.LPArray), In]PredicateProgram.Instruction[] instructions, IntPtr instructionCount,
+                [MarshalAs(UnmanagedType.LPArray), In]PrimitiveValue[] literals, IntPtr literalCount,
+                char* stringPool, IntPtr stringPoolSize,
+                [MarshalAs(UnmanagedType.LPArray), In]byte[] binaryPool, IntPtr binaryPoolSize,
+                [MarshalAs(UnmanagedType.LPArray), In]IntPtr[] linkColumns, IntPtr linkColumnCount,
+                out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "prepared_query_create", CallingConvention = CallingConvention.Cdecl)]
+            public static extern unsafe IntPtr prepare(QueryHandle queryHandle,
+                [MarshalAs(UnmanagedType.LPArray), In]PredicateProgram.Instruction[] instructions, IntPtr instructionCount,
+                [MarshalAs(UnmanagedType.LPArray), In]PrimitiveValue[] literals, IntPtr literalCount,
+                char* stringPool, IntPtr stringPoolSize,
+                [MarshalAs(UnmanagedType.LPArray), In]byte[] binaryPool, IntPtr binaryPoolSize,
+                [MarshalAs(UnmanagedType.LPArray), In]IntPtr[] linkColumns, IntPtr linkColumnCount,
+                out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_from_string", CallingConvention = CallingConvention.Cdecl)]
+            public static extern unsafe void from_string(QueryHandle queryHandle, SharedRealmHandle sharedRealm,
+                [MarshalAs(UnmanagedType.LPWStr)] string predicate, IntPtr predicateLength,
+                PropertyValue* arguments, IntPtr argumentCount, char* stringPool, IntPtr stringPoolSize,
+                byte* binaryPool, IntPtr binaryPoolSize, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_create_distinct_results", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr create_distinct_results(QueryHandle queryPtr, SharedRealmHandle sharedRealm, TableHandle tablePtr,
+                [MarshalAs(UnmanagedType.LPArray), In]SortDescriptorBuilder.Clause.Marshalable[] sortClauses, IntPtr sortClauseCount,
+                [MarshalAs(UnmanagedType.LPArray), In]IntPtr[] flattenedSortPropertyIndices,
+                [MarshalAs(UnmanagedType.LPArray), In]SortDescriptorBuilder.Clause.Marshalable[] distinctClauses, IntPtr distinctClauseCount,
+                [MarshalAs(UnmanagedType.LPArray), In]IntPtr[] flattenedDistinctPropertyIndices,
+                out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_get_distinct_values", CallingConvention = CallingConvention.Cdecl)]
+            public static extern unsafe IntPtr get_distinct_values(QueryHandle queryHandle, IntPtr columnIndex, PrimitiveValue* values, IntPtr valuesCapacity,
+                char* stringBuffer, IntPtr stringBufferSize, out IntPtr stringUnits, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_get_keyset_cursor_size", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr get_keyset_cursor_size(IntPtr clauseCount);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "query_create_keyset_page", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr create_keyset_page(QueryHandle queryPtr, SharedRealmHandle sharedRealm, TableHandle tablePtr,
+                [MarshalAs(UnmanagedType.LPArray), In]SortDescriptorBuilder.Clause.Marshalable[] sortClauses, IntPtr clauseCount,
+                [MarshalAs(UnmanagedType.LPArray), In]IntPtr[] flattenedPropertyIndices,
+                [MarshalAs(UnmanagedType.LPArray), In]byte[] cursor, IntPtr cursorSize, IntPtr pageSize,
+                [MarshalAs(UnmanagedType.LPArray), Out]byte[] nextCursor, out IntPtr nextCursorSize,
+                out NativeException ex);
         }
 
         public QueryHandle(RealmHandle root) : base(root)
@@ -574,6 +642,42 @@ public void NullNotEqual(IntPtr columnIndex)
             nativeException.ThrowIfNecessary();
         }
 
+        /// <summary>
+        /// Matches the objects whose property is one of <paramref name="values"/>, or null when
+        /// <paramref name="matchNull"/> is set.
+        /// </summary>
+        public void IntIn(IntPtr columnIndex, long[] values, bool matchNull)
+        {
+            NativeException nativeException;
+            NativeMethods.int_in(this, columnIndex, values, (IntPtr)values.Length, matchNull, out nativeException);
+            nativeException.ThrowIfNecessary();
+        }
+
+        /// <summary>
+        /// Matches the objects whose property is one of <paramref name="values"/>, which must not contain null, or null
+        /// when <paramref name="matchNull"/> is set.
+        /// </summary>
+        public unsafe void StringIn(IntPtr columnIndex, IList<string> values, bool matchNull)
+        {
+            var lengths = new IntPtr[values.Count];
+            var pool = new char[values.Sum(v => v.Length)];
+            var offset = 0;
+            for (var i = 0; i < values.Count; i++)
+            {
+                values[i].CopyTo(0, pool, offset, values[i].Length);
+                offset += values[i].Length;
+                lengths[i] = (IntPtr)values[i].Length;
+            }
+
+            NativeException nativeException;
+            fixed (char* poolPtr = pool)
+            {
+                NativeMethods.string_in(this, columnIndex, poolPtr, lengths, (IntPtr)lengths.Length, matchNull, out nativeException);
+            }
+
+            nativeException.ThrowIfNecessary();
+        }
+
         public IntPtr FindNext(ObjectHandle afterObject)
         {
             NativeException nativeException;
@@ -590,6 +694,56 @@ public IntPtr FindDirect(SharedRealmHandle sharedRealm, IntPtr? beginAtIndex = n
             return result;
         }
 
+        public unsafe void ApplyPredicateProgram(PredicateProgram.Instruction[] instructions, int instructionCount, PrimitiveValue[] literals, int literalCount,
+                                                 char[] stringPool, int stringPoolSize, byte[] binaryPool, int binaryPoolSize, IntPtr[] linkColumns, int linkColumnCount)
+        {
+            NativeException nativeException;
+            fixed (char* stringPoolPtr = stringPool)
+            {
+                NativeMethods.apply_predicate_program(this, instructions, (IntPtr)instructionCount, literals, (IntPtr)literalCount,
+                                                      stringPoolPtr, (IntPtr)stringPoolSize, binaryPool, (IntPtr)binaryPoolSize,
+                                                      linkColumns, (IntPtr)linkColumnCount, out nativeException);
+            }
+
+            nativeException.ThrowIfNecessary();
+        }
+
+        public unsafe PreparedQueryHandle Prepare(PredicateProgram.Instruction[] instructions, int instructionCount, PrimitiveValue[] literals, int literalCount,
+                                                  char[] stringPool, int stringPoolSize, byte[] binaryPool, int binaryPoolSize, IntPtr[] linkColumns, int linkColumnCount)
+        {
+            NativeException nativeException;
+            IntPtr result;
+            fixed (char* stringPoolPtr = stringPool)
+            {
+                result = NativeMethods.prepare(this, instructions, (IntPtr)instructionCount, literals, (IntPtr)literalCount,
+                                               stringPoolPtr, (IntPtr)stringPoolSize, binaryPool, (IntPtr)binaryPoolSize,
+                                               linkColumns, (IntPtr)linkColumnCount, out nativeException);
+            }
+
+            nativeException.ThrowIfNecessary();
+
+            var preparedQueryHandle = new PreparedQueryHandle(Root ?? this);
+            preparedQueryHandle.SetHandle(result);
+            return preparedQueryHandle;
+        }
+
+        // Appends a predicate in the object store's query language, with arguments holding the values for its $0, $1, ...
+        // placeholders in order.
+        public unsafe void AddStringPredicate(SharedRealmHandle sharedRealm, string predicate, PropertyValueBuffer arguments)
+        {
+            NativeException nativeException;
+            fixed (PropertyValue* argumentsPtr = arguments.Values)
+            fixed (char* stringsPtr = arguments.Strings)
+            fixed (byte* binariesPtr = arguments.Binaries)
+            {
+                NativeMethods.from_string(this, sharedRealm, predicate, (IntPtr)predicate.Length,
+                                          argumentsPtr, (IntPtr)arguments.Count, stringsPtr, (IntPtr)arguments.Strings.Length,
+                                          binariesPtr, (IntPtr)arguments.Binaries.Length, out nativeException);
+            }
+
+            nativeException.ThrowIfNecessary();
+        }
+
         public IntPtr GetColumnIndex(string columnName)
         {
             NativeException nativeException;
@@ -713,6 +867,16 @@ public int Count()
             return (int)result;
         }
 
+        // See aggregate_cs.hpp for which slot of the result holds the value.
+        public PrimitiveValue Aggregate(IntPtr columnIndex, AggregateType type)
+        {
+            NativeException nativeException;
+            PrimitiveValue result;
+            NativeMethods.aggregate(this, columnIndex, type, out result, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return result;
+        }
+
         public IntPtr CreateResults(SharedRealmHandle sharedRealm)
         {
             NativeException nativeException;
@@ -721,6 +885,16 @@ public IntPtr CreateResults(SharedRealmHandle sharedRealm)
             return result;
         }
 
+        // Results for the first offset + limit matches of this query, which stops evaluating once it has found them.
+        // The caller applies the window with ResultsHandle.SetWindow.
+        public IntPtr CreateWindowedResults(SharedRealmHandle sharedRealm, int offset, int? limit)
+        {
+            NativeException nativeException;
+            var result = NativeMethods.create_windowed_results(this, sharedRealm, (IntPtr)offset, limit.HasValue ? (IntPtr)limit.Value : new IntPtr(-1), out nativeException);
+            nativeException.ThrowIfNecessary();
+            return result;
+        }
+
         public IntPtr CreateSortedResults(SharedRealmHandle sharedRealm, SortDescriptorBuilder sortDescriptorBuilder)
         {
             NativeException nativeException;
@@ -729,5 +903,74 @@ public IntPtr CreateSortedResults(SharedRealmHandle sharedRealm, SortDescriptorB
             nativeException.ThrowIfNecessary();
             return result;
         }
+
+        // The results are sorted and start with the first k rows, but may hold more, so callers must window them.
+        public IntPtr CreateTopKResults(SharedRealmHandle sharedRealm, SortDescriptorBuilder sortDescriptorBuilder, int k)
+        {
+            NativeException nativeException;
+            var marshaledValues = sortDescriptorBuilder.Flatten();
+            var result = NativeMethods.create_top_k_results(this, sharedRealm, sortDescriptorBuilder.TableHandle, marshaledValues.Item2, (IntPtr)marshaledValues.Item2.Length, marshaledValues.Item1, (IntPtr)k, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return result;
+        }
+
+        // sortDescriptorBuilder may be null. Only the property chains of distinctDescriptorBuilder are used.
+        public IntPtr CreateDistinctResults(SharedRealmHandle sharedRealm, SortDescriptorBuilder sortDescriptorBuilder, SortDescriptorBuilder distinctDescriptorBuilder)
+        {
+            NativeException nativeException;
+            var sort = sortDescriptorBuilder?.Flatten() ?? Tuple.Create(new IntPtr[0], new SortDescriptorBuilder.Clause.Marshalable[0]);
+            var distinct = distinctDescriptorBuilder.Flatten();
+            var result = NativeMethods.create_distinct_results(this, sharedRealm, distinctDescriptorBuilder.TableHandle,
+                                                               sort.Item2, (IntPtr)sort.Item2.Length, sort.Item1,
+                                                               distinct.Item2, (IntPtr)distinct.Item2.Length, distinct.Item1, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return result;
+        }
+
+        /// <summary>
+        /// Reads the distinct values of a column over the matching rows into <paramref name="values"/>, growing it and
+        /// <paramref name="stringBuffer"/> as needed.
+        /// </summary>
+        /// <returns>The number of distinct values, which are at the start of <paramref name="values"/>.</returns>
+        public unsafe int GetDistinctValues(IntPtr columnIndex, ref PrimitiveValue[] values, ref char[] stringBuffer)
+        {
+            while (true)
+            {
+                NativeException nativeException;
+                int count;
+                IntPtr stringUnits;
+                fixed (PrimitiveValue* valuesPtr = values)
+                fixed (char* stringsPtr = stringBuffer)
+                {
+                    count = (int)NativeMethods.get_distinct_values(this, columnIndex, valuesPtr, (IntPtr)values.Length, stringsPtr, (IntPtr)stringBuffer.Length, out stringUnits, out nativeException);
+                }
+
+                nativeException.ThrowIfNecessary();
+
+                if (count <= values.Length && (int)stringUnits <= stringBuffer.Length)
+                {
+                    return count;
+                }
+
+                values = new PrimitiveValue[Math.Max(count, values.Length)];
+                stringBuffer = new char[Math.Max((int)stringUnits, stringBuffer.Length)];
+            }
+        }
+
+        // Like CreateTopKResults with k = pageSize, starting after the row cursor was returned for, or at the first row
+        // when cursor is null. nextCursor is null when the page is empty.
+        public IntPtr CreateKeysetPage(SharedRealmHandle sharedRealm, SortDescriptorBuilder sortDescriptorBuilder, byte[] cursor, int pageSize, out byte[] nextCursor)
+        {
+            NativeException nativeException;
+            var marshaledValues = sortDescriptorBuilder.Flatten();
+            var clauseCount = (IntPtr)marshaledValues.Item2.Length;
+            var buffer = new byte[(int)NativeMethods.get_keyset_cursor_size(clauseCount)];
+            IntPtr bufferSize;
+            var result = NativeMethods.create_keyset_page(this, sharedRealm, sortDescriptorBuilder.TableHandle, marshaledValues.Item2, clauseCount, marshaledValues.Item1,
+                                                          cursor, (IntPtr)(cursor?.Length ?? 0), (IntPtr)pageSize, buffer, out bufferSize, out nativeException);
+            nativeException.ThrowIfNecessary();
+            nextCursor = bufferSize == IntPtr.Zero ? null : buffer;
+            return result;
+        }
     }
 }
@@ -19,6 +19,7 @@
 using System;
 using System.Diagnostics.CodeAnalysis;
 using System.Runtime.InteropServices;
+using Realms.Native;
 
 namespace Realms
 {
@@ -35,15 +36,46 @@ private static class NativeMethods
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_row", CallingConvention = CallingConvention.Cdecl)]
             public static extern IntPtr get_row(ResultsHandle results, IntPtr index, out NativeException ex);
 
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_rows", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr get_rows(ResultsHandle results, IntPtr start, IntPtr count, [Out] long[] rowIndices, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_objects", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr get_objects(ResultsHandle results, IntPtr start, IntPtr count, [Out] IntPtr[] objects, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_column", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr get_column(ResultsHandle results, IntPtr propertyIndex, PropertyValue.ValueType type, IntPtr start, IntPtr count,
+                                                   [Out] byte[] values, [Out] byte[] nullBitmap, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_column", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr get_column(ResultsHandle results, IntPtr propertyIndex, PropertyValue.ValueType type, IntPtr start, IntPtr count,
+                                                   [Out] long[] values, [Out] byte[] nullBitmap, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_column", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr get_column(ResultsHandle results, IntPtr propertyIndex, PropertyValue.ValueType type, IntPtr start, IntPtr count,
+                                                   [Out] float[] values, [Out] byte[] nullBitmap, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_column", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr get_column(ResultsHandle results, IntPtr propertyIndex, PropertyValue.ValueType type, IntPtr start, IntPtr count,
+                                                   [Out] double[] values, [Out] byte[] nullBitmap, out NativeException ex);
+
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_count", CallingConvention = CallingConvention.Cdecl)]
             public static extern IntPtr count(ResultsHandle results, out NativeException ex);
 
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_aggregate", CallingConvention = CallingConvention.Cdecl)]
+            public static extern void aggregate(ResultsHandle results, IntPtr propertyIndex, AggregateType type, out PrimitiveValue result, out NativeException ex);
+
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_clear", CallingConvention = CallingConvention.Cdecl)]
             public static extern void clear(ResultsHandle results, SharedRealmHandle realmHandle, out NativeException ex);
 
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_add_notification_callback", CallingConvention = CallingConvention.Cdecl)]
             public static extern IntPtr add_notification_callback(ResultsHandle results, IntPtr managedResultsHandle, NotificationCallbackDelegate callback, out NativeException ex);
 
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_combine", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr combine(ResultsHandle lhs, ResultsHandle rhs, RowSetOperation operation, out NativeException ex);
+
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_combined_count", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr combined_count(ResultsHandle lhs, ResultsHandle rhs, RowSetOperation operation, out NativeException ex);
+
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "results_get_query", CallingConvention = CallingConvention.Cdecl)]
             public static extern IntPtr get_query(ResultsHandle results, out NativeException ex);
 
@@ -55,6 +87,12 @@ private static class NativeMethods
             public static extern ThreadSafeReferenceHandle get_thread_safe_reference(ResultsHandle results, out NativeException ex);
         }
 
+        private int _windowOffset;
+        private int? _windowLimit;
+        private bool _isSnapshot;
+
+        internal bool IsWindowed => _windowOffset > 0 || _windowLimit.HasValue;
+
         public override bool IsValid
         {
             get
@@ -78,33 +116,169 @@ protected override void Unbind()
             NativeMethods.destroy(handle);
         }
 
+        /// <summary>
+        /// Restricts the results to the rows in [<paramref name="offset"/>, <paramref name="offset"/> + <paramref name="limit"/>),
+        /// for LINQ Skip and Take. Core can't express a window of a table view by match ordinal, so the window is applied by
+        /// this handle and only the objects inside it are ever materialized. Unsorted results are created natively with just
+        /// enough matches to fill the window.
+        /// </summary>
+        public void SetWindow(int offset, int? limit)
+        {
+            _windowOffset = offset;
+            _windowLimit = limit;
+        }
+
+        /// <summary>
+        /// Marks results that are a snapshot of fixed rows, such as those returned by <see cref="Combine"/>. Their native
+        /// query matches the rows by table index, so it must not be rerun or handed over once the realm changes.
+        /// </summary>
+        public void MarkAsSnapshot()
+        {
+            _isSnapshot = true;
+        }
+
         public override IntPtr GetObjectAtIndex(int index)
         {
+            if (index >= _windowLimit)
+            {
+                return IntPtr.Zero;
+            }
+
             NativeException nativeException;
-            var result = NativeMethods.get_row(this, (IntPtr)index, out nativeException);
+            var result = NativeMethods.get_row(this, (IntPtr)(index + _windowOffset), out nativeException);
             nativeException.ThrowIfNecessary();
             return result;
         }
 
+        /// <summary>
+        /// Fills <paramref name="rowIndices"/> with the table row indices of the results starting at <paramref name="start"/>.
+        /// Rows deleted since the results were last refreshed are reported as -1.
+        /// </summary>
+        /// <returns>The number of indices written, which is less than the buffer length at the end of the results.</returns>
+        public int GetRowIndices(int start, long[] rowIndices)
+        {
+            NativeException nativeException;
+            var result = NativeMethods.get_rows(this, WindowStart(start), WindowLength(start, rowIndices.Length), rowIndices, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return (int)result;
+        }
+
+        /// <summary>
+        /// Fills <paramref name="objects"/> with native object pointers for the results starting at <paramref name="start"/>,
+        /// in a single call. Every non-zero pointer must be wrapped in an <see cref="ObjectHandle"/> so it gets released.
+        /// </summary>
+        /// <returns>The number of pointers written, which is less than the buffer length at the end of the results.</returns>
+        public int GetObjectsAtIndex(int start, IntPtr[] objects)
+        {
+            NativeException nativeException;
+            var result = NativeMethods.get_objects(this, WindowStart(start), WindowLength(start, objects.Length), objects, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return (int)result;
+        }
+
+        // The column readers below copy one property of the results starting at start into values, one element per row,
+        // and set bit i of nullBitmap for every null row. nullBitmap needs (values.Length + 7) / 8 bytes and may only be
+        // null for required properties. They return the number of rows copied.
+        public int GetBooleanColumn(IntPtr propertyIndex, int start, byte[] values, byte[] nullBitmap)
+        {
+            NativeException nativeException;
+            var result = NativeMethods.get_column(this, propertyIndex, PropertyValue.ValueType.Bool, WindowStart(start), WindowLength(start, values.Length), values, nullBitmap, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return (int)result;
+        }
+
+        public int GetInt64Column(IntPtr propertyIndex, int start, long[] values, byte[] nullBitmap)
+        {
+            NativeException nativeException;
+            var result = NativeMethods.get_column(this, propertyIndex, PropertyValue.ValueType.Int, WindowStart(start), WindowLength(start, values.Length), values, nullBitmap, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return (int)result;
+        }
+
+        public int GetSingleColumn(IntPtr propertyIndex, int start, float[] values, byte[] nullBitmap)
+        {
+            NativeException nativeException;
+            var result = NativeMethods.get_column(this, propertyIndex, PropertyValue.ValueType.Float, WindowStart(start), WindowLength(start, values.Length), values, nullBitmap, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return (int)result;
+        }
+
+        public int GetDoubleColumn(IntPtr propertyIndex, int start, double[] values, byte[] nullBitmap)
+        {
+            NativeException nativeException;
+            var result = NativeMethods.get_column(this, propertyIndex, PropertyValue.ValueType.Double, WindowStart(start), WindowLength(start, values.Length), values, nullBitmap, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return (int)result;
+        }
+
+        // Dates are returned as UTC ticks, ready for new DateTimeOffset(ticks, TimeSpan.Zero).
+        public int GetDateTimeOffsetTicksColumn(IntPtr propertyIndex, int start, long[] ticks, byte[] nullBitmap)
+        {
+            NativeException nativeException;
+            var result = NativeMethods.get_column(this, propertyIndex, PropertyValue.ValueType.Timestamp, WindowStart(start), WindowLength(start, ticks.Length), ticks, nullBitmap, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return (int)result;
+        }
+
         public override int Count()
         {
             NativeException nativeException;
             var result = NativeMethods.count(this, out nativeException);
             nativeException.ThrowIfNecessary();
-            return (int)result;
+
+            var count = Math.Max(0, (int)result - _windowOffset);
+            return _windowLimit.HasValue ? Math.Min(count, _windowLimit.Value) : count;
+        }
+
+        public PrimitiveValue Aggregate(IntPtr propertyIndex, AggregateType type)
+        {
+            VerifyNotWindowed("Aggregating");
+
+            NativeException nativeException;
+            PrimitiveValue result;
+            NativeMethods.aggregate(this, propertyIndex, type, out result, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return result;
         }
 
         public void Clear(SharedRealmHandle realmHandle)
         {
+            VerifyNotWindowed("Removing");
+
             NativeException nativeException;
             NativeMethods.clear(this, realmHandle, out nativeException);
             nativeException.ThrowIfNecessary();
         }
 
+        public IntPtr Combine(ResultsHandle other, RowSetOperation operation)
+        {
+            VerifyNotWindowed("Combining");
+            other.VerifyNotWindowed("Combining");
+
+            NativeException nativeException;
+            var result = NativeMethods.combine(this, other, operation, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return result;
+        }
+
+        public int CombinedCount(ResultsHandle other, RowSetOperation operation)
+        {
+            VerifyNotWindowed("Combining");
+            other.VerifyNotWindowed("Combining");
+
+            NativeException nativeException;
+            var result = NativeMethods.combined_count(this, other, operation, out nativeException);
+            nativeException.ThrowIfNecessary();
+            return (int)result;
+        }
+
         // acquire a QueryHandle from table_where And set root in an atomic fashion 
         [SuppressMessage("Microsoft.Security", "CA2122:DoNotIndirectlyExposeMethodsWithLinkDemands"), SuppressMessage("Microsoft.Security", "CA2122:DoNotIndirectlyExposeMethodsWithLinkDemands")]
         public QueryHandle CreateQuery()
         {
+            VerifyNotWindowed("Querying");
+            VerifyNotSnapshot("queried");
+
             NativeException nativeException;
             var result = NativeMethods.get_query(this, out nativeException);
             nativeException.ThrowIfNecessary();
@@ -116,6 +290,9 @@ public QueryHandle CreateQuery()
 
         public override IntPtr AddNotificationCallback(IntPtr managedObjectHandle, NotificationCallbackDelegate callback)
         {
+            VerifyNotWindowed("Subscribing for notifications on");
+            VerifyNotSnapshot("observed");
+
             NativeException nativeException;
             var result = NativeMethods.add_notification_callback(this, managedObjectHandle, callback, out nativeException);
             nativeException.ThrowIfNecessary();
@@ -144,11 +321,37 @@ public override bool Equals(object obj)
 
         public override ThreadSafeReferenceHandle GetThreadSafeReference()
         {
+            VerifyNotWindowed("Passing across threads");
+            VerifyNotSnapshot("passed across threads");
+
             NativeException nativeException;
             var result = NativeMethods.get_thread_safe_reference(this, out nativeException);
             nativeException.ThrowIfNecessary();
 
             return result;
         }
+
+        private IntPtr WindowStart(int start) => (IntPtr)(start + _windowOffset);
+
+        private IntPtr WindowLength(int start, int length)
+        {
+            return (IntPtr)(_windowLimit.HasValue ? Math.Max(0, Math.Min(length, _windowLimit.Value - start)) : length);
+        }
+
+        private void VerifyNotWindowed(string operation)
+        {
+            if (IsWindowed)
+            {
+                throw new NotSupportedException($"{operation} results restricted with Skip or Take is not supported.");
+            }
+        }
+
+        private void VerifyNotSnapshot(string operation)
+        {
+            if (_isSnapshot)
+            {
+                throw new NotSupportedException($"Combined results are a snapshot and can't be {operation}. Enumerate them or use their indexer and Count instead.");
+            }
+        }
     }
 }
@@ -68,6 +68,12 @@ private static class NativeMethods
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "shared_realm_get_table", CallingConvention = CallingConvention.Cdecl)]
             public static extern IntPtr get_table(SharedRealmHandle sharedRealm, [MarshalAs(UnmanagedType.LPWStr)]string tableName, IntPtr tableNameLength, out NativeException ex);
 
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "shared_realm_import_file", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr import_file(SharedRealmHandle sharedRealm,
+                [MarshalAs(UnmanagedType.LPWStr)] string objectType, IntPtr objectTypeLength,
+                [MarshalAs(UnmanagedType.LPWStr)] string path, IntPtr pathLength,
+                Native.ImportOptions options, out NativeException ex);
+
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "shared_realm_is_same_instance", CallingConvention = CallingConvention.Cdecl)]
             public static extern IntPtr is_same_instance(SharedRealmHandle lhs, SharedRealmHandle rhs, out NativeException ex);
 
@@ -175,6 +181,56 @@ public IntPtr GetTable(string tableName)
             return result;
         }
 
+        /// <summary>
+        /// Imports a CSV or newline delimited JSON file into the table for <paramref name="objectType"/>, committing every
+        /// <paramref name="rowsPerTransaction"/> rows. <paramref name="onProgress"/> receives the rows imported, the bytes
+        /// processed and the file size after every commit, and can return <c>false</c> to stop the import.
+        /// An exception thrown by <paramref name="onProgress"/> also stops the import and is rethrown wrapped in an
+        /// <see cref="AggregateException"/>.
+        /// </summary>
+        /// <returns>The number of rows imported.</returns>
+        public long ImportFile(string objectType, string path, Native.ImportOptions.Format format, bool hasHeader = true, char delimiter = ',',
+                               int rowsPerTransaction = 100000, int threadCount = 0, Func<ulong, ulong, ulong, bool> onProgress = null)
+        {
+            var options = new Native.ImportOptions
+            {
+                format = format,
+                has_header = hasHeader,
+                delimiter = (byte)delimiter,
+                rows_per_transaction = (IntPtr)rowsPerTransaction,
+                thread_count = (IntPtr)threadCount
+            };
+
+            var progress = onProgress == null ? null : new ImportProgress(onProgress);
+            var progressHandle = default(GCHandle);
+            if (progress != null)
+            {
+                progressHandle = GCHandle.Alloc(progress);
+                options.progress_callback = ImportProgressCallback;
+                options.managed_state = GCHandle.ToIntPtr(progressHandle);
+            }
+
+            try
+            {
+                NativeException nativeException;
+                var result = NativeMethods.import_file(this, objectType, (IntPtr)objectType.Length, path, (IntPtr)path.Length, options, out nativeException);
+                nativeException.ThrowIfNecessary();
+                if (progress?.Exception != null)
+                {
+                    throw new AggregateException("Exception occurred in an import progress callback. See inner exception for more details.", progress.Exception);
+                }
+
+                return (long)result;
+            }
+            finally
+            {
+                if (progressHandle.IsAllocated)
+                {
+                    progressHandle.Free();
+                }
+            }
+        }
+
         public bool IsSameInstance(SharedRealmHandle other)
         {
             NativeException nativeException;
@@ -229,6 +285,36 @@ public IntPtr ResolveReference(ThreadSafeReference reference)
             return result;
         }
 
+        [NativeCallback(typeof(Native.ImportProgressCallback))]
+        private static bool ImportProgressCallback(IntPtr managedState, ulong rowsImported, ulong bytesProcessed, ulong totalBytes)
+        {
+            var progress = (ImportProgress)GCHandle.FromIntPtr(managedState).Target;
+
+            // Exceptions must not unwind through the native import, so the import is stopped and the exception
+            // is rethrown by ImportFile once native code has returned.
+            try
+            {
+                return progress.Callback(rowsImported, bytesProcessed, totalBytes);
+            }
+            catch (Exception e)
+            {
+                progress.Exception = e;
+                return false;
+            }
+        }
+
+        private class ImportProgress
+        {
+            public readonly Func<ulong, ulong, ulong, bool> Callback;
+
+            public Exception Exception;
+
+            public ImportProgress(Func<ulong, ulong, ulong, bool> callback)
+            {
+                Callback = callback;
+            }
+        }
+
         public class SchemaMarshaler
         {
             public readonly Native.SchemaObject[] Objects;
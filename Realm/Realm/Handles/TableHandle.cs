@@ -17,7 +17,9 @@
 ////////////////////////////////////////////////////////////////////////////
 
 using System;
+using System.Collections.Generic;
 using System.Diagnostics.CodeAnalysis;
+using System.Linq;
 using System.Runtime.InteropServices;
 using Realms.Native;
 
@@ -32,6 +34,10 @@ private static class NativeMethods
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_add_empty_object", CallingConvention = CallingConvention.Cdecl)]
             public static extern IntPtr add_empty_object(TableHandle tableHandle, SharedRealmHandle sharedRealm, out NativeException ex);
 
+            [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_add_objects", CallingConvention = CallingConvention.Cdecl)]
+            public static extern IntPtr add_objects(TableHandle tableHandle, SharedRealmHandle sharedRealm, IntPtr rowCount,
+                [MarshalAs(UnmanagedType.LPArray), In] ColumnData[] columns, IntPtr columnCount, out NativeException ex);
+
             [DllImport(InteropConfig.DLL_NAME, EntryPoint = "table_count_all", CallingConvention = CallingConvention.Cdecl)]
             public static extern Int64 count_all(TableHandle handle, out NativeException ex);
 
@@ -88,6 +94,34 @@ public IntPtr AddEmptyObject(SharedRealmHandle sharedRealm)
             return result;
         }
 
+        // Inserts one object per row of the columns and returns the row index of the first one; the rest follow it.
+        public long AddObjects(SharedRealmHandle sharedRealm, params BulkColumn[] columns)
+        {
+            var rowCount = columns.Length > 0 ? columns[0].Count : 0;
+            if (columns.Any(c => c.Count != rowCount))
+            {
+                throw new ArgumentException("All columns must have the same number of rows.", nameof(columns));
+            }
+
+            var handles = new List<GCHandle>();
+            try
+            {
+                var columnData = columns.Select(c => c.Pin(handles)).ToArray();
+
+                NativeException nativeException;
+                var result = NativeMethods.add_objects(this, sharedRealm, (IntPtr)rowCount, columnData, (IntPtr)columnData.Length, out nativeException);
+                nativeException.ThrowIfNecessary();
+                return (long)result;
+            }
+            finally
+            {
+                foreach (var pinned in handles)
+                {
+                    pinned.Free();
+                }
+            }
+        }
+
         public long CountAll()
         {
             NativeException nativeException;
@@ -0,0 +1,283 @@
+﻿////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Linq.Expressions;
+using System.Reflection;
+using Realms.Native;
+
+namespace Realms
+{
+    // A query whose shape is captured once by RealmResults.Prepare and run many times with different values for its
+    // parameters. Binding a value only writes to managed buffers. Count, Find and Execute each make a single native
+    // call, which rebuilds the native query only if the bound values changed since the previous run.
+    internal class PreparedQuery<T> : IDisposable
+    {
+        private readonly Realm _realm;
+        private readonly RealmObject.Metadata _metadata;
+        private readonly PreparedQueryHandle _handle;
+        private readonly PrimitiveValue[] _literals;
+        private readonly byte[] _binaries;
+        private readonly Parameter[] _parameters;
+        private readonly int _constantStringsLength;
+        private char[] _strings;
+        private int _stringsLength;
+        private bool _stringsChanged;
+
+        internal PreparedQuery(Realm realm, RealmObject.Metadata metadata, PredicateProgram program,
+                               IList<ParameterExpression> parameters, List<int>[] parameterLiterals)
+        {
+            _realm = realm;
+            _metadata = metadata;
+            _handle = program.Prepare();
+
+            _literals = new PrimitiveValue[program.LiteralCount];
+            Array.Copy(program.Literals, _literals, _literals.Length);
+            _strings = new char[program.StringsLength];
+            Array.Copy(program.Strings, _strings, _strings.Length);
+            _constantStringsLength = _stringsLength = _strings.Length;
+            _binaries = new byte[program.BinariesLength];
+            Array.Copy(program.Binaries, _binaries, _binaries.Length);
+
+            _parameters = new Parameter[parameters.Count];
+            for (var i = 0; i < _parameters.Length; i++)
+            {
+                var type = parameters[i].Type;
+                var literals = parameterLiterals[i].ToArray();
+                var literalTypes = literals.Select(program.GetLiteralType).Distinct().ToArray();
+                if (literalTypes.Length > 1)
+                {
+                    throw new NotSupportedException($"Parameter {parameters[i].Name} is compared with properties of different types");
+                }
+
+                _parameters[i] = new Parameter
+                {
+                    Literals = literals,
+                    Type = literalTypes.SingleOrDefault(),
+                    IsNullable = !type.GetTypeInfo().IsValueType || Nullable.GetUnderlyingType(type) != null
+                };
+            }
+        }
+
+        public void Bind(int parameter, bool value)
+        {
+            foreach (var literal in GetLiterals(parameter, PropertyValue.ValueType.Bool))
+            {
+                _literals[literal].bool_value = value ? (byte)1 : (byte)0;
+            }
+        }
+
+        public void Bind(int parameter, long value)
+        {
+            switch (GetParameter(parameter).Type)
+            {
+                case PropertyValue.ValueType.Float:
+                    Bind(parameter, (float)value);
+                    break;
+                case PropertyValue.ValueType.Double:
+                    Bind(parameter, (double)value);
+                    break;
+                default:
+                    foreach (var literal in GetLiterals(parameter, PropertyValue.ValueType.Int))
+                    {
+                        _literals[literal].int_value = value;
+                    }
+
+                    break;
+            }
+        }
+
+        public void Bind(int parameter, float value)
+        {
+            if (GetParameter(parameter).Type == PropertyValue.ValueType.Double)
+            {
+                Bind(parameter, (double)value);
+                return;
+            }
+
+            foreach (var literal in GetLiterals(parameter, PropertyValue.ValueType.Float))
+            {
+                _literals[literal].float_value = value;
+            }
+        }
+
+        public void Bind(int parameter, double value)
+        {
+            foreach (var literal in GetLiterals(parameter, PropertyValue.ValueType.Double))
+            {
+                _literals[literal].double_value = value;
+            }
+        }
+
+        public void Bind(int parameter, DateTimeOffset value)
+        {
+            foreach (var literal in GetLiterals(parameter, PropertyValue.ValueType.Timestamp))
+            {
+                _literals[literal].ticks = value.ToUniversalTime().Ticks;
+            }
+        }
+
+        public void Bind(int parameter, string value)
+        {
+            if (value == null)
+            {
+                BindNull(parameter);
+                return;
+            }
+
+            // The literals get their offset into the string pool when the strings are written before the next run.
+            GetLiterals(parameter, PropertyValue.ValueType.String);
+            _parameters[parameter].StringValue = value;
+            _stringsChanged = true;
+        }
+
+        // Only parameters compared with == or != can be null.
+        public void BindNull(int parameter)
+        {
+            var target = GetParameter(parameter);
+            if (!target.IsNullable)
+            {
+                throw new ArgumentException($"Parameter {parameter} can't be null", nameof(parameter));
+            }
+
+            foreach (var literal in target.Literals)
+            {
+                _literals[literal].has_value = 0;
+            }
+
+            if (target.StringValue != null)
+            {
+                target.StringValue = null;
+                _stringsChanged = true;
+            }
+
+            target.IsBound = true;
+        }
+
+        public int Count()
+        {
+            PrepareToRun();
+            return _handle.Count(_realm.SharedRealmHandle, _literals, _strings, _stringsLength, _binaries, _binaries.Length);
+        }
+
+        // The first matching object, or null if there is none.
+        public T Find()
+        {
+            PrepareToRun();
+            var objectPtr = _handle.Find(_realm.SharedRealmHandle, _literals, _strings, _stringsLength, _binaries, _binaries.Length);
+            return objectPtr == IntPtr.Zero ? default(T) : (T)(object)_realm.MakeObject(_metadata, objectPtr);
+        }
+
+        // All the matching objects. They are unsorted, but the results can be sorted with OrderBy like any other.
+        public IQueryable<T> Execute()
+        {
+            PrepareToRun();
+            var resultsPtr = _handle.CreateResults(_realm.SharedRealmHandle, _literals, _strings, _stringsLength, _binaries, _binaries.Length);
+            return new RealmResults<T>(_realm, Realm.CreateResultsHandle(resultsPtr), _metadata);
+        }
+
+        public void Dispose()
+        {
+            _handle.Dispose();
+        }
+
+        private Parameter GetParameter(int parameter)
+        {
+            if (parameter < 0 || parameter >= _parameters.Length)
+            {
+                throw new ArgumentOutOfRangeException(nameof(parameter));
+            }
+
+            return _parameters[parameter];
+        }
+
+        // The literals of a parameter about to be bound to a value of the given type, marked as having a value.
+        private int[] GetLiterals(int parameter, PropertyValue.ValueType type)
+        {
+            var target = GetParameter(parameter);
+            if (target.Literals.Length > 0 && target.Type != type)
+            {
+                throw new ArgumentException($"Parameter {parameter} can't be bound to a {type} value", nameof(parameter));
+            }
+
+            foreach (var literal in target.Literals)
+            {
+                _literals[literal].has_value = 1;
+            }
+
+            target.IsBound = true;
+            return target.Literals;
+        }
+
+        private void PrepareToRun()
+        {
+            for (var i = 0; i < _parameters.Length; i++)
+            {
+                if (!_parameters[i].IsBound)
+                {
+                    throw new InvalidOperationException($"Parameter {i} has not been bound");
+                }
+            }
+
+            if (_stringsChanged)
+            {
+                WriteStrings();
+            }
+        }
+
+        // Bound strings are appended to the string literals of the query itself, rewriting them all whenever one changes.
+        private void WriteStrings()
+        {
+            _stringsLength = _constantStringsLength;
+            foreach (var parameter in _parameters.Where(p => p.StringValue != null))
+            {
+                var value = parameter.StringValue;
+                if (_strings.Length < _stringsLength + value.Length)
+                {
+                    Array.Resize(ref _strings, Math.Max(_stringsLength + value.Length, _strings.Length * 2));
+                }
+
+                value.CopyTo(0, _strings, _stringsLength, value.Length);
+                foreach (var literal in parameter.Literals)
+                {
+                    _literals[literal].string_offset = (uint)_stringsLength;
+                    _literals[literal].string_length = (uint)value.Length;
+                }
+
+                _stringsLength += value.Length;
+            }
+
+            _stringsChanged = false;
+        }
+
+        private class Parameter
+        {
+            public int[] Literals { get; set; }
+
+            public PropertyValue.ValueType Type { get; set; }
+
+            public bool IsNullable { get; set; }
+
+            public bool IsBound { get; set; }
+
+            public string StringValue { get; set; }
+        }
+    }
+}
@@ -17,8 +17,11 @@
 ////////////////////////////////////////////////////////////////////////////
 
 using System;
+using System.Collections.Generic;
 using System.Linq;
 using System.Linq.Expressions;
+using Realms.Native;
+using Realms.Schema;
 
 namespace Realms
 {
@@ -64,6 +67,170 @@ public QueryHandle CreateQuery()
             return ResultsHandle.CreateQuery();
         }
 
+        /// <summary>
+        /// Materializes a window of the results into <paramref name="buffer"/> with a single native call, which is much
+        /// cheaper than indexing the results one element at a time. Elements whose objects were deleted are set to null.
+        /// </summary>
+        /// <returns>The number of elements written, which is less than the buffer length at the end of the results.</returns>
+        internal int GetRange(int start, T[] buffer)
+        {
+            if (start < 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(start));
+            }
+
+            var pointers = new IntPtr[buffer.Length];
+            var count = ResultsHandle.GetObjectsAtIndex(start, pointers);
+            for (var i = 0; i < count; i++)
+            {
+                buffer[i] = pointers[i] == IntPtr.Zero ? default(T) : (T)(object)Realm.MakeObject(Metadata, pointers[i]);
+            }
+
+            return count;
+        }
+
+        // Keyset pagination over a sorted query: returns up to pageSize objects that sort strictly after the object the
+        // cursor was returned for, or the first page when cursor is null. The cursor is opaque and only valid for the
+        // same sort order. The page is a snapshot that isn't updated by later changes. nextCursor is null once there are no more objects.
+        internal RealmResults<T> GetPage(int pageSize, byte[] cursor, out byte[] nextCursor)
+        {
+            if (pageSize <= 0)
+            {
+                throw new ArgumentOutOfRangeException(nameof(pageSize));
+            }
+
+            SortDescriptorBuilder sort;
+            var queryHandle = BuildQuery("Keyset pagination", out sort);
+            if (sort == null)
+            {
+                throw new NotSupportedException("Keyset pagination requires the query to be sorted");
+            }
+
+            var resultsPtr = queryHandle.CreateKeysetPage(Realm.SharedRealmHandle, sort, cursor, pageSize, out nextCursor);
+            var handle = Realm.CreateResultsHandle(resultsPtr);
+            handle.SetWindow(0, pageSize);
+            return new RealmResults<T>(Realm, handle, Metadata);
+        }
+
+        // Keeps only the first object, in sort order, of each distinct combination of values of the property paths.
+        // Paths are property names, or chains of them through links such as "Owner.Name".
+        internal RealmResults<T> Distinct(params string[] propertyPaths)
+        {
+            if (propertyPaths.Length == 0)
+            {
+                throw new ArgumentException("At least one property is needed", nameof(propertyPaths));
+            }
+
+            SortDescriptorBuilder sort;
+            var queryHandle = BuildQuery(nameof(Distinct), out sort);
+
+            var distinct = new SortDescriptorBuilder(Metadata.Table);
+            foreach (var path in propertyPaths)
+            {
+                distinct.AddClause(GetPropertyIndexChain(path), true);
+            }
+
+            var resultsPtr = queryHandle.CreateDistinctResults(Realm.SharedRealmHandle, sort, distinct);
+            return new RealmResults<T>(Realm, Realm.CreateResultsHandle(resultsPtr), Metadata);
+        }
+
+        // The distinct values of a property over the objects, in ascending order with null first. Values are boxed as
+        // bool, long, float, double, DateTimeOffset or string depending on the property type.
+        internal object[] GetDistinctValues(string propertyName)
+        {
+            Property property;
+            if (!Metadata.Schema.TryFindProperty(propertyName, out property))
+            {
+                throw new ArgumentException($"Property {propertyName} not found on {Metadata.Schema.Name}", nameof(propertyName));
+            }
+
+            SortDescriptorBuilder sort;
+            var queryHandle = BuildQuery(nameof(GetDistinctValues), out sort);
+
+            var values = new PrimitiveValue[64];
+            var stringBuffer = new char[property.Type == PropertyType.String ? 1024 : 0];
+            var count = queryHandle.GetDistinctValues(Metadata.Table.GetColumnIndex(propertyName), ref values, ref stringBuffer);
+
+            var result = new object[count];
+            for (var i = 0; i < count; i++)
+            {
+                if (!values[i].HasValue)
+                {
+                    continue;
+                }
+
+                switch (property.Type)
+                {
+                    case PropertyType.Bool:
+                        result[i] = values[i].AsBool();
+                        break;
+                    case PropertyType.Int:
+                        result[i] = values[i].int_value;
+                        break;
+                    case PropertyType.Float:
+                        result[i] = values[i].float_value;
+                        break;
+                    case PropertyType.Double:
+                        result[i] = values[i].double_value;
+                        break;
+                    case PropertyType.Date:
+                        result[i] = values[i].AsDateTimeOffset();
+                        break;
+                    case PropertyType.String:
+                        result[i] = values[i].AsString(stringBuffer);
+                        break;
+                }
+            }
+
+            return result;
+        }
+
+        // Filters the objects with a predicate in the object store's query language, such as
+        // "Age > $0 AND Name BEGINSWITH $1", where $n stands for arguments[n]. Sorting is kept. Arguments can be null,
+        // bool, integers, float, double, DateTimeOffset, string, byte[] or managed objects for comparing links.
+        internal RealmResults<T> Filter(string predicate, params object[] arguments)
+        {
+            if (predicate == null)
+            {
+                throw new ArgumentNullException(nameof(predicate));
+            }
+
+            SortDescriptorBuilder sort;
+            var queryHandle = BuildQuery(nameof(Filter), out sort);
+
+            var buffer = new PropertyValueBuffer();
+            for (var i = 0; i < arguments.Length; i++)
+            {
+                AddArgument(buffer, (IntPtr)i, arguments[i]);
+            }
+
+            queryHandle.AddStringPredicate(Realm.SharedRealmHandle, predicate, buffer);
+            return new RealmResults<T>(Realm, Realm.MakeResultsForQuery(queryHandle, sort), Metadata);
+        }
+
+        // Captures a predicate such as (p, name) => p.Name == name on top of these results, so it can be run many times
+        // with different values bound to its parameters: parameter n of the prepared query is the lambda's parameter
+        // n + 1. Parameters can be compared with properties or passed to string methods such as StartsWith.
+        internal PreparedQuery<T> Prepare<TParam>(Expression<Func<T, TParam, bool>> predicate) => Prepare((LambdaExpression)predicate);
+
+        internal PreparedQuery<T> Prepare<TParam1, TParam2>(Expression<Func<T, TParam1, TParam2, bool>> predicate) => Prepare((LambdaExpression)predicate);
+
+        internal PreparedQuery<T> Prepare<TParam1, TParam2, TParam3>(Expression<Func<T, TParam1, TParam2, TParam3, bool>> predicate) => Prepare((LambdaExpression)predicate);
+
+        internal PreparedQuery<T> Prepare(LambdaExpression predicate)
+        {
+            SortDescriptorBuilder sort;
+            var queryHandle = BuildQuery(nameof(Prepare), out sort);
+            if (sort != null)
+            {
+                throw new NotSupportedException("Prepared queries can't be sorted. Sort the results of Execute instead.");
+            }
+
+            List<int>[] parameterLiterals;
+            var program = _provider.MakeVisitor().Prepare(queryHandle, predicate, out parameterLiterals);
+            return new PreparedQuery<T>(Realm, Metadata, program, predicate.Parameters.Skip(1).ToList(), parameterLiterals);
+        }
+
         internal override CollectionHandleBase CreateHandle()
         {
             if (_handle != null)
@@ -94,13 +261,98 @@ internal override CollectionHandleBase CreateHandle()
             AddLinkQueries(queryHandle);
 
             var sortHandle = qv.OptionalSortDescriptorBuilder;
-            return Realm.MakeResultsForQuery(queryHandle, sortHandle);
+            return Realm.MakeResultsForQuery(queryHandle, sortHandle, qv.WindowOffset, qv.WindowLimit);
+        }
+
+        private QueryHandle BuildQuery(string methodName, out SortDescriptorBuilder sort)
+        {
+            var qv = _provider.MakeVisitor();
+            qv.Visit(Expression);
+            if (qv.WindowOffset > 0 || qv.WindowLimit.HasValue)
+            {
+                throw new NotSupportedException($"{methodName} can't be combined with Skip or Take");
+            }
+
+            var queryHandle = qv.CoreQueryHandle;
+            AddLinkQueries(queryHandle);
+            sort = qv.OptionalSortDescriptorBuilder;
+            return queryHandle;
+        }
+
+        private static void AddArgument(PropertyValueBuffer buffer, IntPtr index, object argument)
+        {
+            if (argument == null)
+            {
+                buffer.AddNull(index);
+            }
+            else if (argument is bool)
+            {
+                buffer.AddBool(index, (bool)argument);
+            }
+            else if (argument is int || argument is long || argument is short || argument is byte || argument is char)
+            {
+                buffer.AddInt64(index, Convert.ToInt64(argument));
+            }
+            else if (argument is float)
+            {
+                buffer.AddSingle(index, (float)argument);
+            }
+            else if (argument is double)
+            {
+                buffer.AddDouble(index, (double)argument);
+            }
+            else if (argument is DateTimeOffset)
+            {
+                buffer.AddDateTimeOffset(index, (DateTimeOffset)argument);
+            }
+            else if (argument is string)
+            {
+                buffer.AddString(index, (string)argument);
+            }
+            else if (argument is byte[])
+            {
+                buffer.AddByteArray(index, (byte[])argument);
+            }
+            else if (argument is RealmObject)
+            {
+                var obj = (RealmObject)argument;
+                if (!obj.IsManaged)
+                {
+                    throw new ArgumentException("Objects compared in a predicate have to be managed by a Realm", nameof(argument));
+                }
+
+                buffer.AddLink(index, obj.ObjectHandle.RowIndex);
+            }
+            else
+            {
+                throw new NotSupportedException($"Arguments of type {argument.GetType()} can't be used in a predicate");
+            }
+        }
+
+        private List<IntPtr> GetPropertyIndexChain(string propertyPath)
+        {
+            var chain = new List<IntPtr>();
+            var metadata = Metadata;
+            foreach (var propertyName in propertyPath.Split('.'))
+            {
+                Property property;
+                if (metadata == null || !metadata.Schema.TryFindProperty(propertyName, out property))
+                {
+                    throw new ArgumentException($"Property path {propertyPath} not found on {Metadata.Schema.Name}", nameof(propertyPath));
+                }
+
+                chain.Add(metadata.PropertyIndices[propertyName]);
+                metadata = property.Type == PropertyType.Object ? Realm.Metadata[property.ObjectType] : null;
+            }
+
+            return chain;
         }
 
         private void AddLinkQueries(QueryHandle query)
         {
             if (_provider.LinkedQueries != null)
             {
+                var program = new PredicateProgram(query);
                 foreach (var linkedQueryInfo in _provider.LinkedQueries)
                 {
                     var propertyPath = linkedQueryInfo.PropertyPath.Split('.');
@@ -129,50 +381,21 @@ private void AddLinkQueries(QueryHandle query)
                     }
                     var lastPropertyId = propertyIndexes.Pop();
                     var propertyIndexesArray = propertyIndexes.Reverse().ToArray();
-                    if (linkedQueryInfo.Value == null)
+                    var value = linkedQueryInfo.Value;
+                    if (value == null && linkedQueryInfo.PredicateOperator != PredicateOperator.Equal && linkedQueryInfo.PredicateOperator != PredicateOperator.NotEqual)
                     {
-                        if (linkedQueryInfo.PredicateOperator == PredicateOperator.Equal)
-                        {
-                            query.CreateLinkQueryNull(propertyIndexesArray, lastPropertyId);
-                        }
-                        else if (linkedQueryInfo.PredicateOperator == PredicateOperator.NotEqual)
-                        {
-                            query.CreateLinkQueryNotNull(propertyIndexesArray, lastPropertyId);
-                        }
-                        else
-                        {
-                            throw new InvalidOperationException($"Can't perform {linkedQueryInfo.PredicateOperator} operaion on null");
-                        }
+                        throw new InvalidOperationException($"Can't perform {linkedQueryInfo.PredicateOperator} operaion on null");
                     }
-                    else if (property.Type == Realms.Schema.PropertyType.String)
-                    {
-                        query.CreateLinkQueryString(propertyIndexesArray, lastPropertyId, linkedQueryInfo.PredicateOperator, (string)linkedQueryInfo.Value, false);
-                    }
-                    else if (property.Type == Realms.Schema.PropertyType.Int)
-                    {
-                        query.CreateLinkQueryInt(propertyIndexesArray, lastPropertyId, linkedQueryInfo.PredicateOperator, (int)linkedQueryInfo.Value);
-                    }
-                    else if (property.Type == Realms.Schema.PropertyType.Bool)
-                    {
-                        query.CreateLinkQueryBool(propertyIndexesArray, lastPropertyId, linkedQueryInfo.PredicateOperator, (bool)linkedQueryInfo.Value);
-                    }
-                    else if (property.Type == Realms.Schema.PropertyType.Float)
-                    {
-                        query.CreateLinkQueryFloat(propertyIndexesArray, lastPropertyId, linkedQueryInfo.PredicateOperator, (float)linkedQueryInfo.Value);
-                    }
-                    else if (property.Type == Realms.Schema.PropertyType.Double)
-                    {
-                        query.CreateLinkQueryDouble(propertyIndexesArray, lastPropertyId, linkedQueryInfo.PredicateOperator, (double)linkedQueryInfo.Value);
-                    }
-                    else if (property.Type == Realms.Schema.PropertyType.Date)
-                    {
-                        query.CreateLinkQueryDate(propertyIndexesArray, lastPropertyId, linkedQueryInfo.PredicateOperator, (DateTimeOffset)linkedQueryInfo.Value);
-                    }
-                    else
+
+                    if (value is int)
                     {
-                        throw new NotImplementedException($"Type {linkedQueryInfo.Value.GetType()} not supported");
+                        value = (long)(int)value;
                     }
+
+                    program.LinkCompare(propertyIndexesArray, lastPropertyId, linkedQueryInfo.PredicateOperator, value);
                 }
+
+                program.Flush();
             }
         }
 
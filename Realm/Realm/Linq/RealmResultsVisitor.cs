@@ -30,11 +30,36 @@ namespace Realms
 {
     internal class RealmResultsVisitor : ExpressionVisitor
     {
+        private static readonly Dictionary<string, AggregateType> AggregateMethods = new Dictionary<string, AggregateType>
+        {
+            [nameof(Queryable.Sum)] = AggregateType.Sum,
+            [nameof(Queryable.Min)] = AggregateType.Min,
+            [nameof(Queryable.Max)] = AggregateType.Max,
+            [nameof(Queryable.Average)] = AggregateType.Average
+        };
+
         private readonly Realm _realm;
         private readonly RealmObject.Metadata _metadata;
 
-        internal QueryHandle CoreQueryHandle;  // set when recurse down to VisitConstant
         internal SortDescriptorBuilder OptionalSortDescriptorBuilder;  // set only when get OrderBy*
+        internal int WindowOffset;  // set by Skip
+        internal int? WindowLimit;  // set by Take
+
+        private QueryHandle _coreQueryHandle;  // set when recurse down to VisitConstant
+        private PredicateProgram _predicate;  // conditions collected for _coreQueryHandle but not yet applied
+        private IList<ParameterExpression> _preparedParameters;  // set only when preparing a query, see Prepare
+        private List<int>[] _parameterLiterals;  // for each prepared parameter, the literals it is compared with
+
+        // Conditions are collected into a PredicateProgram and applied with a single native call, so anything that reads
+        // the query, whether to run it or to hand it on, gets it with every condition so far applied.
+        internal QueryHandle CoreQueryHandle
+        {
+            get
+            {
+                _predicate?.Flush();
+                return _coreQueryHandle;
+            }
+        }
 
         private static class Methods
         {
@@ -105,6 +130,7 @@ private void RecurseToWhereOrRunLambda(MethodCallExpression m)
             Visit(m.Arguments[0]); // creates the query or recurse to "Where"
             if (m.Arguments.Count > 1)
             {
+                ThrowIfWindowed(m.Method.Name);
                 var lambda = (LambdaExpression)StripQuotes(m.Arguments[1]);
                 Visit(lambda.Body);
             }
@@ -112,6 +138,8 @@ private void RecurseToWhereOrRunLambda(MethodCallExpression m)
 
         private void AddSort(LambdaExpression lambda, bool isStarting, bool ascending)
         {
+            ThrowIfWindowed(isStarting ? "OrderBy" : "ThenBy");
+
             var body = lambda.Body as MemberExpression;
             if (body == null)
             {
@@ -162,6 +190,7 @@ internal override Expression VisitMethodCall(MethodCallExpression m)
                 if (m.Method.Name == nameof(Queryable.Where))
                 {
                     Visit(m.Arguments[0]);
+                    ThrowIfWindowed(m.Method.Name);
                     var lambda = (LambdaExpression)StripQuotes(m.Arguments[1]);
                     Visit(lambda.Body);
                     return m;
@@ -195,17 +224,85 @@ internal override Expression VisitMethodCall(MethodCallExpression m)
                     return m;
                 }
 
+                if (m.Method.Name == nameof(Queryable.Skip) || m.Method.Name == nameof(Queryable.Take))
+                {
+                    Visit(m.Arguments[0]);
+                    object argument;
+                    if (!TryExtractConstantValue(m.Arguments[1], out argument) || argument.GetType() != typeof(int))
+                    {
+                        throw new NotSupportedException($"The method '{m.Method}' has to be invoked with a single integer constant argument or closure variable");
+                    }
+
+                    var count = Math.Max(0, (int)argument);
+                    if (m.Method.Name == nameof(Queryable.Skip))
+                    {
+                        WindowOffset += count;
+                        if (WindowLimit.HasValue)
+                        {
+                            WindowLimit = Math.Max(0, WindowLimit.Value - count);
+                        }
+                    }
+                    else
+                    {
+                        WindowLimit = WindowLimit.HasValue ? Math.Min(WindowLimit.Value, count) : count;
+                    }
+
+                    return m;
+                }
+
                 if (m.Method.Name == nameof(Queryable.Count))
                 {
                     RecurseToWhereOrRunLambda(m);
-                    var foundCount = CoreQueryHandle.Count();
+                    int foundCount;
+                    if (IsWindowed)
+                    {
+                        using (var rh = MakeResults())
+                        {
+                            foundCount = rh.Count();
+                        }
+                    }
+                    else
+                    {
+                        foundCount = CoreQueryHandle.Count();
+                    }
+
                     return Expression.Constant(foundCount);
                 }
 
+                if (m.Arguments.Count == 2 && AggregateMethods.ContainsKey(m.Method.Name))
+                {
+                    Visit(m.Arguments[0]);
+                    ThrowIfWindowed(m.Method.Name);
+                    var lambda = (LambdaExpression)StripQuotes(m.Arguments[1]);
+                    var member = lambda.Body as MemberExpression;
+                    if (member == null || member.Expression != lambda.Parameters[0] || !IsAggregatable(member.Type))
+                    {
+                        throw new NotSupportedException($"The method '{m.Method.Name}' has to be invoked with a direct access to a numeric or date property");
+                    }
+
+                    var aggregateType = AggregateMethods[m.Method.Name];
+                    var propertyName = member.Member.GetCustomAttribute<MapToAttribute>()?.Mapping ?? member.Member.Name;
+                    var columnIndex = _predicate.GetColumnIndex(propertyName);
+                    var result = CoreQueryHandle.Aggregate(columnIndex, aggregateType);
+                    return Expression.Constant(GetAggregateResult(result, aggregateType, member.Type, m.Type), m.Type);
+                }
+
                 if (m.Method.Name == nameof(Queryable.Any))
                 {
                     RecurseToWhereOrRunLambda(m);
-                    var foundAny = CoreQueryHandle.FindDirect(_realm.SharedRealmHandle) != IntPtr.Zero;
+                    bool foundAny;
+                    if (IsWindowed)
+                    {
+                        using (var rh = MakeResults())
+                        {
+                            foundAny = rh.Count() > 0;
+                        }
+                    }
+                    else
+                    {
+                        foundAny = CoreQueryHandle.FindDirect(_realm.SharedRealmHandle) != IntPtr.Zero;
+                    }
+
                     return Expression.Constant(foundAny);
                 }
 
@@ -213,13 +310,15 @@ internal override Expression VisitMethodCall(MethodCallExpression m)
                 {
                     RecurseToWhereOrRunLambda(m);
                     var firstObjectPtr = IntPtr.Zero;
-                    if (OptionalSortDescriptorBuilder == null)
+                    if (OptionalSortDescriptorBuilder == null && !IsWindowed)
                     {
                         firstObjectPtr = CoreQueryHandle.FindDirect(_realm.SharedRealmHandle);
                     }
                     else
                     {
-                        using (ResultsHandle rh = _realm.MakeResultsForQuery(CoreQueryHandle, OptionalSortDescriptorBuilder))
+                        // Only the first row is needed, so let a sort settle for the top row instead of ordering everything.
+                        var limit = WindowLimit.HasValue ? Math.Min(WindowLimit.Value, 1) : 1;
+                        using (ResultsHandle rh = _realm.MakeTransientResultsForQuery(CoreQueryHandle, OptionalSortDescriptorBuilder, WindowOffset, limit))
                         {
                             firstObjectPtr = rh.GetObjectAtIndex(0);
                         }
@@ -259,7 +358,24 @@ internal override Expression VisitMethodCall(MethodCallExpression m)
                 if (m.Method.Name.StartsWith(nameof(Queryable.Single)))  // same as unsorted First with extra checks
                 {
                     RecurseToWhereOrRunLambda(m);
-                    var firstObjectPtr = CoreQueryHandle.FindDirect(_realm.SharedRealmHandle);
+                    if (IsWindowed)
+                    {
+                        using (var rh = MakeResults())
+                        {
+                            var windowCount = rh.Count();
+                            if (windowCount > 1)
+                            {
+                                throw new InvalidOperationException("Sequence contains more than one matching element");
+                            }
+
+                            if (windowCount == 1)
+                            {
+                                return Expression.Constant(_realm.MakeObject(_metadata, rh.GetObjectAtIndex(0)));
+                            }
+                        }
+                    }
+
+                    var firstObjectPtr = IsWindowed ? IntPtr.Zero : CoreQueryHandle.FindDirect(_realm.SharedRealmHandle);
                     if (firstObjectPtr == IntPtr.Zero)
                     {
                         if (m.Method.Name == nameof(Queryable.Single))
@@ -286,7 +402,7 @@ internal override Expression VisitMethodCall(MethodCallExpression m)
                     RecurseToWhereOrRunLambda(m);
 
                     var lastObjectPtr = IntPtr.Zero;
-                    using (ResultsHandle rh = _realm.MakeResultsForQuery(CoreQueryHandle, OptionalSortDescriptorBuilder))
+                    using (ResultsHandle rh = MakeResults())
                     {
                         var lastIndex = rh.Count() - 1;
                         if (lastIndex >= 0)
@@ -320,13 +436,20 @@ internal override Expression VisitMethodCall(MethodCallExpression m)
 
                     IntPtr objectPtr;
                     var index = (int)argument;
-                    if (OptionalSortDescriptorBuilder == null)
+                    if (OptionalSortDescriptorBuilder == null && !IsWindowed)
                     {
                         objectPtr = CoreQueryHandle.FindDirect(_realm.SharedRealmHandle, (IntPtr)index);
                     }
                     else
                     {
-                        using (var rh = _realm.MakeResultsForQuery(CoreQueryHandle, OptionalSortDescriptorBuilder))
+                        // Only the rows up to index are needed, so let a sort settle for those instead of ordering everything.
+                        var limit = WindowLimit;
+                        if (index >= 0 && (!limit.HasValue || limit.Value > index))
+                        {
+                            limit = index + 1;
+                        }
+
+                        using (var rh = _realm.MakeTransientResultsForQuery(CoreQueryHandle, OptionalSortDescriptorBuilder, WindowOffset, limit))
                         {
                             objectPtr = rh.GetObjectAtIndex(index);
                         }
@@ -348,10 +471,26 @@ internal override Expression VisitMethodCall(MethodCallExpression m)
                 }
             }
 
+            // values.Contains(p.Property), through either Enumerable.Contains or a collection's own Contains
+            if (m.Method.Name == nameof(Enumerable.Contains) && m.Method.DeclaringType != typeof(string))
+            {
+                if (m.Method.DeclaringType == typeof(Enumerable) && m.Arguments.Count == 2)
+                {
+                    AddSetMembership(m, m.Arguments[0], m.Arguments[1]);
+                    return m;
+                }
+
+                if (m.Object != null && m.Arguments.Count == 1 && typeof(IEnumerable).GetTypeInfo().IsAssignableFrom(m.Object.Type.GetTypeInfo()))
+                {
+                    AddSetMembership(m, m.Object, m.Arguments[0]);
+                    return m;
+                }
+            }
+
             if (m.Method.DeclaringType == typeof(string) ||
                 m.Method.DeclaringType == typeof(StringExtensions))
             {
-                QueryHandle.Operation<string> queryMethod = null;
+                PredicateProgram.Operation<string> queryMethod = null;
 
                 // For extension methods, member should be m.Arguments[0] as MemberExpression;
                 MemberExpression member = null;
@@ -393,13 +532,13 @@ internal override Expression VisitMethodCall(MethodCallExpression m)
                         throw new NotSupportedException($"The method '{m.Method}' has to be invoked with a RealmObject member");
                     }
 
-                    var columnIndex = CoreQueryHandle.GetColumnIndex(member.Member.Name);
+                    var columnIndex = _predicate.GetColumnIndex(member.Member.Name);
 
-                    CoreQueryHandle.GroupBegin();
-                    CoreQueryHandle.NullEqual(columnIndex);
-                    CoreQueryHandle.Or();
-                    CoreQueryHandle.StringEqual(columnIndex, string.Empty, caseSensitive: true);
-                    CoreQueryHandle.GroupEnd();
+                    _predicate.GroupBegin();
+                    _predicate.NullEqual(columnIndex);
+                    _predicate.Or();
+                    _predicate.StringEqual(columnIndex, string.Empty, caseSensitive: true);
+                    _predicate.GroupEnd();
                     return m;
                 }
                 else if (AreMethodsSame(m.Method, Methods.String.EqualsMethod.Value))
@@ -432,16 +571,22 @@ internal override Expression VisitMethodCall(MethodCallExpression m)
                         throw new NotSupportedException($"The method '{m.Method}' has to be invoked on a RealmObject member");
                     }
 
-                    var columnIndex = CoreQueryHandle.GetColumnIndex(member.Member.Name);
+                    var columnIndex = _predicate.GetColumnIndex(member.Member.Name);
 
+                    var parameterIndex = GetPreparedParameterIndex(m.Arguments[stringArgumentIndex]);
                     object argument;
-                    if (!TryExtractConstantValue(m.Arguments[stringArgumentIndex], out argument) || 
+                    if (parameterIndex >= 0)
+                    {
+                        argument = string.Empty;
+                    }
+                    else if (!TryExtractConstantValue(m.Arguments[stringArgumentIndex], out argument) || 
                         (argument != null && argument.GetType() != typeof(string)))
                     {
                         throw new NotSupportedException($"The method '{m.Method}' has to be invoked with a single string constant argument or closure variable");
                     }
 
-                    queryMethod(CoreQueryHandle, columnIndex, (string)argument);
+                    queryMethod(_predicate, columnIndex, (string)argument);
+                    AddParameterLiteral(parameterIndex);
                     return m;
                 }
             }
@@ -449,6 +594,106 @@ internal override Expression VisitMethodCall(MethodCallExpression m)
             throw new NotSupportedException($"The method '{m.Method.Name}' is not supported");
         }
 
+        // Matches the objects whose property is one of the values of a constant collection with a single native condition,
+        // instead of an Or of equalities per value. Null values in the collection match null properties.
+        private void AddSetMembership(MethodCallExpression m, Expression collection, Expression item)
+        {
+            if (item.NodeType == ExpressionType.Convert)
+            {
+                item = ((UnaryExpression)item).Operand;
+            }
+
+            var member = item as MemberExpression;
+            var propertyName = member?.Member.GetCustomAttribute<MapToAttribute>()?.Mapping ?? member?.Member.Name;
+            if (propertyName == null || !(member.Member is PropertyInfo) || !_metadata.Schema.PropertyNames.Contains(propertyName))
+            {
+                throw new NotSupportedException($"The method '{m.Method.Name}' has to be invoked with a direct access to a persisted property in Realm.\nUnable to process '{item}'.");
+            }
+
+            object argument;
+            if (!TryExtractConstantValue(collection, out argument) || !(argument is IEnumerable))
+            {
+                throw new NotSupportedException($"The method '{m.Method.Name}' has to be invoked on a constant or closure variable collection.\nUnable to process '{collection}'.");
+            }
+
+            var columnIndex = _predicate.GetColumnIndex(propertyName);
+            var propertyType = Nullable.GetUnderlyingType(member.Type) ?? member.Type;
+            var values = ((IEnumerable)argument).Cast<object>();
+            var matchNull = values.Contains(null);
+            if (propertyType == typeof(string))
+            {
+                _predicate.StringIn(columnIndex, values.Where(v => v != null).Cast<string>().ToList(), matchNull);
+            }
+            else if (propertyType == typeof(char) || propertyType == typeof(byte) || propertyType == typeof(short) ||
+                     propertyType == typeof(int) || propertyType == typeof(long))
+            {
+                _predicate.IntIn(columnIndex, values.Where(v => v != null).Select(v => Convert.ToInt64(v)).ToArray(), matchNull);
+            }
+            else
+            {
+                throw new NotSupportedException($"The method '{m.Method.Name}' can only match integer and string properties");
+            }
+        }
+
+        private bool IsWindowed => WindowOffset > 0 || WindowLimit.HasValue;
+
+        // The results are only used while evaluating a single operator.
+        private ResultsHandle MakeResults()
+        {
+            return _realm.MakeTransientResultsForQuery(CoreQueryHandle, OptionalSortDescriptorBuilder, WindowOffset, WindowLimit);
+        }
+
+        private void ThrowIfWindowed(string methodName)
+        {
+            if (IsWindowed)
+            {
+                throw new NotSupportedException($"The method '{methodName}' can't be applied after Skip or Take");
+            }
+        }
+
+        private static bool IsAggregatable(Type propertyType)
+        {
+            var type = Nullable.GetUnderlyingType(propertyType) ?? propertyType;
+            return type == typeof(char) || type == typeof(byte) || type == typeof(short) || type == typeof(int) || type == typeof(long) ||
+                   type == typeof(float) || type == typeof(double) || type == typeof(DateTimeOffset);
+        }
+
+        // Converts the result of a native aggregate to the type the LINQ operator returns, following LINQ to Objects:
+        // Min, Max and Average of no values are null for nullable results and throw otherwise.
+        private static object GetAggregateResult(PrimitiveValue value, AggregateType aggregateType, Type propertyType, Type resultType)
+        {
+            if (!value.HasValue)
+            {
+                if (Nullable.GetUnderlyingType(resultType) != null)
+                {
+                    return null;
+                }
+
+                throw new InvalidOperationException("Sequence contains no elements");
+            }
+
+            var type = Nullable.GetUnderlyingType(propertyType) ?? propertyType;
+            object result;
+            if (aggregateType == AggregateType.Average || type == typeof(double) || (type == typeof(float) && aggregateType == AggregateType.Sum))
+            {
+                result = value.double_value;
+            }
+            else if (type == typeof(float))
+            {
+                result = value.float_value;
+            }
+            else if (type == typeof(DateTimeOffset))
+            {
+                return value.AsDateTimeOffset();
+            }
+            else
+            {
+                result = value.int_value;
+            }
+
+            return Convert.ChangeType(result, Nullable.GetUnderlyingType(resultType) ?? resultType);
+        }
+
         // Compares two methods for equality. .NET Native's == doesn't return expected results.
         private static bool AreMethodsSame(MethodInfo first, MethodInfo second)
         {
@@ -487,7 +732,7 @@ internal override Expression VisitUnary(UnaryExpression u)
             switch (u.NodeType)
             {
                 case ExpressionType.Not:
-                    CoreQueryHandle.Not();
+                    _predicate.Not();
                     Visit(u.Operand);  // recurse into richer expression, expect to VisitCombination
                     break;
                 default:
@@ -497,13 +742,13 @@ internal override Expression VisitUnary(UnaryExpression u)
             return u;
         }
 
-        protected void VisitCombination(BinaryExpression b, Action<QueryHandle> combineWith)
+        protected void VisitCombination(BinaryExpression b, Action<PredicateProgram> combineWith)
         {
-            CoreQueryHandle.GroupBegin();
+            _predicate.GroupBegin();
             Visit(b.Left);
-            combineWith(CoreQueryHandle);
+            combineWith(_predicate);
             Visit(b.Right);
-            CoreQueryHandle.GroupEnd();
+            _predicate.GroupEnd();
         }
 
         internal static bool TryExtractConstantValue(Expression expr, out object value)
@@ -587,8 +832,13 @@ internal override Expression VisitBinary(BinaryExpression b)
                     throw new NotSupportedException($"The left-hand side of the {b.NodeType} operator must be a direct access to a persisted property in Realm.\nUnable to process '{b.Left}'.");
                 }
 
+                var parameterIndex = GetPreparedParameterIndex(b.Right);
                 object rightValue;
-                if (!TryExtractConstantValue(b.Right, out rightValue))
+                if (parameterIndex >= 0)
+                {
+                    rightValue = GetParameterPlaceholder(b.Right.Type);
+                }
+                else if (!TryExtractConstantValue(b.Right, out rightValue))
                 {
                     throw new NotSupportedException($"The rhs of the binary operator '{b.NodeType}' should be a constant or closure variable expression. \nUnable to process `{b.Right}`");
                 }
@@ -596,98 +846,144 @@ internal override Expression VisitBinary(BinaryExpression b)
                 switch (b.NodeType)
                 {
                     case ExpressionType.Equal:
-                        AddQueryEqual(CoreQueryHandle, leftName, rightValue);
+                        AddQueryEqual(_predicate, leftName, rightValue);
                         break;
 
                     case ExpressionType.NotEqual:
-                        AddQueryNotEqual(CoreQueryHandle, leftName, rightValue);
+                        AddQueryNotEqual(_predicate, leftName, rightValue);
                         break;
 
                     case ExpressionType.LessThan:
-                        AddQueryLessThan(CoreQueryHandle, leftName, rightValue);
+                        AddQueryLessThan(_predicate, leftName, rightValue);
                         break;
 
                     case ExpressionType.LessThanOrEqual:
-                        AddQueryLessThanOrEqual(CoreQueryHandle, leftName, rightValue);
+                        AddQueryLessThanOrEqual(_predicate, leftName, rightValue);
                         break;
 
                     case ExpressionType.GreaterThan:
-                        AddQueryGreaterThan(CoreQueryHandle, leftName, rightValue);
+                        AddQueryGreaterThan(_predicate, leftName, rightValue);
                         break;
 
                     case ExpressionType.GreaterThanOrEqual:
-                        AddQueryGreaterThanOrEqual(CoreQueryHandle, leftName, rightValue);
+                        AddQueryGreaterThanOrEqual(_predicate, leftName, rightValue);
                         break;
 
                     default:
                         throw new NotSupportedException($"The binary operator '{b.NodeType}' is not supported");
                 }
+
+                AddParameterLiteral(parameterIndex);
             }
 
             return b;
         }
 
-        private static void AddQueryEqual(QueryHandle queryHandle, string columnName, object value)
+        // Records the body of predicate as a program for query, without applying it. The parameters of predicate after
+        // the object itself stand for values bound later, when the prepared query is run. They are compared as
+        // placeholder literals, whose indices are returned in parameterLiterals.
+        internal PredicateProgram Prepare(QueryHandle query, LambdaExpression predicate, out List<int>[] parameterLiterals)
         {
-            var columnIndex = queryHandle.GetColumnIndex(columnName);
+            _coreQueryHandle = query;
+            _predicate = new PredicateProgram(query) { IsPrepared = true };
+            _preparedParameters = predicate.Parameters.Skip(1).ToList();
+            _parameterLiterals = _preparedParameters.Select(p => new List<int>()).ToArray();
+
+            Visit(predicate.Body);
+
+            parameterLiterals = _parameterLiterals;
+            return _predicate;
+        }
+
+        private static object GetParameterPlaceholder(Type type)
+        {
+            type = Nullable.GetUnderlyingType(type) ?? type;
+            if (type == typeof(string))
+            {
+                return string.Empty;
+            }
+
+            if (type == typeof(bool) || type == typeof(char) || type == typeof(int) || type == typeof(long) ||
+                type == typeof(float) || type == typeof(double) || type == typeof(DateTimeOffset))
+            {
+                return Activator.CreateInstance(type);
+            }
+
+            throw new NotSupportedException($"Parameters of type {type} can't be used in a prepared query");
+        }
+
+        // The index of the prepared parameter expr refers to, possibly through conversions, or -1.
+        private int GetPreparedParameterIndex(Expression expr)
+        {
+            if (_preparedParameters == null)
+            {
+                return -1;
+            }
+
+            while (expr.NodeType == ExpressionType.Convert)
+            {
+                expr = ((UnaryExpression)expr).Operand;
+            }
+
+            var parameter = expr as ParameterExpression;
+            return parameter == null ? -1 : _preparedParameters.IndexOf(parameter);
+        }
+
+        private void AddParameterLiteral(int parameterIndex)
+        {
+            if (parameterIndex >= 0)
+            {
+                _parameterLiterals[parameterIndex].Add(_predicate.LastLiteral);
+            }
+        }
+
+        private static void AddQueryEqual(PredicateProgram program, string columnName, object value)
+        {
+            var columnIndex = program.GetColumnIndex(columnName);
 
             if (value == null)
             {
-                queryHandle.NullEqual(columnIndex);
+                program.NullEqual(columnIndex);
             }
             else if (value is string)
             {
-                queryHandle.StringEqual(columnIndex, (string)value, caseSensitive: true);
+                program.StringEqual(columnIndex, (string)value, caseSensitive: true);
             }
             else if (value is bool)
             {
-                queryHandle.BoolEqual(columnIndex, (bool)value);
+                program.BoolEqual(columnIndex, (bool)value);
             }
             else if (value is char)
             {
-                queryHandle.IntEqual(columnIndex, (int)value);
+                program.IntEqual(columnIndex, (int)value);
             }
             else if (value is int)
             {
-                queryHandle.IntEqual(columnIndex, (int)value);
+                program.IntEqual(columnIndex, (int)value);
             }
             else if (value is long)
             {
-                queryHandle.LongEqual(columnIndex, (long)value);
+                program.LongEqual(columnIndex, (long)value);
             }
             else if (value is float)
             {
-                queryHandle.FloatEqual(columnIndex, (float)value);
+                program.FloatEqual(columnIndex, (float)value);
             }
             else if (value is double)
             {
-                queryHandle.DoubleEqual(columnIndex, (double)value);
+                program.DoubleEqual(columnIndex, (double)value);
             }
             else if (value is DateTimeOffset)
             {
-                queryHandle.TimestampTicksEqual(columnIndex, (DateTimeOffset)value);
+                program.TimestampTicksEqual(columnIndex, (DateTimeOffset)value);
             }
             else if (value is byte[])
             {
-                var buffer = (byte[])value;
-                if (buffer.Length == 0)
-                {
-                    // see RealmObject.SetByteArrayValue
-                    queryHandle.BinaryEqual(columnIndex, (IntPtr)0x1, IntPtr.Zero);
-                    return;
-                }
-
-                unsafe
-                {
-                    fixed (byte* bufferPtr = (byte[])value)
-                    {
-                        queryHandle.BinaryEqual(columnIndex, (IntPtr)bufferPtr, (IntPtr)buffer.LongCount());
-                    }
-                }
+                program.BinaryEqual(columnIndex, (byte[])value);
             }
             else if (value is RealmObject)
             {
-                queryHandle.ObjectEqual(columnIndex, ((RealmObject)value).ObjectHandle);
+                program.ObjectEqual(columnIndex, ((RealmObject)value).ObjectHandle);
             }
             else
             {
@@ -695,68 +991,54 @@ private static void AddQueryEqual(QueryHandle queryHandle, string columnName, ob
             }
         }
 
-        private static void AddQueryNotEqual(QueryHandle queryHandle, string columnName, object value)
+        private static void AddQueryNotEqual(PredicateProgram program, string columnName, object value)
         {
-            var columnIndex = queryHandle.GetColumnIndex(columnName);
+            var columnIndex = program.GetColumnIndex(columnName);
 
             if (value == null)
             {
-                queryHandle.NullNotEqual(columnIndex);
+                program.NullNotEqual(columnIndex);
             }
             else if (value is string)
             {
-                queryHandle.StringNotEqual(columnIndex, (string)value, caseSensitive: true);
+                program.StringNotEqual(columnIndex, (string)value, caseSensitive: true);
             }
             else if (value is bool)
             {
-                queryHandle.BoolNotEqual(columnIndex, (bool)value);
+                program.BoolNotEqual(columnIndex, (bool)value);
             }
             else if (value is char)
             {
-                queryHandle.IntNotEqual(columnIndex, (int)value);
+                program.IntNotEqual(columnIndex, (int)value);
             }
             else if (value is int)
             {
-                queryHandle.IntNotEqual(columnIndex, (int)value);
+                program.IntNotEqual(columnIndex, (int)value);
             }
             else if (value is long)
             {
-                queryHandle.LongNotEqual(columnIndex, (long)value);
+                program.LongNotEqual(columnIndex, (long)value);
             }
             else if (value is float)
             {
-                queryHandle.FloatNotEqual(columnIndex, (float)value);
+                program.FloatNotEqual(columnIndex, (float)value);
             }
             else if (value is double)
             {
-                queryHandle.DoubleNotEqual(columnIndex, (double)value);
+                program.DoubleNotEqual(columnIndex, (double)value);
             }
             else if (value is DateTimeOffset)
             {
-                queryHandle.TimestampTicksNotEqual(columnIndex, (DateTimeOffset)value);
+                program.TimestampTicksNotEqual(columnIndex, (DateTimeOffset)value);
             }
             else if (value is byte[])
             {
-                var buffer = (byte[])value;
-                if (buffer.Length == 0)
-                {
-                    // see RealmObject.SetByteArrayValue
-                    queryHandle.BinaryNotEqual(columnIndex, (IntPtr)0x1, IntPtr.Zero);
-                    return;
-                }
-
-                unsafe
-                {
-                    fixed (byte* bufferPtr = (byte[])value)
-                    {
-                        queryHandle.BinaryNotEqual(columnIndex, (IntPtr)bufferPtr, (IntPtr)buffer.LongCount());
-                    }
-                }
+                program.BinaryNotEqual(columnIndex, (byte[])value);
             }
             else if (value is RealmObject)
             {
-                queryHandle.Not();
-                queryHandle.ObjectEqual(columnIndex, ((RealmObject)value).ObjectHandle);
+                program.Not();
+                program.ObjectEqual(columnIndex, ((RealmObject)value).ObjectHandle);
             }
             else
             {
@@ -764,33 +1046,33 @@ private static void AddQueryNotEqual(QueryHandle queryHandle, string columnName,
             }
         }
 
-        private static void AddQueryLessThan(QueryHandle queryHandle, string columnName, object value)
+        private static void AddQueryLessThan(PredicateProgram program, string columnName, object value)
         {
-            var columnIndex = queryHandle.GetColumnIndex(columnName);
+            var columnIndex = program.GetColumnIndex(columnName);
 
             if (value is char)
             {
-                queryHandle.IntLess(columnIndex, (int)value);
+                program.IntLess(columnIndex, (int)value);
             }
             else if (value is int)
             {
-                queryHandle.IntLess(columnIndex, (int)value);
+                program.IntLess(columnIndex, (int)value);
             }
             else if (value is long)
             {
-                queryHandle.LongLess(columnIndex, (long)value);
+                program.LongLess(columnIndex, (long)value);
             }
             else if (value is float)
             {
-                queryHandle.FloatLess(columnIndex, (float)value);
+                program.FloatLess(columnIndex, (float)value);
             }
             else if (value is double)
             {
-                queryHandle.DoubleLess(columnIndex, (double)value);
+                program.DoubleLess(columnIndex, (double)value);
             }
             else if (value is DateTimeOffset)
             {
-                queryHandle.TimestampTicksLess(columnIndex, (DateTimeOffset)value);
+                program.TimestampTicksLess(columnIndex, (DateTimeOffset)value);
             }
             else if (value is string || value is bool)
             {
@@ -802,33 +1084,33 @@ private static void AddQueryLessThan(QueryHandle queryHandle, string columnName,
             }
         }
 
-        private static void AddQueryLessThanOrEqual(QueryHandle queryHandle, string columnName, object value)
+        private static void AddQueryLessThanOrEqual(PredicateProgram program, string columnName, object value)
         {
-            var columnIndex = queryHandle.GetColumnIndex(columnName);
+            var columnIndex = program.GetColumnIndex(columnName);
 
             if (value is char)
             {
-                queryHandle.IntLessEqual(columnIndex, (int)value);
+                program.IntLessEqual(columnIndex, (int)value);
             }
             else if (value is int)
             {
-                queryHandle.IntLessEqual(columnIndex, (int)value);
+                program.IntLessEqual(columnIndex, (int)value);
             }
             else if (value is long)
             {
-                queryHandle.LongLessEqual(columnIndex, (long)value);
+                program.LongLessEqual(columnIndex, (long)value);
             }
             else if (value is float)
             {
-                queryHandle.FloatLessEqual(columnIndex, (float)value);
+                program.FloatLessEqual(columnIndex, (float)value);
             }
             else if (value is double)
             {
-                queryHandle.DoubleLessEqual(columnIndex, (double)value);
+                program.DoubleLessEqual(columnIndex, (double)value);
             }
             else if (value is DateTimeOffset)
             {
-                queryHandle.TimestampTicksLessEqual(columnIndex, (DateTimeOffset)value);
+                program.TimestampTicksLessEqual(columnIndex, (DateTimeOffset)value);
             }
             else if (value is string || value is bool)
             {
@@ -840,33 +1122,33 @@ private static void AddQueryLessThanOrEqual(QueryHandle queryHandle, string colu
             }
         }
 
-        private static void AddQueryGreaterThan(QueryHandle queryHandle, string columnName, object value)
+        private static void AddQueryGreaterThan(PredicateProgram program, string columnName, object value)
         {
-            var columnIndex = queryHandle.GetColumnIndex(columnName);
+            var columnIndex = program.GetColumnIndex(columnName);
 
             if (value is char)
             {
-                queryHandle.IntGreater(columnIndex, (int)value);
+                program.IntGreater(columnIndex, (int)value);
             }
             else if (value is int)
             {
-                queryHandle.IntGreater(columnIndex, (int)value);
+                program.IntGreater(columnIndex, (int)value);
             }
             else if (value is long)
             {
-                queryHandle.LongGreater(columnIndex, (long)value);
+                program.LongGreater(columnIndex, (long)value);
             }
             else if (value is float)
             {
-                queryHandle.FloatGreater(columnIndex, (float)value);
+                program.FloatGreater(columnIndex, (float)value);
             }
             else if (value is double)
             {
-                queryHandle.DoubleGreater(columnIndex, (double)value);
+                program.DoubleGreater(columnIndex, (double)value);
             }
             else if (value is DateTimeOffset)
             {
-                queryHandle.TimestampTicksGreater(columnIndex, (DateTimeOffset)value);
+                program.TimestampTicksGreater(columnIndex, (DateTimeOffset)value);
             }
             else if (value is string || value is bool)
             {
@@ -878,33 +1160,33 @@ private static void AddQueryGreaterThan(QueryHandle queryHandle, string columnNa
             }
         }
 
-        private static void AddQueryGreaterThanOrEqual(QueryHandle queryHandle, string columnName, object value)
+        private static void AddQueryGreaterThanOrEqual(PredicateProgram program, string columnName, object value)
         {
-            var columnIndex = queryHandle.GetColumnIndex(columnName);
+            var columnIndex = program.GetColumnIndex(columnName);
 
             if (value is char)
             {
-                queryHandle.IntGreaterEqual(columnIndex, (int)value);
+                program.IntGreaterEqual(columnIndex, (int)value);
             }
             else if (value is int)
             {
-                queryHandle.IntGreaterEqual(columnIndex, (int)value);
+                program.IntGreaterEqual(columnIndex, (int)value);
             }
             else if (value is long)
             {
-                queryHandle.LongGreaterEqual(columnIndex, (long)value);
+                program.LongGreaterEqual(columnIndex, (long)value);
             }
             else if (value is float)
             {
-                queryHandle.FloatGreaterEqual(columnIndex, (float)value);
+                program.FloatGreaterEqual(columnIndex, (float)value);
             }
             else if (value is double)
             {
-                queryHandle.DoubleGreaterEqual(columnIndex, (double)value);
+                program.DoubleGreaterEqual(columnIndex, (double)value);
             }
             else if (value is DateTimeOffset)
             {
-                queryHandle.TimestampTicksGreaterEqual(columnIndex, (DateTimeOffset)value);
+                program.TimestampTicksGreaterEqual(columnIndex, (DateTimeOffset)value);
             }
             else if (value is string || value is bool)
             {
@@ -948,12 +1230,13 @@ internal override Expression VisitConstant(ConstantExpression c)
             if (results != null)
             {
                 // assume constant nodes w/ IQueryables are table references
-                if (CoreQueryHandle != null)
+                if (_coreQueryHandle != null)
                 {
                     throw new Exception("We already have a table...");
                 }
 
-                CoreQueryHandle = results.CreateQuery();
+                _coreQueryHandle = results.CreateQuery();
+                _predicate = new PredicateProgram(_coreQueryHandle);
             }
             else if (c.Value?.GetType() == typeof(object))
             {
@@ -971,7 +1254,7 @@ internal override Expression VisitMemberAccess(MemberExpression m)
                 {
                     object rhs = true;  // box value
                     var leftName = m.Member.Name;
-                    AddQueryEqual(CoreQueryHandle, leftName, rhs);
+                    AddQueryEqual(_predicate, leftName, rhs);
                 }
 
                 return m;
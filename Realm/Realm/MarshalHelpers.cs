@@ -21,6 +21,7 @@
 using System.Diagnostics;
 using System.Reflection;
 using System.Runtime.InteropServices;
+using System.Text;
 using Realms.Exceptions;
 
 namespace Realms
@@ -100,6 +101,25 @@ public static IntPtr RealmColType(Type columnType)
             throw new NotImplementedException("Type " + columnType.FullName + " not supported");
         }
 
+        private static readonly Encoding StrictUtf8 = new UTF8Encoding(encoderShouldEmitUTF8Identifier: false, throwOnInvalidBytes: true);
+
+        public static unsafe string GetUtf8String(IntPtr data, int size)
+        {
+            if (size == 0)
+            {
+                return string.Empty;
+            }
+
+            try
+            {
+                return StrictUtf8.GetString((byte*)data, size);
+            }
+            catch (DecoderFallbackException)
+            {
+                throw new RealmInvalidDatabaseException("Corrupted string data");
+            }
+        }
+
         public delegate IntPtr NativeStringGetter(IntPtr buffer, IntPtr bufferLength, out bool isNull, out NativeException ex);
 
         public static string GetString(NativeStringGetter getter)
@@ -0,0 +1,140 @@
+﻿////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using System.Runtime.InteropServices;
+
+namespace Realms.Native
+{
+    // The values of one property for a batch of objects inserted with TableHandle.AddObjects.
+    // Nullable values are stored as a bitmap alongside the values, with one bit per row.
+    internal class BulkColumn
+    {
+        private readonly IntPtr _propertyIndex;
+        private readonly PropertyValue.ValueType _type;
+        private readonly Array _values;
+        private readonly uint[] _offsets;
+        private readonly byte[] _nullBitmap;
+
+        private BulkColumn(IntPtr propertyIndex, PropertyValue.ValueType type, Array values, int count, byte[] nullBitmap, uint[] offsets = null)
+        {
+            _propertyIndex = propertyIndex;
+            _type = type;
+            _values = values;
+            _offsets = offsets;
+            _nullBitmap = nullBitmap;
+            Count = count;
+        }
+
+        public int Count { get; }
+
+        public static BulkColumn ForBool(IntPtr propertyIndex, IList<bool?> values)
+        {
+            return new BulkColumn(propertyIndex, PropertyValue.ValueType.Bool, values.Select(v => v == true ? (byte)1 : (byte)0).ToArray(), values.Count, NullBitmap(values));
+        }
+
+        public static BulkColumn ForInt64(IntPtr propertyIndex, long[] values, byte[] nullBitmap = null)
+        {
+            return new BulkColumn(propertyIndex, PropertyValue.ValueType.Int, values, values.Length, nullBitmap);
+        }
+
+        public static BulkColumn ForInt64(IntPtr propertyIndex, IList<long?> values)
+        {
+            return new BulkColumn(propertyIndex, PropertyValue.ValueType.Int, values.Select(v => v.GetValueOrDefault()).ToArray(), values.Count, NullBitmap(values));
+        }
+
+        public static BulkColumn ForSingle(IntPtr propertyIndex, float[] values, byte[] nullBitmap = null)
+        {
+            return new BulkColumn(propertyIndex, PropertyValue.ValueType.Float, values, values.Length, nullBitmap);
+        }
+
+        public static BulkColumn ForDouble(IntPtr propertyIndex, double[] values, byte[] nullBitmap = null)
+        {
+            return new BulkColumn(propertyIndex, PropertyValue.ValueType.Double, values, values.Length, nullBitmap);
+        }
+
+        public static BulkColumn ForDateTimeOffset(IntPtr propertyIndex, IList<DateTimeOffset?> values)
+        {
+            var ticks = values.Select(v => v.HasValue ? v.Value.ToUniversalTime().Ticks : 0).ToArray();
+            return new BulkColumn(propertyIndex, PropertyValue.ValueType.Timestamp, ticks, values.Count, NullBitmap(values));
+        }
+
+        public static BulkColumn ForString(IntPtr propertyIndex, IList<string> values)
+        {
+            var offsets = new uint[values.Count + 1];
+            var length = 0;
+            for (var i = 0; i < values.Count; i++)
+            {
+                offsets[i] = (uint)length;
+                length += values[i]?.Length ?? 0;
+            }
+
+            offsets[values.Count] = (uint)length;
+
+            var pool = new char[length];
+            for (var i = 0; i < values.Count; i++)
+            {
+                values[i]?.CopyTo(0, pool, (int)offsets[i], values[i].Length);
+            }
+
+            return new BulkColumn(propertyIndex, PropertyValue.ValueType.String, pool, values.Count, NullBitmap(values), offsets);
+        }
+
+        // Pins the arrays backing this column until the handles are freed.
+        internal ColumnData Pin(IList<GCHandle> handles)
+        {
+            return new ColumnData
+            {
+                property_ndx = _propertyIndex,
+                type = _type,
+                values = Pin(_values, handles),
+                offsets = Pin(_offsets, handles),
+                null_bitmap = Pin(_nullBitmap, handles)
+            };
+        }
+
+        private static IntPtr Pin(Array array, IList<GCHandle> handles)
+        {
+            if (array == null)
+            {
+                return IntPtr.Zero;
+            }
+
+            var handle = GCHandle.Alloc(array, GCHandleType.Pinned);
+            handles.Add(handle);
+            return handle.AddrOfPinnedObject();
+        }
+
+        private static byte[] NullBitmap<T>(IList<T> values)
+        {
+            byte[] bitmap = null;
+            for (var i = 0; i < values.Count; i++)
+            {
+                if (values[i] == null)
+                {
+                    bitmap = bitmap ?? new byte[(values.Count + 7) / 8];
+                    bitmap[i / 8] |= (byte)(1 << (i % 8));
+                }
+            }
+
+            return bitmap;
+        }
+    }
+}
@@ -0,0 +1,55 @@
+﻿////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Diagnostics.CodeAnalysis;
+using System.Runtime.InteropServices;
+
+namespace Realms.Native
+{
+    [return: MarshalAs(UnmanagedType.I1)]
+    [UnmanagedFunctionPointer(CallingConvention.Cdecl)]
+    internal delegate bool ImportProgressCallback(IntPtr managedState, ulong rowsImported, ulong bytesProcessed, ulong totalBytes);
+
+    // Must stay in sync with ImportOptions in import_cs.hpp
+    [StructLayout(LayoutKind.Sequential)]
+    [SuppressMessage("StyleCop.CSharp.NamingRules", "SA1307:AccessibleFieldsMustBeginWithUpperCaseLetter")]
+    internal struct ImportOptions
+    {
+        internal enum Format : byte
+        {
+            Csv,
+            NdJson
+        }
+
+        internal Format format;
+
+        [MarshalAs(UnmanagedType.I1)]
+        internal bool has_header;
+
+        internal byte delimiter;
+
+        internal IntPtr rows_per_transaction;
+
+        internal IntPtr thread_count;
+
+        internal ImportProgressCallback progress_callback;
+
+        internal IntPtr managed_state;
+    }
+}
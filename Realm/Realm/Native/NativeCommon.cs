@@ -57,6 +57,19 @@ private static unsafe void DebugLogger(byte* utf8String, IntPtr stringLen)
         [DllImport(InteropConfig.DLL_NAME, EntryPoint = "realm_reset_for_testing", CallingConvention = CallingConvention.Cdecl)]
         public static extern void reset_for_testing();
 
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "scratch_arena_get_allocation_counters", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void get_scratch_allocation_counters(out ulong arenaAllocations, out ulong heapAllocations);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "scratch_arena_reset_allocation_counters", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void reset_scratch_allocation_counters();
+
+        // Fills statistics with the Object, Results, List and Query pools, in that order.
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "handle_pool_get_statistics", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void get_handle_pool_statistics([Out] HandlePoolStatistics[] statistics);
+
+        [DllImport(InteropConfig.DLL_NAME, EntryPoint = "handle_pool_reset_peaks", CallingConvention = CallingConvention.Cdecl)]
+        public static extern void reset_handle_pool_peaks();
+
         public static unsafe void Initialize()
         {
             var osVersionPI = typeof(Environment).GetProperty("OSVersion");
@@ -0,0 +1,476 @@
+﻿////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using System.Runtime.InteropServices;
+
+namespace Realms.Native
+{
+    // Collects the conditions of a query and applies them to its QueryHandle with a single native call when flushed,
+    // rather than one call per condition - must match predicate_program.hpp. The methods mirror the QueryHandle ones.
+    // Conditions that can't be encoded, such as links to a given object, flush the pending program and go to the
+    // handle directly, so conditions are always applied in order.
+    internal class PredicateProgram
+    {
+        // This is a delegate type meant to represent one of the "query operator" methods such as StringContains
+        internal delegate void Operation<T>(PredicateProgram program, IntPtr columnIndex, T value);
+
+        internal enum OpCode : byte
+        {
+            BeginGroup,
+            EndGroup,
+            Or,
+            Not,
+            Compare
+        }
+
+        internal enum Comparison : byte
+        {
+            Equal,
+            NotEqual,
+            Less,
+            LessEqual,
+            Greater,
+            GreaterEqual,
+            BeginsWith,
+            EndsWith,
+            Contains,
+            Like
+        }
+
+        [StructLayout(LayoutKind.Sequential)]
+        internal struct Instruction
+        {
+            public OpCode OpCode;
+            public Comparison Comparison;
+            public PropertyValue.ValueType Type;
+            public byte CaseSensitive;
+            public uint ColumnIndex;
+            public uint LiteralIndex;
+            public uint LinkOffset;
+            public uint LinkCount;
+        }
+
+        private readonly QueryHandle _handle;
+        private readonly Dictionary<string, IntPtr> _columnIndices = new Dictionary<string, IntPtr>();
+
+        private Instruction[] _instructions = new Instruction[16];
+        private PrimitiveValue[] _literals = new PrimitiveValue[16];
+        private char[] _strings = new char[0];
+        private byte[] _binaries = new byte[0];
+        private IntPtr[] _linkColumns = new IntPtr[0];
+        private int _instructionCount;
+        private int _literalCount;
+        private int _stringsLength;
+        private int _binariesLength;
+        private int _linkColumnCount;
+
+        public PredicateProgram(QueryHandle handle)
+        {
+            _handle = handle;
+        }
+
+        // The literal of the compare just added, which a prepared query uses to find the literals of its parameters.
+        internal int LastLiteral => _literalCount - 1;
+
+        // Set when the program is captured by a prepared query, which can't compare objects as that needs a flush.
+        internal bool IsPrepared { get; set; }
+
+        internal PrimitiveValue[] Literals => _literals;
+
+        internal int LiteralCount => _literalCount;
+
+        internal char[] Strings => _strings;
+
+        internal int StringsLength => _stringsLength;
+
+        internal byte[] Binaries => _binaries;
+
+        internal int BinariesLength => _binariesLength;
+
+        public void Flush()
+        {
+            if (_instructionCount == 0)
+            {
+                return;
+            }
+
+            _handle.ApplyPredicateProgram(_instructions, _instructionCount, _literals, _literalCount, _strings, _stringsLength,
+                                          _binaries, _binariesLength, _linkColumns, _linkColumnCount);
+            _instructionCount = 0;
+            _literalCount = 0;
+            _stringsLength = 0;
+            _binariesLength = 0;
+            _linkColumnCount = 0;
+        }
+
+        public IntPtr GetColumnIndex(string columnName)
+        {
+            IntPtr result;
+            if (!_columnIndices.TryGetValue(columnName, out result))
+            {
+                result = _handle.GetColumnIndex(columnName);
+                _columnIndices[columnName] = result;
+            }
+
+            return result;
+        }
+
+        // Captures the program as a prepared query on top of the query it was built for, instead of applying it.
+        public PreparedQueryHandle Prepare()
+        {
+            return _handle.Prepare(_instructions, _instructionCount, _literals, _literalCount, _strings, _stringsLength,
+                                   _binaries, _binariesLength, _linkColumns, _linkColumnCount);
+        }
+
+        // The type of value the compare using literal was added with.
+        public PropertyValue.ValueType GetLiteralType(int literal)
+        {
+            for (var i = 0; i < _instructionCount; i++)
+            {
+                if (_instructions[i].OpCode == OpCode.Compare && _instructions[i].Type != PropertyValue.ValueType.Null &&
+                    _instructions[i].LiteralIndex == literal)
+                {
+                    return _instructions[i].Type;
+                }
+            }
+
+            throw new ArgumentOutOfRangeException(nameof(literal));
+        }
+
+        public void GroupBegin() => Add(OpCode.BeginGroup);
+
+        public void GroupEnd() => Add(OpCode.EndGroup);
+
+        public void Or() => Add(OpCode.Or);
+
+        public void Not() => Add(OpCode.Not);
+
+        public void NullEqual(IntPtr columnIndex) => AddCompare(columnIndex, Comparison.Equal, PropertyValue.ValueType.Null);
+
+        public void NullNotEqual(IntPtr columnIndex) => AddCompare(columnIndex, Comparison.NotEqual, PropertyValue.ValueType.Null);
+
+        public void StringEqual(IntPtr columnIndex, string value, bool caseSensitive) => AddString(columnIndex, Comparison.Equal, value, caseSensitive);
+
+        public void StringNotEqual(IntPtr columnIndex, string value, bool caseSensitive) => AddString(columnIndex, Comparison.NotEqual, value, caseSensitive);
+
+        public void StringContains(IntPtr columnIndex, string value, bool caseSensitive) => AddString(columnIndex, Comparison.Contains, value, caseSensitive);
+
+        public void StringStartsWith(IntPtr columnIndex, string value, bool caseSensitive) => AddString(columnIndex, Comparison.BeginsWith, value, caseSensitive);
+
+        public void StringEndsWith(IntPtr columnIndex, string value, bool caseSensitive) => AddString(columnIndex, Comparison.EndsWith, value, caseSensitive);
+
+        public void StringLike(IntPtr columnIndex, string value, bool caseSensitive)
+        {
+            if (value == null)
+            {
+                NullEqual(columnIndex);
+            }
+            else
+            {
+                AddString(columnIndex, Comparison.Like, value, caseSensitive);
+            }
+        }
+
+        public void BoolEqual(IntPtr columnIndex, bool value) => AddBool(columnIndex, Comparison.Equal, value);
+
+        public void BoolNotEqual(IntPtr columnIndex, bool value) => AddBool(columnIndex, Comparison.NotEqual, value);
+
+        public void IntEqual(IntPtr columnIndex, int value) => AddInt64(columnIndex, Comparison.Equal, value);
+
+        public void IntNotEqual(IntPtr columnIndex, int value) => AddInt64(columnIndex, Comparison.NotEqual, value);
+
+        public void IntLess(IntPtr columnIndex, int value) => AddInt64(columnIndex, Comparison.Less, value);
+
+        public void IntLessEqual(IntPtr columnIndex, int value) => AddInt64(columnIndex, Comparison.LessEqual, value);
+
+        public void IntGreater(IntPtr columnIndex, int value) => AddInt64(columnIndex, Comparison.Greater, value);
+
+        public void IntGreaterEqual(IntPtr columnIndex, int value) => AddInt64(columnIndex, Comparison.GreaterEqual, value);
+
+        public void LongEqual(IntPtr columnIndex, long value) => AddInt64(columnIndex, Comparison.Equal, value);
+
+        public void LongNotEqual(IntPtr columnIndex, long value) => AddInt64(columnIndex, Comparison.NotEqual, value);
+
+        public void LongLess(IntPtr columnIndex, long value) => AddInt64(columnIndex, Comparison.Less, value);
+
+        public void LongLessEqual(IntPtr columnIndex, long value) => AddInt64(columnIndex, Comparison.LessEqual, value);
+
+        public void LongGreater(IntPtr columnIndex, long value) => AddInt64(columnIndex, Comparison.Greater, value);
+
+        public void LongGreaterEqual(IntPtr columnIndex, long value) => AddInt64(columnIndex, Comparison.GreaterEqual, value);
+
+        public void FloatEqual(IntPtr columnIndex, float value) => AddSingle(columnIndex, Comparison.Equal, value);
+
+        public void FloatNotEqual(IntPtr columnIndex, float value) => AddSingle(columnIndex, Comparison.NotEqual, value);
+
+        public void FloatLess(IntPtr columnIndex, float value) => AddSingle(columnIndex, Comparison.Less, value);
+
+        public void FloatLessEqual(IntPtr columnIndex, float value) => AddSingle(columnIndex, Comparison.LessEqual, value);
+
+        public void FloatGreater(IntPtr columnIndex, float value) => AddSingle(columnIndex, Comparison.Greater, value);
+
+        public void FloatGreaterEqual(IntPtr columnIndex, float value) => AddSingle(columnIndex, Comparison.GreaterEqual, value);
+
+        public void DoubleEqual(IntPtr columnIndex, double value) => AddDouble(columnIndex, Comparison.Equal, value);
+
+        public void DoubleNotEqual(IntPtr columnIndex, double value) => AddDouble(columnIndex, Comparison.NotEqual, value);
+
+        public void DoubleLess(IntPtr columnIndex, double value) => AddDouble(columnIndex, Comparison.Less, value);
+
+        public void DoubleLessEqual(IntPtr columnIndex, double value) => AddDouble(columnIndex, Comparison.LessEqual, value);
+
+        public void DoubleGreater(IntPtr columnIndex, double value) => AddDouble(columnIndex, Comparison.Greater, value);
+
+        public void DoubleGreaterEqual(IntPtr columnIndex, double value) => AddDouble(columnIndex, Comparison.GreaterEqual, value);
+
+        public void TimestampTicksEqual(IntPtr columnIndex, DateTimeOffset value) => AddDateTimeOffset(columnIndex, Comparison.Equal, value);
+
+        public void TimestampTicksNotEqual(IntPtr columnIndex, DateTimeOffset value) => AddDateTimeOffset(columnIndex, Comparison.NotEqual, value);
+
+        public void TimestampTicksLess(IntPtr columnIndex, DateTimeOffset value) => AddDateTimeOffset(columnIndex, Comparison.Less, value);
+
+        public void TimestampTicksLessEqual(IntPtr columnIndex, DateTimeOffset value) => AddDateTimeOffset(columnIndex, Comparison.LessEqual, value);
+
+        public void TimestampTicksGreater(IntPtr columnIndex, DateTimeOffset value) => AddDateTimeOffset(columnIndex, Comparison.Greater, value);
+
+        public void TimestampTicksGreaterEqual(IntPtr columnIndex, DateTimeOffset value) => AddDateTimeOffset(columnIndex, Comparison.GreaterEqual, value);
+
+        public void BinaryEqual(IntPtr columnIndex, byte[] value) => AddByteArray(columnIndex, Comparison.Equal, value);
+
+        public void BinaryNotEqual(IntPtr columnIndex, byte[] value) => AddByteArray(columnIndex, Comparison.NotEqual, value);
+
+        public void ObjectEqual(IntPtr columnIndex, ObjectHandle objectHandle)
+        {
+            if (IsPrepared)
+            {
+                throw new NotSupportedException("Objects can't be compared in a prepared query");
+            }
+
+            Flush();
+            _handle.ObjectEqual(columnIndex, objectHandle);
+        }
+
+        public void IntIn(IntPtr columnIndex, long[] values, bool matchNull)
+        {
+            FlushForSetMembership();
+            _handle.IntIn(columnIndex, values, matchNull);
+        }
+
+        public void StringIn(IntPtr columnIndex, IList<string> values, bool matchNull)
+        {
+            FlushForSetMembership();
+            _handle.StringIn(columnIndex, values, matchNull);
+        }
+
+        /// <summary>
+        /// Compares a property of the object reached by following <paramref name="linkColumnIndexes"/> with
+        /// <paramref name="value"/>, which must be null or match the property type: a bool, long, float, double,
+        /// DateTimeOffset or string.
+        /// </summary>
+        public void LinkCompare(IntPtr[] linkColumnIndexes, IntPtr columnIndex, PredicateOperator predicateOperator, object value, bool caseSensitive = false)
+        {
+            var comparison = GetComparison(predicateOperator);
+            EnsureCapacity(ref _linkColumns, _linkColumnCount + linkColumnIndexes.Length);
+            Array.Copy(linkColumnIndexes, 0, _linkColumns, _linkColumnCount, linkColumnIndexes.Length);
+
+            int index;
+            if (value == null)
+            {
+                index = AddCompare(columnIndex, comparison, PropertyValue.ValueType.Null);
+            }
+            else if (value is string)
+            {
+                index = AddString(columnIndex, comparison, (string)value, caseSensitive);
+            }
+            else if (value is bool)
+            {
+                index = AddBool(columnIndex, comparison, (bool)value);
+            }
+            else if (value is long)
+            {
+                index = AddInt64(columnIndex, comparison, (long)value);
+            }
+            else if (value is float)
+            {
+                index = AddSingle(columnIndex, comparison, (float)value);
+            }
+            else if (value is double)
+            {
+                index = AddDouble(columnIndex, comparison, (double)value);
+            }
+            else if (value is DateTimeOffset)
+            {
+                index = AddDateTimeOffset(columnIndex, comparison, (DateTimeOffset)value);
+            }
+            else
+            {
+                throw new NotSupportedException($"Type {value.GetType()} can't be compared through links");
+            }
+
+            _instructions[index].LinkOffset = (uint)_linkColumnCount;
+            _instructions[index].LinkCount = (uint)linkColumnIndexes.Length;
+            _linkColumnCount += linkColumnIndexes.Length;
+        }
+
+        private static Comparison GetComparison(PredicateOperator predicateOperator)
+        {
+            switch (predicateOperator)
+            {
+                case PredicateOperator.Equal:
+                    return Comparison.Equal;
+                case PredicateOperator.NotEqual:
+                    return Comparison.NotEqual;
+                case PredicateOperator.LessThan:
+                    return Comparison.Less;
+                case PredicateOperator.LessThanOrEqual:
+                    return Comparison.LessEqual;
+                case PredicateOperator.GreaterThan:
+                    return Comparison.Greater;
+                case PredicateOperator.GreaterThanOrEqual:
+                    return Comparison.GreaterEqual;
+                case PredicateOperator.BeginsWith:
+                    return Comparison.BeginsWith;
+                case PredicateOperator.EndsWith:
+                    return Comparison.EndsWith;
+                case PredicateOperator.Contains:
+                    return Comparison.Contains;
+                default:
+                    throw new NotSupportedException($"The operator {predicateOperator} is not supported");
+            }
+        }
+
+        private static void EnsureCapacity<T>(ref T[] array, int required)
+        {
+            if (array.Length < required)
+            {
+                Array.Resize(ref array, Math.Max(required, array.Length * 2));
+            }
+        }
+
+        private void FlushForSetMembership()
+        {
+            if (IsPrepared)
+            {
+                throw new NotSupportedException("Lists of values can't be used in a prepared query");
+            }
+
+            Flush();
+        }
+
+        private int Add(OpCode opCode)
+        {
+            EnsureCapacity(ref _instructions, _instructionCount + 1);
+            _instructions[_instructionCount] = new Instruction { OpCode = opCode };
+            return _instructionCount++;
+        }
+
+        private int AddCompare(IntPtr columnIndex, Comparison comparison, PropertyValue.ValueType type, bool caseSensitive = false)
+        {
+            var index = Add(OpCode.Compare);
+            _instructions[index].Comparison = comparison;
+            _instructions[index].Type = type;
+            _instructions[index].CaseSensitive = caseSensitive ? (byte)1 : (byte)0;
+            _instructions[index].ColumnIndex = (uint)columnIndex.ToInt64();
+            if (type != PropertyValue.ValueType.Null)
+            {
+                EnsureCapacity(ref _literals, _literalCount + 1);
+                _literals[_literalCount] = default(PrimitiveValue);
+                _literals[_literalCount].has_value = 1;
+                _instructions[index].LiteralIndex = (uint)_literalCount++;
+            }
+
+            return index;
+        }
+
+        private int AddBool(IntPtr columnIndex, Comparison comparison, bool value)
+        {
+            var index = AddCompare(columnIndex, comparison, PropertyValue.ValueType.Bool);
+            _literals[LastLiteral].bool_value = value ? (byte)1 : (byte)0;
+            return index;
+        }
+
+        private int AddInt64(IntPtr columnIndex, Comparison comparison, long value)
+        {
+            var index = AddCompare(columnIndex, comparison, PropertyValue.ValueType.Int);
+            _literals[LastLiteral].int_value = value;
+            return index;
+        }
+
+        private int AddSingle(IntPtr columnIndex, Comparison comparison, float value)
+        {
+            var index = AddCompare(columnIndex, comparison, PropertyValue.ValueType.Float);
+            _literals[LastLiteral].float_value = value;
+            return index;
+        }
+
+        private int AddDouble(IntPtr columnIndex, Comparison comparison, double value)
+        {
+            var index = AddCompare(columnIndex, comparison, PropertyValue.ValueType.Double);
+            _literals[LastLiteral].double_value = value;
+            return index;
+        }
+
+        private int AddDateTimeOffset(IntPtr columnIndex, Comparison comparison, DateTimeOffset value)
+        {
+            var index = AddCompare(columnIndex, comparison, PropertyValue.ValueType.Timestamp);
+            _literals[LastLiteral].ticks = value.ToUniversalTime().Ticks;
+            return index;
+        }
+
+        private int AddString(IntPtr columnIndex, Comparison comparison, string value, bool caseSensitive)
+        {
+            if (value == null)
+            {
+                if (comparison != Comparison.Equal && comparison != Comparison.NotEqual)
+                {
+                    throw new ArgumentNullException(nameof(value));
+                }
+
+                return AddCompare(columnIndex, comparison, PropertyValue.ValueType.Null);
+            }
+
+            EnsureCapacity(ref _strings, _stringsLength + value.Length);
+            value.CopyTo(0, _strings, _stringsLength, value.Length);
+
+            var index = AddCompare(columnIndex, comparison, PropertyValue.ValueType.String, caseSensitive);
+            _literals[LastLiteral].string_offset = (uint)_stringsLength;
+            _literals[LastLiteral].string_length = (uint)value.Length;
+            _stringsLength += value.Length;
+            return index;
+        }
+
+        private int AddByteArray(IntPtr columnIndex, Comparison comparison, byte[] value)
+        {
+            if (value == null)
+            {
+                return AddCompare(columnIndex, comparison, PropertyValue.ValueType.Null);
+            }
+
+            EnsureCapacity(ref _binaries, _binariesLength + value.Length);
+            Buffer.BlockCopy(value, 0, _binaries, _binariesLength, value.Length);
+
+            var index = AddCompare(columnIndex, comparison, PropertyValue.ValueType.Binary);
+            _literals[LastLiteral].string_offset = (uint)_binariesLength;
+            _literals[LastLiteral].string_length = (uint)value.Length;
+            _binariesLength += value.Length;
+            return index;
+        }
+    }
+}
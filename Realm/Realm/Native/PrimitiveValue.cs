@@ -0,0 +1,62 @@
+﻿////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Diagnostics.CodeAnalysis;
+using System.Runtime.InteropServices;
+
+namespace Realms.Native
+{
+    // A slot of the packed buffer filled by object_get_values - must match PrimitiveValue in object_cs.hpp.
+    [StructLayout(LayoutKind.Explicit, Size = 16)]
+    [SuppressMessage("StyleCop.CSharp.NamingRules", "SA1307:AccessibleFieldsMustBeginWithUpperCaseLetter")]
+    internal struct PrimitiveValue
+    {
+        [FieldOffset(0)]
+        internal byte bool_value;
+
+        [FieldOffset(0)]
+        internal long int_value;
+
+        [FieldOffset(0)]
+        internal float float_value;
+
+        [FieldOffset(0)]
+        internal double double_value;
+
+        [FieldOffset(0)]
+        internal long ticks;
+
+        [FieldOffset(0)]
+        internal uint string_offset;
+
+        [FieldOffset(4)]
+        internal uint string_length;
+
+        [FieldOffset(8)]
+        internal byte has_value;
+
+        internal bool HasValue => has_value != 0;
+
+        internal bool AsBool() => bool_value != 0;
+
+        internal DateTimeOffset AsDateTimeOffset() => new DateTimeOffset(ticks, TimeSpan.Zero);
+
+        internal string AsString(char[] stringBuffer) => new string(stringBuffer, (int)string_offset, (int)string_length);
+    }
+}
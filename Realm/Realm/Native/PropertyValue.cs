@@ -0,0 +1,75 @@
+﻿////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System.Diagnostics.CodeAnalysis;
+using System.Runtime.InteropServices;
+
+namespace Realms.Native
+{
+    // An entry of the packed buffer applied by object_set_values - must match PropertyValue in object_cs.hpp.
+    [StructLayout(LayoutKind.Explicit, Size = 16)]
+    [SuppressMessage("StyleCop.CSharp.NamingRules", "SA1307:AccessibleFieldsMustBeginWithUpperCaseLetter")]
+    internal struct PropertyValue
+    {
+        internal enum ValueType : byte
+        {
+            Null,
+            Bool,
+            Int,
+            Float,
+            Double,
+            Timestamp,
+            String,
+            Binary,
+            Link
+        }
+
+        [FieldOffset(0)]
+        internal uint property_ndx;
+
+        [FieldOffset(4)]
+        internal ValueType type;
+
+        [FieldOffset(5)]
+        internal byte is_primary_key;
+
+        [FieldOffset(8)]
+        internal byte bool_value;
+
+        [FieldOffset(8)]
+        internal long int_value;
+
+        [FieldOffset(8)]
+        internal float float_value;
+
+        [FieldOffset(8)]
+        internal double double_value;
+
+        [FieldOffset(8)]
+        internal long ticks;
+
+        [FieldOffset(8)]
+        internal uint data_offset;
+
+        [FieldOffset(12)]
+        internal uint data_length;
+
+        [FieldOffset(8)]
+        internal ulong link_row;
+    }
+}
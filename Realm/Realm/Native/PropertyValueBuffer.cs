@@ -0,0 +1,139 @@
+﻿////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+
+namespace Realms.Native
+{
+    // Collects the values to be applied to an object with ObjectHandle.SetValues. Can be cleared and reused
+    // for the next object to avoid reallocating the entry and pool arrays.
+    internal class PropertyValueBuffer
+    {
+        private PropertyValue[] _values = new PropertyValue[16];
+        private char[] _strings = new char[256];
+        private byte[] _binaries = new byte[0];
+        private int _stringsLength;
+        private int _binariesLength;
+
+        internal PropertyValue[] Values => _values;
+
+        internal char[] Strings => _strings;
+
+        internal byte[] Binaries => _binaries;
+
+        internal int Count { get; private set; }
+
+        public void Clear()
+        {
+            Count = 0;
+            _stringsLength = 0;
+            _binariesLength = 0;
+        }
+
+        public void AddNull(IntPtr propertyIndex, bool isPrimaryKey = false)
+        {
+            Add(propertyIndex, PropertyValue.ValueType.Null, isPrimaryKey);
+        }
+
+        public void AddBool(IntPtr propertyIndex, bool value)
+        {
+            _values[Add(propertyIndex, PropertyValue.ValueType.Bool)].bool_value = value ? (byte)1 : (byte)0;
+        }
+
+        public void AddInt64(IntPtr propertyIndex, long value, bool isPrimaryKey = false)
+        {
+            _values[Add(propertyIndex, PropertyValue.ValueType.Int, isPrimaryKey)].int_value = value;
+        }
+
+        public void AddSingle(IntPtr propertyIndex, float value)
+        {
+            _values[Add(propertyIndex, PropertyValue.ValueType.Float)].float_value = value;
+        }
+
+        public void AddDouble(IntPtr propertyIndex, double value)
+        {
+            _values[Add(propertyIndex, PropertyValue.ValueType.Double)].double_value = value;
+        }
+
+        public void AddDateTimeOffset(IntPtr propertyIndex, DateTimeOffset value)
+        {
+            _values[Add(propertyIndex, PropertyValue.ValueType.Timestamp)].ticks = value.ToUniversalTime().Ticks;
+        }
+
+        public void AddString(IntPtr propertyIndex, string value, bool isPrimaryKey = false)
+        {
+            if (value == null)
+            {
+                AddNull(propertyIndex, isPrimaryKey);
+                return;
+            }
+
+            EnsureCapacity(ref _strings, _stringsLength + value.Length);
+            value.CopyTo(0, _strings, _stringsLength, value.Length);
+
+            var index = Add(propertyIndex, PropertyValue.ValueType.String, isPrimaryKey);
+            _values[index].data_offset = (uint)_stringsLength;
+            _values[index].data_length = (uint)value.Length;
+            _stringsLength += value.Length;
+        }
+
+        public void AddByteArray(IntPtr propertyIndex, byte[] value)
+        {
+            if (value == null)
+            {
+                AddNull(propertyIndex);
+                return;
+            }
+
+            EnsureCapacity(ref _binaries, _binariesLength + value.Length);
+            Buffer.BlockCopy(value, 0, _binaries, _binariesLength, value.Length);
+
+            var index = Add(propertyIndex, PropertyValue.ValueType.Binary);
+            _values[index].data_offset = (uint)_binariesLength;
+            _values[index].data_length = (uint)value.Length;
+            _binariesLength += value.Length;
+        }
+
+        // Links to the object at rowIndex in the link target table. Use AddNull to clear a link.
+        public void AddLink(IntPtr propertyIndex, long rowIndex)
+        {
+            _values[Add(propertyIndex, PropertyValue.ValueType.Link)].link_row = (ulong)rowIndex;
+        }
+
+        private static void EnsureCapacity<T>(ref T[] array, int required)
+        {
+            if (array.Length < required)
+            {
+                Array.Resize(ref array, Math.Max(required, array.Length * 2));
+            }
+        }
+
+        private int Add(IntPtr propertyIndex, PropertyValue.ValueType type, bool isPrimaryKey = false)
+        {
+            EnsureCapacity(ref _values, Count + 1);
+
+            _values[Count] = new PropertyValue
+            {
+                property_ndx = (uint)propertyIndex.ToInt64(),
+                type = type,
+                is_primary_key = isPrimaryKey ? (byte)1 : (byte)0
+            };
+            return Count++;
+        }
+    }
+}
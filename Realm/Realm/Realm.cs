@@ -169,6 +169,7 @@ internal static ObjectHandle CreateObjectHandle(IntPtr objectPtr, SharedRealmHan
 
         #endregion
 
+        private readonly Stack<PropertyValueBuffer> _propertyValueBuffers = new Stack<PropertyValueBuffer>();
         private RealmState _state;
 
         internal readonly SharedRealmHandle SharedRealmHandle;
@@ -453,19 +454,47 @@ internal ResultsHandle MakeResultsForTable(RealmObject.Metadata metadata)
             return CreateResultsHandle(resultsPtr);
         }
 
-        internal ResultsHandle MakeResultsForQuery(QueryHandle builtQuery, SortDescriptorBuilder optionalSortDescriptorBuilder)
+        internal ResultsHandle MakeResultsForQuery(QueryHandle builtQuery, SortDescriptorBuilder optionalSortDescriptorBuilder, int offset = 0, int? limit = null)
         {
+            var isWindowed = offset > 0 || limit.HasValue;
             var resultsPtr = IntPtr.Zero;
             if (optionalSortDescriptorBuilder == null)
             {
-                resultsPtr = builtQuery.CreateResults(SharedRealmHandle);
+                resultsPtr = isWindowed ? builtQuery.CreateWindowedResults(SharedRealmHandle, offset, limit) : builtQuery.CreateResults(SharedRealmHandle);
             }
             else
             {
+                // These results stay live, so a window over them has to sort every match; top-k narrowing is only
+                // safe for the transient results below.
                 resultsPtr = builtQuery.CreateSortedResults(SharedRealmHandle, optionalSortDescriptorBuilder);
             }
 
-            return CreateResultsHandle(resultsPtr);
+            var resultsHandle = CreateResultsHandle(resultsPtr);
+            if (isWindowed)
+            {
+                resultsHandle.SetWindow(offset, limit);
+            }
+
+            return resultsHandle;
+        }
+
+        /// <summary>
+        /// Like <see cref="MakeResultsForQuery"/>, for results that are read and disposed before this <see cref="Realm"/> can change,
+        /// such as evaluating <c>First</c> or <c>ElementAt</c>. Sorted results with a limit only sort the rows that can end up
+        /// in the window, but they are not updated correctly by later changes.
+        /// </summary>
+        internal ResultsHandle MakeTransientResultsForQuery(QueryHandle builtQuery, SortDescriptorBuilder optionalSortDescriptorBuilder, int offset, int? limit)
+        {
+            if (optionalSortDescriptorBuilder == null || !limit.HasValue)
+            {
+                return MakeResultsForQuery(builtQuery, optionalSortDescriptorBuilder, offset, limit);
+            }
+
+            // Only the first offset + limit sorted rows can end up in the window, so there is no need to sort the rest.
+            var k = limit.Value > int.MaxValue - offset ? int.MaxValue : offset + limit.Value;
+            var resultsHandle = CreateResultsHandle(builtQuery.CreateTopKResults(SharedRealmHandle, optionalSortDescriptorBuilder, k));
+            resultsHandle.SetWindow(offset, limit);
+            return resultsHandle;
         }
         
         /// <summary>
@@ -585,7 +614,22 @@ private void AddInternal(RealmObject obj, Type objectType, bool update)
             var objectHandle = CreateObjectHandle(objectPtr, SharedRealmHandle);
 
             obj._SetOwner(this, objectHandle, metadata);
-            metadata.Helper.CopyToRealm(obj, update, setPrimaryKey);
+
+            // The woven CopyToRealm goes through the property setters, which the handle collects so that
+            // all the values reach native code in one call. Adding a linked object nests, so buffers are
+            // taken from a stack rather than shared.
+            var buffer = _propertyValueBuffers.Count > 0 ? _propertyValueBuffers.Pop() : new PropertyValueBuffer();
+            objectHandle.BeginPendingValues(buffer);
+            try
+            {
+                metadata.Helper.CopyToRealm(obj, update, setPrimaryKey);
+                objectHandle.ApplyPendingValues();
+            }
+            finally
+            {
+                objectHandle.DiscardPendingValues();
+                _propertyValueBuffers.Push(buffer);
+            }
         }
 
         /// <summary>
@@ -25,6 +25,7 @@
 using System.Diagnostics.CodeAnalysis;
 using System.Linq;
 using System.Runtime.InteropServices;
+using Realms.Native;
 
 namespace Realms
 {
@@ -121,6 +122,37 @@ internal RealmCollectionBase(Realm realm, RealmObject.Metadata metadata)
 
         internal abstract CollectionHandleBase CreateHandle();
 
+        // The objects in either collection, in both or only in this one. Both must hold the same object type and come from
+        // the same Realm. The result is a snapshot in table order, so it is not updated by later changes. It can be enumerated,
+        // indexed and counted, but not queried further, observed or passed to another thread.
+        internal RealmResults<T> Combine(RealmCollectionBase<T> other, RowSetOperation operation)
+        {
+            var resultsPtr = WithResultsHandle(lhs => other.WithResultsHandle(rhs => lhs.Combine(rhs, operation)));
+            var resultsHandle = Realm.CreateResultsHandle(resultsPtr);
+            resultsHandle.MarkAsSnapshot();
+            return new RealmResults<T>(Realm, resultsHandle, Metadata);
+        }
+
+        // The number of objects Combine would return, without creating the results.
+        internal int CountCombined(RealmCollectionBase<T> other, RowSetOperation operation)
+        {
+            return WithResultsHandle(lhs => other.WithResultsHandle(rhs => lhs.CombinedCount(rhs, operation)));
+        }
+
+        private TResult WithResultsHandle<TResult>(Func<ResultsHandle, TResult> action)
+        {
+            var listHandle = Handle.Value as ListHandle;
+            if (listHandle == null)
+            {
+                return action((ResultsHandle)Handle.Value);
+            }
+
+            using (var results = listHandle.GetResults())
+            {
+                return action(results);
+            }
+        }
+
         public T this[int index]
         {
             get
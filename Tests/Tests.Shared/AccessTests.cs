@@ -17,9 +17,11 @@
 ////////////////////////////////////////////////////////////////////////////
 
 using System;
+using System.Linq;
 using NUnit.Framework;
 using Realms;
 using Realms.Exceptions;
+using Realms.Native;
 
 namespace Tests.Database
 {
@@ -94,6 +96,259 @@ public void SetValueAndReplaceWithNull(string propertyName, object propertyValue
             new object[] { "NullableDateTimeOffsetProperty", new DateTimeOffset(1956, 6, 1, 0, 0, 0, TimeSpan.Zero) }
         };
 
+        [Test]
+        public void ByteArrayProperty_WhenWrittenAndReadInChunks_ShouldRoundTrip()
+        {
+            var data = new byte[100000];
+            new Random(42).NextBytes(data);
+
+            AllTypesObject ato = null;
+            _realm.Write(() =>
+            {
+                ato = _realm.Add(new AllTypesObject { RequiredStringProperty = string.Empty });
+                var propertyIndex = ato.ObjectMetadata.PropertyIndices["ByteArrayProperty"];
+
+                using (var writer = ato.ObjectHandle.OpenByteArrayWriter(propertyIndex, data.Length))
+                {
+                    for (var offset = 0; offset < data.Length; offset += 4096)
+                    {
+                        writer.Append(data, offset, Math.Min(4096, data.Length - offset));
+                    }
+
+                    writer.Commit();
+                }
+            });
+
+            Assert.That(ato.ByteArrayProperty, Is.EqualTo(data));
+
+            var index = ato.ObjectMetadata.PropertyIndices["ByteArrayProperty"];
+            Assert.That(ato.ObjectHandle.GetByteArraySize(index), Is.EqualTo(data.Length));
+
+            var readBack = new byte[data.Length];
+            var chunk = new byte[3000];
+            long position = 0;
+            int read;
+            while ((read = ato.ObjectHandle.ReadByteArrayChunk(index, position, chunk, 0, chunk.Length)) > 0)
+            {
+                Array.Copy(chunk, 0, readBack, (int)position, read);
+                position += read;
+            }
+
+            Assert.That(position, Is.EqualTo(data.Length));
+            Assert.That(readBack, Is.EqualTo(data));
+
+            _realm.Write(() => ato.ByteArrayProperty = null);
+            Assert.That(ato.ObjectHandle.GetByteArraySize(index), Is.EqualTo(-1));
+            Assert.That(ato.ObjectHandle.ReadByteArrayChunk(index, 0, chunk, 0, chunk.Length), Is.EqualTo(-1));
+        }
+
+        [Test]
+        public void GetValues_ShouldReadSelectedPropertiesInOneCall()
+        {
+            var date = new DateTimeOffset(1956, 6, 1, 0, 0, 0, TimeSpan.Zero);
+            AllTypesObject ato = null;
+            _realm.Write(() =>
+            {
+                ato = _realm.Add(new AllTypesObject
+                {
+                    Int64Property = 42,
+                    DoubleProperty = 1.5,
+                    BooleanProperty = true,
+                    DateTimeOffsetProperty = date,
+                    RequiredStringProperty = "h\u00e9llo",
+                    StringProperty = "w\u00f6rld",
+                });
+            });
+
+            var properties = new[]
+            {
+                "Int64Property", "DoubleProperty", "BooleanProperty", "DateTimeOffsetProperty",
+                "RequiredStringProperty", "StringProperty", "NullableInt32Property"
+            };
+            var indices = properties.Select(p => (int)ato.ObjectMetadata.PropertyIndices[p]).ToArray();
+
+            var mask = new ulong[(indices.Max() / 64) + 1];
+            foreach (var index in indices)
+            {
+                mask[index / 64] |= 1UL << (index % 64);
+            }
+
+            // slots follow property index order, so look them up by rank
+            var sorted = indices.OrderBy(i => i).ToList();
+            var values = new PrimitiveValue[indices.Length];
+            var strings = new char[1];
+            ato.ObjectHandle.GetValues(mask, values, ref strings);
+
+            Func<string, PrimitiveValue> slot = name => values[sorted.IndexOf(indices[Array.IndexOf(properties, name)])];
+
+            Assert.That(slot("Int64Property").int_value, Is.EqualTo(42));
+            Assert.That(slot("DoubleProperty").double_value, Is.EqualTo(1.5));
+            Assert.That(slot("BooleanProperty").AsBool(), Is.True);
+            Assert.That(slot("DateTimeOffsetProperty").AsDateTimeOffset(), Is.EqualTo(date));
+            Assert.That(slot("RequiredStringProperty").AsString(strings), Is.EqualTo("h\u00e9llo"));
+            Assert.That(slot("StringProperty").AsString(strings), Is.EqualTo("w\u00f6rld"));
+            Assert.That(slot("NullableInt32Property").HasValue, Is.False);
+        }
+
+        [Test]
+        public void GetValues_WhenMaskSelectsMoreThanValuesHolds_ShouldThrow()
+        {
+            AllTypesObject ato = null;
+            _realm.Write(() => ato = _realm.Add(new AllTypesObject { RequiredStringProperty = string.Empty }));
+
+            var indices = new[] { "Int64Property", "DoubleProperty" }.Select(p => (int)ato.ObjectMetadata.PropertyIndices[p]).ToArray();
+            var mask = new ulong[(indices.Max() / 64) + 1];
+            foreach (var index in indices)
+            {
+                mask[index / 64] |= 1UL << (index % 64);
+            }
+
+            var values = new PrimitiveValue[1];
+            var strings = new char[1];
+            Assert.That(() => ato.ObjectHandle.GetValues(mask, values, ref strings), Throws.InstanceOf<RealmException>());
+        }
+
+        [Test]
+        public void SetValues_ShouldApplyAllEntriesInOneCall()
+        {
+            var date = new DateTimeOffset(1956, 6, 1, 0, 0, 0, TimeSpan.Zero);
+            _realm.Write(() =>
+            {
+                var ato = _realm.Add(new AllTypesObject { RequiredStringProperty = string.Empty });
+                var indices = ato.ObjectMetadata.PropertyIndices;
+
+                var buffer = new PropertyValueBuffer();
+                buffer.AddInt64(indices["Int64Property"], 42);
+                buffer.AddDouble(indices["DoubleProperty"], 1.5);
+                buffer.AddBool(indices["BooleanProperty"], true);
+                buffer.AddDateTimeOffset(indices["DateTimeOffsetProperty"], date);
+                buffer.AddString(indices["RequiredStringProperty"], "h\u00e9llo");
+                buffer.AddString(indices["StringProperty"], null);
+                buffer.AddByteArray(indices["ByteArrayProperty"], new byte[] { 0xde, 0xad });
+                buffer.AddNull(indices["NullableInt32Property"]);
+                ato.ObjectHandle.SetValues(buffer);
+
+                Assert.That(ato.Int64Property, Is.EqualTo(42));
+                Assert.That(ato.DoubleProperty, Is.EqualTo(1.5));
+                Assert.That(ato.BooleanProperty, Is.True);
+                Assert.That(ato.DateTimeOffsetProperty, Is.EqualTo(date));
+                Assert.That(ato.RequiredStringProperty, Is.EqualTo("h\u00e9llo"));
+                Assert.That(ato.StringProperty, Is.Null);
+                Assert.That(ato.ByteArrayProperty, Is.EqualTo(new byte[] { 0xde, 0xad }));
+                Assert.That(ato.NullableInt32Property, Is.Null);
+
+                var dog = _realm.Add(new Dog { Name = "Rex" });
+                var owner = _realm.Add(new Owner());
+                buffer.Clear();
+                buffer.AddString(owner.ObjectMetadata.PropertyIndices["Name"], "Tim");
+                buffer.AddLink(owner.ObjectMetadata.PropertyIndices["TopDog"], dog.ObjectHandle.RowIndex);
+                owner.ObjectHandle.SetValues(buffer);
+
+                Assert.That(owner.Name, Is.EqualTo("Tim"));
+                Assert.That(owner.TopDog, Is.EqualTo(dog));
+            });
+        }
+
+        [Test]
+        public void SetValues_WhenPrimaryKeyIsDuplicated_ShouldThrow()
+        {
+            _realm.Write(() =>
+            {
+                _realm.Add(new PrimaryKeyStringObject { StringProperty = "a" });
+                var second = _realm.Add(new PrimaryKeyStringObject { StringProperty = "b" });
+
+                var buffer = new PropertyValueBuffer();
+                buffer.AddString(second.ObjectMetadata.PropertyIndices["StringProperty"], "a", isPrimaryKey: true);
+
+                Assert.That(() => second.ObjectHandle.SetValues(buffer), Throws.TypeOf<RealmDuplicatePrimaryKeyValueException>());
+            });
+        }
+
+        [Test]
+        public void SetValues_WhenTypeDoesNotMatchProperty_ShouldThrowWithoutWriting()
+        {
+            _realm.Write(() =>
+            {
+                var ato = _realm.Add(new AllTypesObject { RequiredStringProperty = "before" });
+                var indices = ato.ObjectMetadata.PropertyIndices;
+
+                var buffer = new PropertyValueBuffer();
+                buffer.AddString(indices["RequiredStringProperty"], "after");
+                buffer.AddInt64(indices["DoubleProperty"], 42);
+
+                Assert.That(() => ato.ObjectHandle.SetValues(buffer), Throws.InstanceOf<RealmException>());
+                Assert.That(ato.RequiredStringProperty, Is.EqualTo("before"));
+                Assert.That(ato.DoubleProperty, Is.EqualTo(0));
+            });
+        }
+
+        [Test]
+        public void SetValues_WhenRequiredPropertyIsNull_ShouldThrowWithoutWriting()
+        {
+            _realm.Write(() =>
+            {
+                var ato = _realm.Add(new AllTypesObject { RequiredStringProperty = "before" });
+                var indices = ato.ObjectMetadata.PropertyIndices;
+
+                var buffer = new PropertyValueBuffer();
+                buffer.AddInt64(indices["Int64Property"], 42);
+                buffer.AddNull(indices["RequiredStringProperty"]);
+
+                Assert.That(() => ato.ObjectHandle.SetValues(buffer), Throws.InstanceOf<RealmException>());
+                Assert.That(ato.Int64Property, Is.EqualTo(0));
+                Assert.That(ato.RequiredStringProperty, Is.EqualTo("before"));
+            });
+        }
+
+        [Test]
+        public void AddObjects_ShouldInsertAllRowsFromColumns()
+        {
+            var metadata = _realm.Metadata[nameof(AllTypesObject)];
+            var indices = metadata.PropertyIndices;
+            var date = new DateTimeOffset(1956, 6, 1, 0, 0, 0, TimeSpan.Zero);
+
+            _realm.Write(() =>
+            {
+                var firstRow = metadata.Table.AddObjects(_realm.SharedRealmHandle,
+                    BulkColumn.ForInt64(indices["Int64Property"], new long[] { 1, 2, 3 }),
+                    BulkColumn.ForDouble(indices["DoubleProperty"], new[] { 1.5, 2.5, 3.5 }),
+                    BulkColumn.ForDateTimeOffset(indices["DateTimeOffsetProperty"], new DateTimeOffset?[] { date, date, date }),
+                    BulkColumn.ForString(indices["RequiredStringProperty"], new[] { "a", "b\u00e9", string.Empty }),
+                    BulkColumn.ForString(indices["StringProperty"], new[] { "x", null, "z" }),
+                    BulkColumn.ForInt64(indices["NullableInt64Property"], new long?[] { null, 5, null }));
+
+                Assert.That(firstRow, Is.EqualTo(0));
+            });
+
+            var objects = _realm.All<AllTypesObject>().ToArray();
+            Assert.That(objects.Select(o => o.Int64Property), Is.EqualTo(new long[] { 1, 2, 3 }));
+            Assert.That(objects.Select(o => o.DoubleProperty), Is.EqualTo(new[] { 1.5, 2.5, 3.5 }));
+            Assert.That(objects.Select(o => o.DateTimeOffsetProperty), Is.All.EqualTo(date));
+            Assert.That(objects.Select(o => o.RequiredStringProperty), Is.EqualTo(new[] { "a", "b\u00e9", string.Empty }));
+            Assert.That(objects.Select(o => o.StringProperty), Is.EqualTo(new[] { "x", null, "z" }));
+            Assert.That(objects.Select(o => o.NullableInt64Property), Is.EqualTo(new long?[] { null, 5, null }));
+        }
+
+        [Test]
+        public void AddObjects_WhenPrimaryKeyIsDuplicated_ShouldThrow()
+        {
+            var metadata = _realm.Metadata[nameof(PrimaryKeyInt64Object)];
+            var index = metadata.PropertyIndices["Int64Property"];
+
+            _realm.Write(() =>
+            {
+                _realm.Add(new PrimaryKeyInt64Object { Int64Property = 5 });
+
+                Assert.That(() => metadata.Table.AddObjects(_realm.SharedRealmHandle, BulkColumn.ForInt64(index, new long[] { 1, 2, 1 })),
+                            Throws.TypeOf<RealmDuplicatePrimaryKeyValueException>());
+                Assert.That(() => metadata.Table.AddObjects(_realm.SharedRealmHandle, BulkColumn.ForInt64(index, new long[] { 3, 4, 5 })),
+                            Throws.TypeOf<RealmDuplicatePrimaryKeyValueException>());
+
+                // Neither batch left any of its rows behind.
+                Assert.That(_realm.All<PrimaryKeyInt64Object>().Count(), Is.EqualTo(1));
+            });
+        }
+
         [Test]
         public void AccessingRemovedObjectShouldThrow()
         {
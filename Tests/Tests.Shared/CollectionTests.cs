@@ -21,6 +21,7 @@
 using System.Linq;
 using NUnit.Framework;
 using Realms;
+using Realms.Exceptions;
 
 namespace Tests.Database
 {
@@ -217,6 +218,73 @@ public void Results_WhenRealmIsClosed_ShouldBeInvalid()
             Assert.That(items.AsRealmCollection().IsValid, Is.False);
         }
 
+        [Test]
+        public void Results_GetRange_ShouldMaterializeWindowInOneCall()
+        {
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < 10; i++)
+                {
+                    _realm.Add(new IntPropertyObject { Int = i });
+                }
+            });
+
+            var results = (RealmResults<IntPropertyObject>)_realm.All<IntPropertyObject>().Where(o => o.Int >= 2).OrderByDescending(o => o.Int);
+
+            var buffer = new IntPropertyObject[5];
+            Assert.That(results.GetRange(0, buffer), Is.EqualTo(5));
+            Assert.That(buffer.Select(o => o.Int), Is.EqualTo(new[] { 9, 8, 7, 6, 5 }));
+
+            Assert.That(results.GetRange(5, buffer), Is.EqualTo(3));
+            Assert.That(buffer.Take(3).Select(o => o.Int), Is.EqualTo(new[] { 4, 3, 2 }));
+
+            Assert.That(results.GetRange(8, buffer), Is.EqualTo(0));
+
+            var rowIndices = new long[4];
+            Assert.That(results.ResultsHandle.GetRowIndices(6, rowIndices), Is.EqualTo(2));
+            Assert.That(rowIndices.Take(2), Is.EqualTo(new long[] { 3, 2 }));
+        }
+
+        [Test]
+        public void Results_GetColumn_ShouldCopyPropertyWithNullBitmap()
+        {
+            var baseDate = new DateTimeOffset(2017, 5, 1, 12, 30, 0, 250, TimeSpan.Zero);
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < 300; i++)
+                {
+                    _realm.Add(new AllTypesObject
+                    {
+                        Int64Property = i,
+                        NullableDoubleProperty = i % 3 == 0 ? (double?)null : i * 0.5,
+                        DateTimeOffsetProperty = baseDate.AddSeconds(i),
+                        RequiredStringProperty = string.Empty
+                    });
+                }
+            });
+
+            var results = (RealmResults<AllTypesObject>)_realm.All<AllTypesObject>().Where(o => o.Int64Property >= 10);
+            var propertyIndices = _realm.Metadata[nameof(AllTypesObject)].PropertyIndices;
+
+            var doubles = new double[290];
+            var nulls = new byte[(doubles.Length + 7) / 8];
+            Assert.That(results.ResultsHandle.GetDoubleColumn(propertyIndices[nameof(AllTypesObject.NullableDoubleProperty)], 0, doubles, nulls), Is.EqualTo(290));
+            for (var i = 0; i < doubles.Length; i++)
+            {
+                var value = i + 10;
+                var isNull = (nulls[i / 8] & (1 << (i % 8))) != 0;
+                Assert.That(isNull, Is.EqualTo(value % 3 == 0));
+                Assert.That(doubles[i], Is.EqualTo(isNull ? 0 : value * 0.5));
+            }
+
+            var ticks = new long[300];
+            Assert.That(results.ResultsHandle.GetDateTimeOffsetTicksColumn(propertyIndices[nameof(AllTypesObject.DateTimeOffsetProperty)], 5, ticks, null), Is.EqualTo(285));
+            Assert.That(ticks.Take(285), Is.EqualTo(Enumerable.Range(15, 285).Select(i => baseDate.AddSeconds(i).UtcTicks)));
+
+            Assert.That(() => results.ResultsHandle.GetInt64Column(propertyIndices[nameof(AllTypesObject.NullableDoubleProperty)], 0, new long[1], new byte[1]),
+                        Throws.TypeOf<RealmException>());
+        }
+
         private ContainerObject GetPopulatedManagedContainerObject()
         {
             var container = new ContainerObject();
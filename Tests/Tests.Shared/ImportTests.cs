@@ -0,0 +1,156 @@
+﻿////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using System.IO;
+using System.Linq;
+using System.Text;
+using NUnit.Framework;
+using Realms;
+using Realms.Exceptions;
+using Realms.Native;
+
+namespace Tests.Database
+{
+    [TestFixture, Preserve(AllMembers = true)]
+    public class ImportTests : RealmInstanceTest
+    {
+        private string _importPath;
+
+        protected override void CustomSetUp()
+        {
+            base.CustomSetUp();
+            _importPath = Path.GetTempFileName();
+        }
+
+        protected override void CustomTearDown()
+        {
+            File.Delete(_importPath);
+            base.CustomTearDown();
+        }
+
+        [Test]
+        public void ImportFile_WhenCsv_ShouldInsertAllRows()
+        {
+            File.WriteAllText(_importPath,
+                              "Int64Property,DoubleProperty,BooleanProperty,RequiredStringProperty,StringProperty,DateTimeOffsetProperty\r\n" +
+                              "1,1.5,true,one,,2017-03-01T10:15:30Z\r\n" +
+                              "2,-2.25,false,\"two, with \"\"quotes\"\"\",x,2017-03-02T00:00:00.5+02:00\r\n",
+                              Encoding.UTF8);
+
+            var imported = _realm.SharedRealmHandle.ImportFile(nameof(AllTypesObject), _importPath, ImportOptions.Format.Csv);
+
+            Assert.That(imported, Is.EqualTo(2));
+
+            var objects = _realm.All<AllTypesObject>().OrderBy(o => o.Int64Property).ToArray();
+            Assert.That(objects.Select(o => o.DoubleProperty), Is.EqualTo(new[] { 1.5, -2.25 }));
+            Assert.That(objects.Select(o => o.BooleanProperty), Is.EqualTo(new[] { true, false }));
+            Assert.That(objects.Select(o => o.RequiredStringProperty), Is.EqualTo(new[] { "one", "two, with \"quotes\"" }));
+            Assert.That(objects.Select(o => o.StringProperty), Is.EqualTo(new[] { null, "x" }));
+            Assert.That(objects[0].DateTimeOffsetProperty, Is.EqualTo(new DateTimeOffset(2017, 3, 1, 10, 15, 30, TimeSpan.Zero)));
+            Assert.That(objects[1].DateTimeOffsetProperty, Is.EqualTo(new DateTimeOffset(2017, 3, 2, 0, 0, 0, 500, TimeSpan.FromHours(2))));
+        }
+
+        [Test]
+        public void ImportFile_WhenNdJson_ShouldInsertAllRows()
+        {
+            File.WriteAllText(_importPath,
+                              "{\"StringProperty\": \"a\\u00e9\"}\n" +
+                              "{\"StringProperty\": null}\n" +
+                              "{\"StringProperty\": \"c\"}\n",
+                              Encoding.UTF8);
+
+            var imported = _realm.SharedRealmHandle.ImportFile(nameof(PrimaryKeyStringObject), _importPath, ImportOptions.Format.NdJson);
+
+            Assert.That(imported, Is.EqualTo(3));
+            Assert.That(_realm.Find<PrimaryKeyStringObject>("aé"), Is.Not.Null);
+            Assert.That(_realm.Find<PrimaryKeyStringObject>((string)null), Is.Not.Null);
+            Assert.That(_realm.Find<PrimaryKeyStringObject>("c"), Is.Not.Null);
+        }
+
+        [Test]
+        public void ImportFile_ShouldCommitInBatchesAndReportProgress()
+        {
+            var builder = new StringBuilder();
+            for (var i = 0; i < 1000; i++)
+            {
+                builder.Append(i).Append('\n');
+            }
+
+            File.WriteAllText(_importPath, builder.ToString());
+
+            var progress = new List<ulong>();
+            var imported = _realm.SharedRealmHandle.ImportFile(nameof(PrimaryKeyInt64Object), _importPath, ImportOptions.Format.Csv,
+                                                               hasHeader: false, rowsPerTransaction: 300, threadCount: 2,
+                                                               onProgress: (rows, bytes, total) =>
+                                                               {
+                                                                   progress.Add(rows);
+                                                                   return true;
+                                                               });
+
+            Assert.That(imported, Is.EqualTo(1000));
+            Assert.That(progress, Is.EqualTo(new ulong[] { 300, 600, 900, 1000 }));
+            Assert.That(_realm.All<PrimaryKeyInt64Object>().Count(), Is.EqualTo(1000));
+        }
+
+        [Test]
+        public void ImportFile_WhenProgressCallbackReturnsFalse_ShouldStopAfterCommittedBatch()
+        {
+            File.WriteAllText(_importPath, string.Join("\n", Enumerable.Range(0, 100)));
+
+            var imported = _realm.SharedRealmHandle.ImportFile(nameof(PrimaryKeyInt64Object), _importPath, ImportOptions.Format.Csv,
+                                                               hasHeader: false, rowsPerTransaction: 10,
+                                                               onProgress: (rows, bytes, total) => false);
+
+            Assert.That(imported, Is.EqualTo(10));
+            Assert.That(_realm.All<PrimaryKeyInt64Object>().Count(), Is.EqualTo(10));
+        }
+
+        [Test]
+        public void ImportFile_WhenProgressCallbackThrows_ShouldStopAndRethrow()
+        {
+            File.WriteAllText(_importPath, string.Join("\n", Enumerable.Range(0, 100)));
+
+            Assert.That(() => _realm.SharedRealmHandle.ImportFile(nameof(PrimaryKeyInt64Object), _importPath, ImportOptions.Format.Csv,
+                                                                  hasHeader: false, rowsPerTransaction: 10,
+                                                                  onProgress: (rows, bytes, total) => { throw new InvalidOperationException(); }),
+                        Throws.TypeOf<AggregateException>().With.InnerException.TypeOf<InvalidOperationException>());
+            Assert.That(_realm.All<PrimaryKeyInt64Object>().Count(), Is.EqualTo(10));
+        }
+
+        [Test]
+        public void ImportFile_WhenValueIsMalformed_ShouldThrowAndRollBack()
+        {
+            File.WriteAllText(_importPath, "Int64Property\n1\n2\nthree\n");
+
+            Assert.That(() => _realm.SharedRealmHandle.ImportFile(nameof(PrimaryKeyInt64Object), _importPath, ImportOptions.Format.Csv),
+                        Throws.TypeOf<RealmException>());
+            Assert.That(_realm.All<PrimaryKeyInt64Object>().Count(), Is.EqualTo(0));
+        }
+
+        [Test]
+        public void ImportFile_WhenPrimaryKeyIsDuplicated_ShouldThrow()
+        {
+            File.WriteAllText(_importPath, "1\n2\n1\n");
+
+            Assert.That(() => _realm.SharedRealmHandle.ImportFile(nameof(PrimaryKeyInt64Object), _importPath, ImportOptions.Format.Csv, hasHeader: false),
+                        Throws.TypeOf<RealmDuplicatePrimaryKeyValueException>());
+        }
+    }
+}
@@ -20,8 +20,10 @@
 using System.Collections.Generic;
 using System.Diagnostics;
 using System.Diagnostics.CodeAnalysis;
+using System.Linq;
 using NUnit.Framework;
 using Realms;
+using Realms.Native;
 
 using ExplicitAttribute = NUnit.Framework.ExplicitAttribute;
 
@@ -92,6 +94,67 @@ public void BindingCreateObjectPerformanceTest(int totalRecs, int recsPerTrans)
             Console.WriteLine("Kilo-iterations per second: {0:0.00}", (numRecs / 1000) / sw.Elapsed.TotalSeconds);
         }
 
+        [TestCase(1000000, 100), Explicit]
+        public void BindingSetValuesPerformanceTest(int totalRecs, int recsPerTrans)
+        {
+            Console.WriteLine($"Binding-based performance check for {totalRecs:n} entries at {recsPerTrans} ops per transaction: SetValues -------------");
+
+            // Realm.Add collects the values copied by the woven CopyToRealm and applies them with one SetValues call.
+            var s = "String value";
+            var sw = Stopwatch.StartNew();
+            var numRecs = totalRecs / recsPerTrans;
+            for (var rowIndex = 0; rowIndex < numRecs; rowIndex++)
+            {
+                using (var trans = _realm.BeginWrite())
+                {
+                    var hangOntoObjectsUntilCommit = new List<RealmObject>();
+                    for (var iTrans = 0; iTrans < recsPerTrans; ++iTrans)
+                    {
+                        var p = _realm.Add(new Person { FirstName = s, IsInteresting = true });
+                        hangOntoObjectsUntilCommit.Add(p);
+                    }
+
+                    trans.Commit();
+                }
+            }
+
+            sw.Stop();
+
+            Console.WriteLine("Time spent: " + sw.Elapsed);
+            Console.WriteLine("Kilo-iterations per second: {0:0.00}", (numRecs / 1000) / sw.Elapsed.TotalSeconds);
+        }
+
+        [TestCase(1000000, 100000), Explicit]
+        public void BindingAddObjectsPerformanceTest(int totalRecs, int recsPerTrans)
+        {
+            Console.WriteLine($"Binding-based performance check for {totalRecs:n} entries at {recsPerTrans} ops per transaction: AddObjects -------------");
+
+            var metadata = _realm.Metadata[nameof(Person)];
+            var firstNames = Enumerable.Repeat("String value", recsPerTrans).ToArray();
+            var isInteresting = Enumerable.Repeat<bool?>(true, recsPerTrans).ToArray();
+            var columns = new[]
+            {
+                BulkColumn.ForString(metadata.PropertyIndices[nameof(Person.FirstName)], firstNames),
+                BulkColumn.ForBool(metadata.PropertyIndices[nameof(Person.IsInteresting)], isInteresting)
+            };
+
+            var sw = Stopwatch.StartNew();
+            var numRecs = totalRecs / recsPerTrans;
+            for (var rowIndex = 0; rowIndex < numRecs; rowIndex++)
+            {
+                using (var trans = _realm.BeginWrite())
+                {
+                    metadata.Table.AddObjects(_realm.SharedRealmHandle, columns);
+                    trans.Commit();
+                }
+            }
+
+            sw.Stop();
+
+            Console.WriteLine("Time spent: " + sw.Elapsed);
+            Console.WriteLine("Kilo-iterations per second: {0:0.00}", (totalRecs / 1000) / sw.Elapsed.TotalSeconds);
+        }
+
         [TestCase(1000000), Explicit]
         public void BindingSetValuePerformanceTest(int count)
         {
@@ -120,6 +183,170 @@ public void BindingSetValuePerformanceTest(int count)
             Console.WriteLine("Kilo-iterations per second: {0:0.00}", (count / 1000) / sw.Elapsed.TotalSeconds);
         }
 
+        [TestCase(1000000), Explicit]
+        public void StringMarshallingAllocationsTest(int count)
+        {
+            Console.WriteLine($"String marshalling allocations for {count:n} string writes and queries -------------");
+
+            NativeCommon.reset_scratch_allocation_counters();
+
+            var sw = Stopwatch.StartNew();
+            using (var trans = _realm.BeginWrite())
+            {
+                var p = _realm.Add(new Person());
+                for (var rowIndex = 0; rowIndex < count; rowIndex++)
+                {
+                    p.FirstName = "String value";
+                }
+
+                trans.Commit();
+            }
+
+            for (var rowIndex = 0; rowIndex < count / 100; rowIndex++)
+            {
+                Assert.That(_realm.All<Person>().Count(p => p.FirstName == "String value"), Is.EqualTo(1));
+            }
+
+            sw.Stop();
+
+            ulong arenaAllocations, heapAllocations;
+            NativeCommon.get_scratch_allocation_counters(out arenaAllocations, out heapAllocations);
+
+            Console.WriteLine("Time spent: " + sw.Elapsed);
+            Console.WriteLine($"Scratch arena allocations: {arenaAllocations:n0}, heap allocations: {heapAllocations:n0}");
+            Assert.That(heapAllocations, Is.LessThan(arenaAllocations));
+        }
+
+        [TestCase(1000000), Explicit]
+        public void HandlePoolStatisticsTest(int count)
+        {
+            Console.WriteLine($"Handle pools after enumerating {count:n} objects -------------");
+
+            _realm.Write(() =>
+            {
+                for (var rowIndex = 0; rowIndex < count; rowIndex++)
+                {
+                    _realm.Add(new MiniPerson { Name = "Name" + rowIndex });
+                }
+            });
+
+            NativeCommon.reset_handle_pool_peaks();
+
+            var sw = Stopwatch.StartNew();
+            var names = 0;
+            foreach (var person in _realm.All<MiniPerson>())
+            {
+                names += person.Name.Length;
+            }
+
+            sw.Stop();
+
+            var statistics = new HandlePoolStatistics[4];
+            NativeCommon.get_handle_pool_statistics(statistics);
+
+            Console.WriteLine("Time spent: " + sw.Elapsed);
+            var pools = new[] { "Object", "Results", "List", "Query" };
+            for (var i = 0; i < pools.Length; i++)
+            {
+                Console.WriteLine($"{pools[i]}: live {statistics[i].Live:n0}, peak {statistics[i].Peak:n0}, capacity {statistics[i].Capacity:n0}");
+                Assert.That(statistics[i].Capacity, Is.GreaterThanOrEqualTo(statistics[i].Peak));
+            }
+
+            Assert.That(names, Is.GreaterThan(0));
+        }
+
+        [TestCase(10000000, 1000000), Explicit]
+        public void Int64PrimaryKeyLookupPerformanceTest(int totalRecs, int lookups)
+        {
+            Console.WriteLine($"Primary key lookups in {totalRecs:n} objects: Int64 -------------");
+
+            var metadata = _realm.Metadata[nameof(PrimaryKeyInt64Object)];
+            var propertyIndex = metadata.PropertyIndices[nameof(PrimaryKeyInt64Object.Int64Property)];
+            const int RecsPerTrans = 1000000;
+            for (var first = 0; first < totalRecs; first += RecsPerTrans)
+            {
+                var keys = Enumerable.Range(first, RecsPerTrans).Select(i => (long)i).ToArray();
+                using (var trans = _realm.BeginWrite())
+                {
+                    metadata.Table.AddObjects(_realm.SharedRealmHandle, new[] { BulkColumn.ForInt64(propertyIndex, keys) });
+                    trans.Commit();
+                }
+            }
+
+            var random = new Random(42);
+            var sw = Stopwatch.StartNew();
+            Assert.That(_realm.Find<PrimaryKeyInt64Object>(0L), Is.Not.Null);
+            Console.WriteLine("First lookup: " + sw.Elapsed);
+
+            sw.Restart();
+            for (var i = 0; i < lookups; i++)
+            {
+                Assert.That(_realm.Find<PrimaryKeyInt64Object>((long)random.Next(totalRecs)), Is.Not.Null);
+            }
+
+            sw.Stop();
+            Console.WriteLine("Lookups: " + sw.Elapsed);
+            Console.WriteLine("Kilo-lookups per second: {0:0.00}", (lookups / 1000) / sw.Elapsed.TotalSeconds);
+
+            sw.Restart();
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < lookups; i++)
+                {
+                    _realm.Add(new PrimaryKeyInt64Object { Int64Property = totalRecs + i });
+                }
+            });
+            sw.Stop();
+            Console.WriteLine("Inserts with a unique check: " + sw.Elapsed);
+            Console.WriteLine("Kilo-inserts per second: {0:0.00}", (lookups / 1000) / sw.Elapsed.TotalSeconds);
+        }
+
+        [TestCase(10000000, 1000000), Explicit]
+        public void StringPrimaryKeyLookupPerformanceTest(int totalRecs, int lookups)
+        {
+            Console.WriteLine($"Primary key lookups in {totalRecs:n} objects: String -------------");
+
+            var metadata = _realm.Metadata[nameof(PrimaryKeyStringObject)];
+            var propertyIndex = metadata.PropertyIndices[nameof(PrimaryKeyStringObject.StringProperty)];
+            const int RecsPerTrans = 1000000;
+            for (var first = 0; first < totalRecs; first += RecsPerTrans)
+            {
+                var keys = Enumerable.Range(first, RecsPerTrans).Select(i => "Key" + i).ToArray();
+                using (var trans = _realm.BeginWrite())
+                {
+                    metadata.Table.AddObjects(_realm.SharedRealmHandle, new[] { BulkColumn.ForString(propertyIndex, keys) });
+                    trans.Commit();
+                }
+            }
+
+            var random = new Random(42);
+            var sw = Stopwatch.StartNew();
+            Assert.That(_realm.Find<PrimaryKeyStringObject>("Key0"), Is.Not.Null);
+            Console.WriteLine("First lookup: " + sw.Elapsed);
+
+            sw.Restart();
+            for (var i = 0; i < lookups; i++)
+            {
+                Assert.That(_realm.Find<PrimaryKeyStringObject>("Key" + random.Next(totalRecs)), Is.Not.Null);
+            }
+
+            sw.Stop();
+            Console.WriteLine("Lookups: " + sw.Elapsed);
+            Console.WriteLine("Kilo-lookups per second: {0:0.00}", (lookups / 1000) / sw.Elapsed.TotalSeconds);
+
+            sw.Restart();
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < lookups; i++)
+                {
+                    _realm.Add(new PrimaryKeyStringObject { StringProperty = "Key" + (totalRecs + i) });
+                }
+            });
+            sw.Stop();
+            Console.WriteLine("Inserts with a unique check: " + sw.Elapsed);
+            Console.WriteLine("Kilo-inserts per second: {0:0.00}", (lookups / 1000) / sw.Elapsed.TotalSeconds);
+        }
+
         [TestCase(100000), Explicit]
         public void ManageSmallObjectPerformanceTest(int count)
         {
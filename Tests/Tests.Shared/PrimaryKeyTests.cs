@@ -335,6 +335,63 @@ public void NullAndNotNullIntPKsWorkTogether()
             Assert.That(_realm.All<PrimaryKeyNullableInt64Object>().Count, Is.EqualTo(2));
         }
 
+        [Test]
+        public void FindAfterRemovingObjects()
+        {
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < 10; i++)
+                {
+                    _realm.Add(new PrimaryKeyInt64Object { Int64Property = i });
+                }
+            });
+
+            // Look one up first so that the lookups below go through an index built before the removals.
+            Assert.That(_realm.Find<PrimaryKeyInt64Object>(9), Is.Not.Null);
+
+            _realm.Write(() =>
+            {
+                // Removing moves the last object into the removed one's place.
+                _realm.Remove(_realm.Find<PrimaryKeyInt64Object>(2));
+                _realm.Remove(_realm.Find<PrimaryKeyInt64Object>(9));
+                _realm.Find<PrimaryKeyInt64Object>(5).Int64Property = 15;
+            });
+
+            Assert.That(_realm.Find<PrimaryKeyInt64Object>(2), Is.Null);
+            Assert.That(_realm.Find<PrimaryKeyInt64Object>(9), Is.Null);
+            Assert.That(_realm.Find<PrimaryKeyInt64Object>(5), Is.Null);
+            Assert.That(_realm.Find<PrimaryKeyInt64Object>(15).Int64Property, Is.EqualTo(15));
+            foreach (var key in new long[] { 0, 1, 3, 4, 6, 7, 8 })
+            {
+                Assert.That(_realm.Find<PrimaryKeyInt64Object>(key).Int64Property, Is.EqualTo(key));
+            }
+
+            Assert.That(() => _realm.Write(() => _realm.Add(new PrimaryKeyInt64Object { Int64Property = 15 })),
+                        Throws.TypeOf<RealmDuplicatePrimaryKeyValueException>());
+            _realm.Write(() => _realm.Add(new PrimaryKeyInt64Object { Int64Property = 5 }));
+            Assert.That(_realm.Find<PrimaryKeyInt64Object>(5), Is.Not.Null);
+        }
+
+        [Test]
+        public void FindAfterRollingBack()
+        {
+            _realm.Write(() => _realm.Add(new PrimaryKeyStringObject { StringProperty = "a" }));
+            Assert.That(_realm.Find<PrimaryKeyStringObject>("a"), Is.Not.Null);
+
+            using (var transaction = _realm.BeginWrite())
+            {
+                _realm.Find<PrimaryKeyStringObject>("a").StringProperty = "b";
+                _realm.Add(new PrimaryKeyStringObject { StringProperty = "c" });
+                Assert.That(_realm.Find<PrimaryKeyStringObject>("a"), Is.Null);
+                Assert.That(_realm.Find<PrimaryKeyStringObject>("b"), Is.Not.Null);
+                transaction.Rollback();
+            }
+
+            Assert.That(_realm.Find<PrimaryKeyStringObject>("a"), Is.Not.Null);
+            Assert.That(_realm.Find<PrimaryKeyStringObject>("b"), Is.Null);
+            Assert.That(_realm.Find<PrimaryKeyStringObject>("c"), Is.Null);
+        }
+
         [Test]
         public void PrimaryKeyFailsIfClassNotinRealm()
         {
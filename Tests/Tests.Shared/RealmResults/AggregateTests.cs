@@ -0,0 +1,172 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Linq;
+using NUnit.Framework;
+using Realms;
+using Realms.Native;
+
+namespace Tests.Database
+{
+    [TestFixture, Preserve(AllMembers = true)]
+    public class AggregateTests : RealmInstanceTest
+    {
+        private static readonly DateTimeOffset BaseDate = new DateTimeOffset(2017, 5, 1, 0, 0, 0, TimeSpan.Zero);
+
+        protected override void CustomSetUp()
+        {
+            base.CustomSetUp();
+
+            _realm.Write(() =>
+            {
+                for (var i = 1; i <= 4; i++)
+                {
+                    _realm.Add(new AllTypesObject
+                    {
+                        Int32Property = i,
+                        Int64Property = i * 10,
+                        SingleProperty = i * 0.5f,
+                        DoubleProperty = i * 1.5,
+                        DateTimeOffsetProperty = BaseDate.AddDays(i),
+                        NullableInt32Property = i % 2 == 0 ? (int?)i : null,
+                        NullableDoubleProperty = i == 4 ? (double?)null : i,
+                        RequiredStringProperty = string.Empty
+                    });
+                }
+            });
+        }
+
+        [Test]
+        public void Sum_ShouldUseColumnAggregate()
+        {
+            var all = _realm.All<AllTypesObject>();
+
+            Assert.That(all.Sum(o => o.Int32Property), Is.EqualTo(10));
+            Assert.That(all.Sum(o => o.Int64Property), Is.EqualTo(100L));
+            Assert.That(all.Sum(o => o.SingleProperty), Is.EqualTo(5f));
+            Assert.That(all.Sum(o => o.DoubleProperty), Is.EqualTo(15.0));
+            Assert.That(all.Where(o => o.Int32Property > 2).Sum(o => o.Int64Property), Is.EqualTo(70L));
+        }
+
+        [Test]
+        public void MinMax_ShouldUseColumnAggregate()
+        {
+            var all = _realm.All<AllTypesObject>();
+
+            Assert.That(all.Min(o => o.Int32Property), Is.EqualTo(1));
+            Assert.That(all.Max(o => o.Int64Property), Is.EqualTo(40L));
+            Assert.That(all.Min(o => o.SingleProperty), Is.EqualTo(0.5f));
+            Assert.That(all.Max(o => o.DoubleProperty), Is.EqualTo(6.0));
+            Assert.That(all.Min(o => o.DateTimeOffsetProperty), Is.EqualTo(BaseDate.AddDays(1)));
+            Assert.That(all.Max(o => o.DateTimeOffsetProperty), Is.EqualTo(BaseDate.AddDays(4)));
+        }
+
+        [Test]
+        public void Average_ShouldUseColumnAggregate()
+        {
+            var all = _realm.All<AllTypesObject>();
+
+            Assert.That(all.Average(o => o.Int32Property), Is.EqualTo(2.5));
+            Assert.That(all.Average(o => o.SingleProperty), Is.EqualTo(1.25f));
+            Assert.That(all.Where(o => o.Int32Property < 3).Average(o => o.DoubleProperty), Is.EqualTo(2.25));
+        }
+
+        [Test]
+        public void Aggregates_ShouldIgnoreNulls()
+        {
+            var all = _realm.All<AllTypesObject>();
+
+            Assert.That(all.Sum(o => o.NullableInt32Property), Is.EqualTo(6));
+            Assert.That(all.Min(o => o.NullableInt32Property), Is.EqualTo(2));
+            Assert.That(all.Average(o => o.NullableInt32Property), Is.EqualTo(3.0));
+            Assert.That(all.Max(o => o.NullableDoubleProperty), Is.EqualTo(3.0));
+            Assert.That(all.Average(o => o.NullableDoubleProperty), Is.EqualTo(2.0));
+        }
+
+        [Test]
+        public void Aggregates_WhenThereAreNoValues_ShouldFollowLinqToObjects()
+        {
+            var none = _realm.All<AllTypesObject>().Where(o => o.Int32Property > 10);
+
+            Assert.That(none.Sum(o => o.Int32Property), Is.EqualTo(0));
+            Assert.That(none.Sum(o => o.NullableInt32Property), Is.EqualTo(0));
+            Assert.That(none.Max(o => o.NullableInt32Property), Is.Null);
+            Assert.That(none.Average(o => o.NullableDoubleProperty), Is.Null);
+            Assert.That(() => none.Min(o => o.Int32Property), Throws.TypeOf<InvalidOperationException>());
+            Assert.That(() => none.Average(o => o.DoubleProperty), Throws.TypeOf<InvalidOperationException>());
+
+            var onlyNulls = _realm.All<AllTypesObject>().Where(o => o.Int32Property == 1);
+            Assert.That(onlyNulls.Min(o => o.NullableInt32Property), Is.Null);
+        }
+
+        [Test]
+        public void Aggregates_WhenPropertyIsNotNumeric_ShouldThrow()
+        {
+            Assert.That(() => _realm.All<AllTypesObject>().Max(o => o.StringProperty), Throws.TypeOf<NotSupportedException>());
+        }
+
+        [Test]
+        public void ResultsAndListHandles_ShouldAggregate()
+        {
+            var container = new ContainerObject();
+            _realm.Write(() =>
+            {
+                _realm.Add(container);
+                for (var i = 1; i <= 3; i++)
+                {
+                    container.Items.Add(new IntPropertyObject { Int = i * 100 });
+                }
+            });
+
+            var propertyIndex = _realm.Metadata[nameof(IntPropertyObject)].PropertyIndices[nameof(IntPropertyObject.Int)];
+
+            var listHandle = (ListHandle)((RealmList<IntPropertyObject>)container.Items).Handle.Value;
+            Assert.That(listHandle.Aggregate(propertyIndex, AggregateType.Sum).int_value, Is.EqualTo(600));
+
+            var resultsHandle = ((RealmResults<IntPropertyObject>)_realm.All<IntPropertyObject>()).ResultsHandle;
+            var max = resultsHandle.Aggregate(propertyIndex, AggregateType.Max);
+            Assert.That(max.HasValue, Is.True);
+            Assert.That(max.int_value, Is.EqualTo(300));
+            Assert.That(resultsHandle.Aggregate(propertyIndex, AggregateType.Average).double_value, Is.EqualTo(200.0));
+        }
+
+        [Test]
+        public void Aggregate_WhenPropertyIsMapped_ShouldUseMappedColumn()
+        {
+            _realm.Write(() =>
+            {
+                for (var i = 1; i <= 3; i++)
+                {
+                    _realm.Add(new MappedScoreObject { Score = i * 10 });
+                }
+            });
+
+            var all = _realm.All<MappedScoreObject>();
+            Assert.That(all.Sum(o => o.Score), Is.EqualTo(60));
+            Assert.That(all.Max(o => o.Score), Is.EqualTo(30));
+            Assert.That(all.Where(o => o.Score > 10).Average(o => o.Score), Is.EqualTo(25.0));
+        }
+
+        private class MappedScoreObject : RealmObject
+        {
+            [MapTo("points")]
+            public int Score { get; set; }
+        }
+    }
+}
@@ -0,0 +1,123 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Linq;
+using NUnit.Framework;
+using Realms;
+
+namespace Tests.Database
+{
+    [TestFixture, Preserve(AllMembers = true)]
+    public class DistinctTests : RealmInstanceTest
+    {
+        protected override void CustomSetUp()
+        {
+            base.CustomSetUp();
+
+            _realm.Write(() =>
+            {
+                _realm.Add(new Dog { Name = "Rex", Color = "Black", Vaccinated = true });
+                _realm.Add(new Dog { Name = "Fido", Color = "Brown", Vaccinated = false });
+                _realm.Add(new Dog { Name = "Bella", Color = "Black", Vaccinated = false });
+                _realm.Add(new Dog { Name = "Max", Color = "White", Vaccinated = true });
+                _realm.Add(new Dog { Name = "Luna", Color = "Brown", Vaccinated = false });
+                _realm.Add(new Dog { Name = "Spot", Color = null, Vaccinated = true });
+
+                for (var i = 0; i < 10; i++)
+                {
+                    _realm.Add(new AllTypesObject
+                    {
+                        RequiredStringProperty = string.Empty,
+                        Int32Property = i % 3,
+                        NullableDoubleProperty = i % 4 == 0 ? (double?)null : i % 2,
+                        DateTimeOffsetProperty = new DateTimeOffset(2017, 1, 1 + (i % 2), 0, 0, 0, TimeSpan.Zero),
+                    });
+                }
+            });
+        }
+
+        [Test]
+        public void Distinct_ShouldKeepFirstObjectInSortOrder()
+        {
+            var dogs = (RealmResults<Dog>)_realm.All<Dog>().OrderBy(d => d.Name);
+            var distinct = dogs.Distinct(nameof(Dog.Color));
+
+            Assert.That(distinct.Count(), Is.EqualTo(4));
+            Assert.That(distinct.ToArray().Select(d => d.Name), Is.EqualTo(new[] { "Bella", "Fido", "Max", "Spot" }));
+        }
+
+        [Test]
+        public void Distinct_WithSeveralProperties_ShouldUseCombinedValues()
+        {
+            var dogs = (RealmResults<Dog>)_realm.All<Dog>().Where(d => d.Name != "Spot");
+
+            Assert.That(dogs.Distinct(nameof(Dog.Color), nameof(Dog.Vaccinated)).Count(), Is.EqualTo(4));
+            Assert.That(dogs.Distinct(nameof(Dog.Vaccinated)).Count(), Is.EqualTo(2));
+        }
+
+        [Test]
+        public void Distinct_WhenWindowed_ShouldThrow()
+        {
+            var dogs = (RealmResults<Dog>)_realm.All<Dog>().OrderBy(d => d.Name).Take(2);
+
+            Assert.That(() => dogs.Distinct(nameof(Dog.Color)), Throws.TypeOf<NotSupportedException>());
+        }
+
+        [Test]
+        public void GetDistinctValues_ShouldReturnSortedValuesWithNullFirst()
+        {
+            var dogs = (RealmResults<Dog>)_realm.All<Dog>();
+            Assert.That(dogs.GetDistinctValues(nameof(Dog.Color)), Is.EqualTo(new object[] { null, "Black", "Brown", "White" }));
+            Assert.That(dogs.GetDistinctValues(nameof(Dog.Vaccinated)), Is.EqualTo(new object[] { false, true }));
+
+            var vaccinated = (RealmResults<Dog>)_realm.All<Dog>().Where(d => d.Vaccinated);
+            Assert.That(vaccinated.GetDistinctValues(nameof(Dog.Color)), Is.EqualTo(new object[] { null, "Black", "White" }));
+        }
+
+        [Test]
+        public void GetDistinctValues_ShouldSupportNumbersAndDates()
+        {
+            var objects = (RealmResults<AllTypesObject>)_realm.All<AllTypesObject>();
+
+            Assert.That(objects.GetDistinctValues(nameof(AllTypesObject.Int32Property)), Is.EqualTo(new object[] { 0L, 1L, 2L }));
+            Assert.That(objects.GetDistinctValues(nameof(AllTypesObject.NullableDoubleProperty)), Is.EqualTo(new object[] { null, 0.0, 1.0 }));
+            Assert.That(objects.GetDistinctValues(nameof(AllTypesObject.DateTimeOffsetProperty)), Is.EqualTo(new object[]
+            {
+                new DateTimeOffset(2017, 1, 1, 0, 0, 0, TimeSpan.Zero),
+                new DateTimeOffset(2017, 1, 2, 0, 0, 0, TimeSpan.Zero)
+            }));
+        }
+
+        [Test]
+        public void GetDistinctValues_WhenMoreValuesThanTheInitialBuffer_ShouldGrowIt()
+        {
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < 500; i++)
+                {
+                    _realm.Add(new Dog { Name = "Dog" + i, Color = new string('x', i % 200 + 1) });
+                }
+            });
+
+            var colors = ((RealmResults<Dog>)_realm.All<Dog>().Where(d => d.Name.StartsWith("Dog"))).GetDistinctValues(nameof(Dog.Color));
+            Assert.That(colors.Length, Is.EqualTo(200));
+            Assert.That(colors.Cast<string>().Select(c => c.Length), Is.EqualTo(Enumerable.Range(1, 200)));
+        }
+    }
+}
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using NUnit.Framework;
+using Realms;
+using Realms.Exceptions;
+
+namespace Tests.Database
+{
+    [TestFixture, Preserve(AllMembers = true)]
+    public class KeysetPaginationTests : SortKeyTestsBase
+    {
+        protected override void CustomSetUp()
+        {
+            base.CustomSetUp();
+            AddObjects(100, 7);
+        }
+
+        [Test]
+        public void GetPage_ShouldVisitEveryObjectOnceInSortOrder()
+        {
+            var query = _realm.All<AllTypesObject>().OrderBy(o => o.Int32Property).ThenByDescending(o => o.Int64Property);
+            var expected = _objects.OrderBy(o => o.Int32Property).ThenByDescending(o => o.Int64Property);
+
+            Assert.That(ReadAllPages(query, 7), Is.EqualTo(Ids(expected)));
+        }
+
+        [Test]
+        public void GetPage_WhenSortingOnNullableBoolAndDate_ShouldMatchFullSort()
+        {
+            var byNullable = _realm.All<AllTypesObject>().OrderByDescending(o => o.NullableInt32Property).ThenBy(o => o.Int64Property);
+            Assert.That(ReadAllPages(byNullable, 9), Is.EqualTo(Ids(_objects.OrderByDescending(o => o.NullableInt32Property).ThenBy(o => o.Int64Property))));
+
+            var byBool = _realm.All<AllTypesObject>().OrderByDescending(o => o.BooleanProperty).ThenBy(o => o.DateTimeOffsetProperty).ThenBy(o => o.Int64Property);
+            Assert.That(ReadAllPages(byBool, 11), Is.EqualTo(Ids(_objects.OrderByDescending(o => o.BooleanProperty).ThenBy(o => o.DateTimeOffsetProperty).ThenBy(o => o.Int64Property))));
+        }
+
+        [Test]
+        public void GetPage_ShouldNotShiftWhenEarlierObjectsAreAdded()
+        {
+            var query = (RealmResults<AllTypesObject>)_realm.All<AllTypesObject>().OrderBy(o => o.Int64Property);
+            byte[] cursor;
+            var first = query.GetPage(10, null, out cursor);
+            Assert.That(Ids(first), Is.EqualTo(Enumerable.Range(0, 10)));
+
+            _realm.Write(() => _realm.Add(new AllTypesObject { RequiredStringProperty = string.Empty, Int64Property = -1 }));
+
+            var second = query.GetPage(10, cursor, out cursor);
+            Assert.That(Ids(second), Is.EqualTo(Enumerable.Range(10, 10)));
+        }
+
+        [Test]
+        public void GetPage_WhenPastTheEnd_ShouldReturnNoCursor()
+        {
+            var query = (RealmResults<AllTypesObject>)_realm.All<AllTypesObject>().Where(o => o.Int64Property >= 95).OrderBy(o => o.Int64Property);
+            byte[] cursor;
+            Assert.That(query.GetPage(10, null, out cursor).Count(), Is.EqualTo(5));
+            Assert.That(cursor, Is.Not.Null);
+
+            Assert.That(query.GetPage(10, cursor, out cursor).Count(), Is.EqualTo(0));
+            Assert.That(cursor, Is.Null);
+        }
+
+        [Test]
+        public void GetPage_WhenCursorIsForAnotherSortOrder_ShouldThrow()
+        {
+            byte[] cursor;
+            ((RealmResults<AllTypesObject>)_realm.All<AllTypesObject>().OrderBy(o => o.Int64Property)).GetPage(10, null, out cursor);
+
+            var other = (RealmResults<AllTypesObject>)_realm.All<AllTypesObject>().OrderBy(o => o.DoubleProperty).ThenBy(o => o.Int64Property);
+            Assert.That(() => other.GetPage(10, cursor, out cursor), Throws.TypeOf<RealmException>());
+
+            var unsorted = (RealmResults<AllTypesObject>)_realm.All<AllTypesObject>().Where(o => o.Int32Property > 1);
+            Assert.That(() => unsorted.GetPage(10, null, out cursor), Throws.TypeOf<NotSupportedException>());
+        }
+
+        private static long[] ReadAllPages(IQueryable<AllTypesObject> query, int pageSize)
+        {
+            var results = (RealmResults<AllTypesObject>)query;
+            var ids = new List<long>();
+            byte[] cursor = null;
+            do
+            {
+                var page = results.GetPage(pageSize, cursor, out cursor).ToArray();
+                Assert.That(page.Length, Is.LessThanOrEqualTo(pageSize));
+                ids.AddRange(Ids(page));
+            }
+            while (cursor != null);
+
+            return ids.ToArray();
+        }
+    }
+}
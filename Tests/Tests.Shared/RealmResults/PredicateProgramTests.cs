@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Linq;
+using NUnit.Framework;
+using Realms;
+using Realms.Exceptions;
+
+namespace Tests.Database
+{
+    [TestFixture, Preserve(AllMembers = true)]
+    public class PredicateProgramTests : RealmInstanceTest
+    {
+        private Person[] _people;
+
+        protected override void CustomSetUp()
+        {
+            base.CustomSetUp();
+
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < 20; i++)
+                {
+                    _realm.Add(new Person
+                    {
+                        FirstName = i % 3 == 0 ? "John" : "Peter",
+                        LastName = i % 2 == 0 ? "Smith" : "Jameson",
+                        Score = i * 1.5f,
+                        Latitude = i,
+                        Salary = i * 1000,
+                        IsInteresting = i % 4 == 0,
+                        Birthday = new DateTimeOffset(2000 + i, 1, 1, 0, 0, 0, TimeSpan.Zero),
+                        PublicCertificateBytes = i % 5 == 0 ? new byte[] { 0xca, 0xfe } : new byte[0],
+                        OptionalAddress = i % 6 == 0 ? null : "Street " + i,
+                    });
+                }
+
+                var owner = _realm.Add(new Owner { Name = "Tim" });
+                owner.TopDog = _realm.Add(new Dog { Name = "Rex", Color = "Black" });
+                _realm.Add(new Owner { Name = "Dani", TopDog = _realm.Add(new Dog { Name = "Fido", Color = null }) });
+                _realm.Add(new Owner { Name = "Jim" });
+            });
+
+            _people = _realm.All<Person>().ToArray();
+        }
+
+        [Test]
+        public void CompoundPredicate_ShouldMatchLinqToObjects()
+        {
+            var since = new DateTimeOffset(2005, 1, 1, 0, 0, 0, TimeSpan.Zero);
+            var query = _realm.All<Person>().Where(p => (p.FirstName == "John" || p.LastName.StartsWith("Jam")) &&
+                                                        !(p.Salary > 15000) &&
+                                                        p.Birthday >= since &&
+                                                        p.OptionalAddress != null);
+            var expected = _people.Where(p => (p.FirstName == "John" || p.LastName.StartsWith("Jam")) &&
+                                              !(p.Salary > 15000) &&
+                                              p.Birthday >= since &&
+                                              p.OptionalAddress != null);
+
+            Assert.That(query.ToArray().Select(p => p.Salary), Is.EqualTo(expected.Select(p => p.Salary)));
+            Assert.That(query.Count(), Is.EqualTo(expected.Count()));
+        }
+
+        [Test]
+        public void NumericAndStringOperators_ShouldMatchLinqToObjects()
+        {
+            var query = _realm.All<Person>().Where(p => p.Score < 20 && p.Latitude != 3 && p.IsInteresting == false &&
+                                                        p.OptionalAddress.Contains("1") && !p.LastName.EndsWith("son"));
+            var expected = _people.Where(p => p.Score < 20 && p.Latitude != 3 && p.IsInteresting == false &&
+                                              p.OptionalAddress != null && p.OptionalAddress.Contains("1") && !p.LastName.EndsWith("son"));
+
+            Assert.That(query.ToArray().Select(p => p.Salary), Is.EqualTo(expected.Select(p => p.Salary)));
+        }
+
+        [Test]
+        public void BinaryPredicates_ShouldMatchLinqToObjects()
+        {
+            var empty = new byte[0];
+            var bytes = new byte[] { 0xca, 0xfe };
+
+            Assert.That(_realm.All<Person>().Count(p => p.PublicCertificateBytes == bytes), Is.EqualTo(4));
+            Assert.That(_realm.All<Person>().Count(p => p.PublicCertificateBytes == empty), Is.EqualTo(16));
+            Assert.That(_realm.All<Person>().Count(p => p.PublicCertificateBytes != bytes && p.Salary < 10000), Is.EqualTo(8));
+        }
+
+        [Test]
+        public void PredicateFollowedByFirst_ShouldApplyAllConditions()
+        {
+            var person = _realm.All<Person>().Where(p => p.FirstName == "Peter").First(p => p.Salary > 10000);
+
+            Assert.That(person.Salary, Is.EqualTo(11000));
+        }
+
+        [Test]
+        public void LinkQuery_ShouldCompareThroughLinks()
+        {
+            var blackDogOwners = _realm.All<Owner>().AddLinkQuery(o => o.TopDog.Color, PredicateOperator.Equal, "Black");
+            var colorlessDogOwners = _realm.All<Owner>().Where(o => o.Name != "Jim").AddLinkQuery(o => o.TopDog.Color, PredicateOperator.Equal, (string)null);
+
+            Assert.That(blackDogOwners.ToArray().Select(o => o.Name), Is.EqualTo(new[] { "Tim" }));
+            Assert.That(colorlessDogOwners.ToArray().Select(o => o.Name), Is.EqualTo(new[] { "Dani" }));
+        }
+
+        [Test]
+        public void LinkQuery_WithInvalidOperatorForType_ShouldThrow()
+        {
+            var owners = _realm.All<Owner>().AddLinkQuery(o => o.TopDog.Color, PredicateOperator.Less, "Black");
+
+            Assert.That(() => owners.ToArray(), Throws.TypeOf<RealmException>());
+        }
+    }
+}
@@ -0,0 +1,161 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Linq;
+using System.Threading.Tasks;
+using NUnit.Framework;
+using Realms;
+
+namespace Tests.Database
+{
+    [TestFixture, Preserve(AllMembers = true)]
+    public class PreparedQueryTests : RealmInstanceTest
+    {
+        private Person[] _people;
+
+        protected override void CustomSetUp()
+        {
+            base.CustomSetUp();
+
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < 20; i++)
+                {
+                    _realm.Add(new Person
+                    {
+                        FirstName = i % 3 == 0 ? "John" : "Peter",
+                        LastName = "Smith " + i,
+                        Salary = i * 1000,
+                        Score = i,
+                        Birthday = new DateTimeOffset(2000 + i, 1, 1, 0, 0, 0, TimeSpan.Zero),
+                        OptionalAddress = i % 4 == 0 ? null : "Street " + (i % 4),
+                    });
+                }
+            });
+
+            _people = _realm.All<Person>().ToArray();
+        }
+
+        [Test]
+        public void PreparedQuery_ShouldMatchLinqForEveryBinding()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>();
+            using (var query = people.Prepare((Person p, string name, long salary) => p.FirstName == name && p.Salary >= salary))
+            {
+                foreach (var name in new[] { "John", "Peter", "Nobody" })
+                {
+                    for (var salary = 0; salary <= 20000; salary += 5000)
+                    {
+                        query.Bind(0, name);
+                        query.Bind(1, salary);
+
+                        var expected = _people.Where(p => p.FirstName == name && p.Salary >= salary).ToArray();
+                        Assert.That(query.Count(), Is.EqualTo(expected.Length));
+                        Assert.That(query.Execute().ToArray().Select(p => p.Salary), Is.EqualTo(expected.Select(p => p.Salary)));
+                        Assert.That(query.Find()?.Salary, Is.EqualTo(expected.FirstOrDefault()?.Salary));
+                    }
+                }
+            }
+        }
+
+        [Test]
+        public void PreparedQuery_ShouldKeepConditionsOfTheSource()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>().Where(p => p.FirstName == "Peter");
+            using (var query = people.Prepare((Person p, DateTimeOffset since) => p.Birthday >= since || p.Score < 2f))
+            {
+                query.Bind(0, new DateTimeOffset(2015, 1, 1, 0, 0, 0, TimeSpan.Zero));
+
+                Assert.That(query.Execute().ToArray().Select(p => p.Salary), Is.EqualTo(new long[] { 1000, 16000, 17000, 19000 }));
+            }
+        }
+
+        [Test]
+        public void PreparedQuery_WithStringMethodsAndNull_ShouldBindThem()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>();
+            using (var query = people.Prepare((Person p, string address, string lastName) => p.OptionalAddress == address && p.LastName.StartsWith(lastName)))
+            {
+                query.BindNull(0);
+                query.Bind(1, "Smith 1");
+                Assert.That(query.Execute().ToArray().Select(p => p.Salary), Is.EqualTo(new long[] { 12000, 16000 }));
+
+                query.Bind(0, "Street 1");
+                Assert.That(query.Execute().ToArray().Select(p => p.Salary), Is.EqualTo(new long[] { 1000, 13000, 17000 }));
+            }
+        }
+
+        [Test]
+        public void PreparedQuery_ResultsCanBeSorted()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>();
+            using (var query = people.Prepare((Person p, float score) => p.Score < score))
+            {
+                query.Bind(0, 3f);
+
+                Assert.That(query.Execute().OrderByDescending(p => p.Score).ToArray().Select(p => p.Score), Is.EqualTo(new[] { 2f, 1f, 0f }));
+            }
+        }
+
+        [Test]
+        public void PreparedQuery_WhenNotBound_ShouldThrow()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>();
+            using (var query = people.Prepare((Person p, string name, long salary) => p.FirstName == name && p.Salary >= salary))
+            {
+                query.Bind(0, "John");
+
+                Assert.That(() => query.Count(), Throws.TypeOf<InvalidOperationException>());
+            }
+        }
+
+        [Test]
+        public void PreparedQuery_WithMismatchedBinding_ShouldThrow()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>();
+            using (var query = people.Prepare((Person p, long salary) => p.Salary == salary))
+            {
+                Assert.That(() => query.Bind(0, "1000"), Throws.TypeOf<ArgumentException>());
+                Assert.That(() => query.BindNull(0), Throws.TypeOf<ArgumentException>());
+                Assert.That(() => query.Bind(1, 1000), Throws.TypeOf<ArgumentOutOfRangeException>());
+            }
+        }
+
+        [Test]
+        public void PreparedQuery_CountFromAnotherThread_ShouldThrow()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>();
+            using (var query = people.Prepare((Person p, long salary) => p.Salary >= salary))
+            {
+                query.Bind(0, 5000);
+
+                Assert.That(() => Task.Run(() => query.Count()).Wait(),
+                            Throws.TypeOf<AggregateException>().With.InnerException.InstanceOf<RealmException>());
+            }
+        }
+
+        [Test]
+        public void Prepare_WhenSorted_ShouldThrow()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>().OrderBy(p => p.Salary);
+
+            Assert.That(() => people.Prepare((Person p, long salary) => p.Salary == salary), Throws.TypeOf<NotSupportedException>());
+        }
+    }
+}
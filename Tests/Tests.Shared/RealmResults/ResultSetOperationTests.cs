@@ -0,0 +1,166 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Linq;
+using System.Linq.Expressions;
+using NUnit.Framework;
+using Realms;
+using Realms.Native;
+
+namespace Tests.Database
+{
+    [TestFixture, Preserve(AllMembers = true)]
+    public class ResultSetOperationTests : RealmInstanceTest
+    {
+        // Enough objects to span several bitmap containers, with dense ranges that become bitsets.
+        private const int ObjectCount = 150000;
+
+        protected override void CustomSetUp()
+        {
+            base.CustomSetUp();
+
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < ObjectCount; i++)
+                {
+                    _realm.Add(new IntPropertyObject { Int = i });
+                }
+            });
+        }
+
+        [TestCase(nameof(RowSetOperation.Union))]
+        [TestCase(nameof(RowSetOperation.Intersection))]
+        [TestCase(nameof(RowSetOperation.Difference))]
+        public void Combine_DenseResults_ShouldMatchLinq(string operation)
+        {
+            AssertCombined(o => o.Int < 100000, o => o.Int >= 60000, ParseOperation(operation));
+        }
+
+        [TestCase(nameof(RowSetOperation.Union))]
+        [TestCase(nameof(RowSetOperation.Intersection))]
+        [TestCase(nameof(RowSetOperation.Difference))]
+        public void Combine_SparseAndDenseResults_ShouldMatchLinq(string operation)
+        {
+            AssertCombined(o => o.Int > 140000 || o.Int < 10, o => o.Int >= 5 && o.Int < 145000, ParseOperation(operation));
+            AssertCombined(o => o.Int >= 5 && o.Int < 145000, o => o.Int > 140000 || o.Int < 10, ParseOperation(operation));
+        }
+
+        [Test]
+        public void Combine_WithSortedResults_ShouldReturnTableOrder()
+        {
+            var lhs = (RealmResults<IntPropertyObject>)_realm.All<IntPropertyObject>().Where(o => o.Int < 10).OrderByDescending(o => o.Int);
+            var rhs = (RealmResults<IntPropertyObject>)_realm.All<IntPropertyObject>().Where(o => o.Int > 5);
+
+            var combined = lhs.Combine(rhs, RowSetOperation.Intersection);
+
+            Assert.That(combined.ToArray().Select(o => o.Int), Is.EqualTo(new[] { 6, 7, 8, 9 }));
+        }
+
+        [Test]
+        public void Combine_ShouldBeASnapshot()
+        {
+            var lhs = (RealmResults<IntPropertyObject>)_realm.All<IntPropertyObject>().Where(o => o.Int < 10);
+            var rhs = (RealmResults<IntPropertyObject>)_realm.All<IntPropertyObject>().Where(o => o.Int < 0);
+
+            var combined = lhs.Combine(rhs, RowSetOperation.Union);
+            _realm.Write(() => _realm.Add(new IntPropertyObject { Int = -1 }));
+
+            Assert.That(combined.Count(), Is.EqualTo(10));
+            Assert.That(lhs.CountCombined(rhs, RowSetOperation.Union), Is.EqualTo(11));
+        }
+
+        [Test]
+        public void Combine_WithList_ShouldUseTheObjectsOfTheList()
+        {
+            Owner owner = null;
+            _realm.Write(() =>
+            {
+                owner = _realm.Add(new Owner { Name = "Owner" });
+                foreach (var name in new[] { "Rex", "Fido", "Rex", "Spot" })
+                {
+                    owner.Dogs.Add(new Dog { Name = name, Vaccinated = name != "Fido" });
+                }
+
+                _realm.Add(new Dog { Name = "Stray", Vaccinated = true });
+            });
+
+            var dogs = (RealmCollectionBase<Dog>)owner.Dogs;
+            var vaccinated = (RealmResults<Dog>)_realm.All<Dog>().Where(d => d.Vaccinated);
+
+            Assert.That(vaccinated.Combine(dogs, RowSetOperation.Difference).ToArray().Select(d => d.Name), Is.EqualTo(new[] { "Stray" }));
+            Assert.That(dogs.Combine(vaccinated, RowSetOperation.Intersection).ToArray().Select(d => d.Name), Is.EqualTo(new[] { "Rex", "Rex", "Spot" }));
+            Assert.That(dogs.CountCombined(vaccinated, RowSetOperation.Union), Is.EqualTo(5));
+        }
+
+        [Test]
+        public void Combine_WithSkipOrTake_ShouldThrow()
+        {
+            var lhs = (RealmResults<IntPropertyObject>)_realm.All<IntPropertyObject>().OrderBy(o => o.Int).Take(10);
+            var rhs = (RealmResults<IntPropertyObject>)_realm.All<IntPropertyObject>();
+
+            Assert.That(() => lhs.Combine(rhs, RowSetOperation.Union), Throws.TypeOf<NotSupportedException>());
+        }
+
+        [Test]
+        public void Combine_ShouldBeSnapshotThatCantBeQueried()
+        {
+            var lhs = (RealmResults<IntPropertyObject>)_realm.All<IntPropertyObject>().Where(o => o.Int < 5);
+            var rhs = (RealmResults<IntPropertyObject>)_realm.All<IntPropertyObject>().Where(o => o.Int > 2);
+            var combined = lhs.Combine(rhs, RowSetOperation.Intersection);
+
+            _realm.Write(() => _realm.Remove(_realm.All<IntPropertyObject>().Single(o => o.Int == 0)));
+
+            Assert.That(combined.Count, Is.EqualTo(2));
+            Assert.That(combined.ToArray().Select(o => o.Int), Is.EquivalentTo(new[] { 3, 4 }));
+            Assert.That(() => combined.Where(o => o.Int > 3).ToArray(), Throws.TypeOf<NotSupportedException>());
+            Assert.That(() => ThreadSafeReference.Create((IQueryable<IntPropertyObject>)combined), Throws.TypeOf<NotSupportedException>());
+        }
+
+        // Test cases take the operation by name, as a public test method can't take an internal enum.
+        private static RowSetOperation ParseOperation(string operation)
+        {
+            return (RowSetOperation)Enum.Parse(typeof(RowSetOperation), operation);
+        }
+
+        private void AssertCombined(Expression<Func<IntPropertyObject, bool>> lhsFilter, Expression<Func<IntPropertyObject, bool>> rhsFilter, RowSetOperation operation)
+        {
+            var lhs = (RealmResults<IntPropertyObject>)_realm.All<IntPropertyObject>().Where(lhsFilter);
+            var rhs = (RealmResults<IntPropertyObject>)_realm.All<IntPropertyObject>().Where(rhsFilter);
+
+            var lhsMatches = lhsFilter.Compile();
+            var rhsMatches = rhsFilter.Compile();
+            var expected = Enumerable.Range(0, ObjectCount).Where(i =>
+            {
+                var o = new IntPropertyObject { Int = i };
+                switch (operation)
+                {
+                    case RowSetOperation.Union:
+                        return lhsMatches(o) || rhsMatches(o);
+                    case RowSetOperation.Intersection:
+                        return lhsMatches(o) && rhsMatches(o);
+                    default:
+                        return lhsMatches(o) && !rhsMatches(o);
+                }
+            }).ToArray();
+
+            Assert.That(lhs.CountCombined(rhs, operation), Is.EqualTo(expected.Length));
+            Assert.That(lhs.Combine(rhs, operation).ToArray().Select(o => o.Int), Is.EqualTo(expected));
+        }
+    }
+}
@@ -0,0 +1,130 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using NUnit.Framework;
+using Realms;
+
+namespace Tests.Database
+{
+    [TestFixture, Preserve(AllMembers = true)]
+    public class SetMembershipTests : RealmInstanceTest
+    {
+        private const int ObjectCount = 2000;
+
+        protected override void CustomSetUp()
+        {
+            base.CustomSetUp();
+
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < ObjectCount; i++)
+                {
+                    _realm.Add(new Person
+                    {
+                        FirstName = "Person " + i,
+                        Salary = i,
+                        OptionalAddress = i % 5 == 0 ? null : "Street " + (i % 5),
+                    });
+
+                    _realm.Add(new PrimaryKeyStringObject { StringProperty = "Key " + i });
+                    _realm.Add(new PrimaryKeyNullableInt64Object { Int64Property = i == 0 ? (long?)null : i });
+                }
+            });
+        }
+
+        [TestCase(0)]
+        [TestCase(3)]
+        [TestCase(200)]
+        [TestCase(5000)]
+        public void Contains_WithLongs_ShouldMatchTheListedValues(int count)
+        {
+            var ids = Enumerable.Range(0, count).Select(i => (long)i * 7).ToArray();
+
+            var salaries = _realm.All<Person>().Where(p => ids.Contains(p.Salary)).ToArray().Select(p => p.Salary);
+
+            Assert.That(salaries, Is.EqualTo(ids.Where(id => id < ObjectCount)));
+        }
+
+        [TestCase(5)]
+        [TestCase(100)]
+        [TestCase(1000)]
+        public void Contains_WithStrings_ShouldMatchTheListedValues(int count)
+        {
+            var names = new HashSet<string>(Enumerable.Range(0, count).Select(i => "Person " + (i * 3)));
+            names.Add("Nobody");
+
+            var salaries = _realm.All<Person>().Where(p => names.Contains(p.FirstName)).ToArray().Select(p => p.Salary);
+
+            Assert.That(salaries, Is.EqualTo(Enumerable.Range(0, count).Select(i => (long)i * 3).Where(s => s < ObjectCount)));
+        }
+
+        [TestCase(5)]
+        [TestCase(100)]
+        [TestCase(1000)]
+        public void Contains_OnIndexedProperty_ShouldMatchTheListedValues(int count)
+        {
+            var keys = Enumerable.Range(0, count).Select(i => "Key " + (i * 2)).ToList();
+
+            var found = _realm.All<PrimaryKeyStringObject>().Where(o => keys.Contains(o.StringProperty)).ToArray().Select(o => o.StringProperty);
+
+            Assert.That(found, Is.EquivalentTo(keys.Where(k => int.Parse(k.Substring(4)) < ObjectCount)));
+        }
+
+        [TestCase(4)]
+        [TestCase(1000)]
+        public void Contains_WithNull_ShouldMatchNullProperties(int count)
+        {
+            var ids = Enumerable.Range(1, count).Select(i => (long?)i).Concat(new long?[] { null }).ToList();
+
+            var found = _realm.All<PrimaryKeyNullableInt64Object>().Where(o => ids.Contains(o.Int64Property)).ToArray().Select(o => o.Int64Property);
+
+            Assert.That(found, Is.EquivalentTo(new long?[] { null }.Concat(Enumerable.Range(1, count).Select(i => (long?)i))));
+        }
+
+        [Test]
+        public void Contains_WithNullStrings_ShouldMatchNullProperties()
+        {
+            var addresses = new[] { null, "Street 1" };
+
+            var count = _realm.All<Person>().Count(p => addresses.Contains(p.OptionalAddress));
+
+            Assert.That(count, Is.EqualTo(ObjectCount * 2 / 5));
+        }
+
+        [Test]
+        public void Contains_ShouldCombineWithOtherConditions()
+        {
+            var ids = Enumerable.Range(0, 1000).Select(i => (long)i).ToList();
+
+            var query = _realm.All<Person>().Where(p => (p.Salary > 1500 || ids.Contains(p.Salary)) && !(p.OptionalAddress == null));
+
+            Assert.That(query.Count(), Is.EqualTo(_realm.All<Person>().ToArray().Count(p => (p.Salary > 1500 || p.Salary < 1000) && p.OptionalAddress != null)));
+        }
+
+        [Test]
+        public void Contains_OnUnsupportedProperty_ShouldThrow()
+        {
+            var scores = new[] { 1f, 2f };
+
+            Assert.That(() => _realm.All<Person>().Where(p => scores.Contains(p.Score)).ToArray(), Throws.TypeOf<NotSupportedException>());
+        }
+    }
+}
@@ -0,0 +1,111 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Linq;
+using NUnit.Framework;
+using Realms;
+
+namespace Tests.Database
+{
+    [TestFixture, Preserve(AllMembers = true)]
+    public class SkipTakeTests : RealmInstanceTest
+    {
+        protected override void CustomSetUp()
+        {
+            base.CustomSetUp();
+
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < 20; i++)
+                {
+                    _realm.Add(new IntPropertyObject { Int = i });
+                }
+            });
+        }
+
+        [Test]
+        public void SkipTake_WhenUnsorted_ShouldReturnWindow()
+        {
+            var window = _realm.All<IntPropertyObject>().Where(o => o.Int > 2).Skip(3).Take(4);
+
+            Assert.That(window.Count(), Is.EqualTo(4));
+            Assert.That(window.ToArray().Select(o => o.Int), Is.EqualTo(new[] { 6, 7, 8, 9 }));
+        }
+
+        [Test]
+        public void SkipTake_WhenUnsortedAndEarlierRowIsDeleted_ShouldKeepWindowByMatch()
+        {
+            var window = _realm.All<IntPropertyObject>().Where(o => o.Int > 2).Skip(3).Take(4);
+            Assert.That(window.ToArray().Select(o => o.Int), Is.EqualTo(new[] { 6, 7, 8, 9 }));
+
+            // Deleting moves the last row into the deleted row's slot, so 19 becomes the first match in table order.
+            _realm.Write(() => _realm.Remove(_realm.All<IntPropertyObject>().Single(o => o.Int == 1)));
+
+            Assert.That(window.Count(), Is.EqualTo(4));
+            Assert.That(window.ToArray().Select(o => o.Int), Is.EqualTo(new[] { 5, 6, 7, 8 }));
+        }
+
+        [Test]
+        public void SkipTake_WhenSorted_ShouldReturnWindowOfSortedResults()
+        {
+            var window = _realm.All<IntPropertyObject>().OrderByDescending(o => o.Int).Skip(5).Take(3);
+
+            Assert.That(window.Count(), Is.EqualTo(3));
+            Assert.That(window.ToArray().Select(o => o.Int), Is.EqualTo(new[] { 14, 13, 12 }));
+            Assert.That(window.First().Int, Is.EqualTo(14));
+            Assert.That(window.Last().Int, Is.EqualTo(12));
+            Assert.That(window.ElementAt(1).Int, Is.EqualTo(13));
+            Assert.That(window.ElementAtOrDefault(3), Is.Null);
+        }
+
+        [Test]
+        public void SkipTake_WhenWindowRunsPastEnd_ShouldBeClamped()
+        {
+            Assert.That(_realm.All<IntPropertyObject>().Where(o => o.Int >= 0).Skip(18).Take(5).ToArray().Select(o => o.Int), Is.EqualTo(new[] { 18, 19 }));
+            Assert.That(_realm.All<IntPropertyObject>().OrderBy(o => o.Int).Skip(18).Take(5).ToArray().Select(o => o.Int), Is.EqualTo(new[] { 18, 19 }));
+            Assert.That(_realm.All<IntPropertyObject>().Where(o => o.Int >= 0).Skip(25).Any(), Is.False);
+            Assert.That(_realm.All<IntPropertyObject>().OrderBy(o => o.Int).Skip(25).Count(), Is.EqualTo(0));
+            Assert.That(_realm.All<IntPropertyObject>().Where(o => o.Int >= 0).Take(0).Count(), Is.EqualTo(0));
+        }
+
+        [Test]
+        public void SkipTake_ShouldCompose()
+        {
+            var window = _realm.All<IntPropertyObject>().OrderBy(o => o.Int).Take(10).Skip(2).Take(5).Skip(1);
+
+            Assert.That(window.ToArray().Select(o => o.Int), Is.EqualTo(new[] { 3, 4, 5, 6 }));
+        }
+
+        [Test]
+        public void SkipTake_WhenFollowedByWhereOrOrderBy_ShouldThrow()
+        {
+            Assert.That(() => _realm.All<IntPropertyObject>().Skip(2).Where(o => o.Int > 5).ToArray(), Throws.TypeOf<NotSupportedException>());
+            Assert.That(() => _realm.All<IntPropertyObject>().Take(2).OrderBy(o => o.Int).ToArray(), Throws.TypeOf<NotSupportedException>());
+        }
+
+        [Test]
+        public void SkipTake_WhenSingle_ShouldCheckWindowOnly()
+        {
+            var single = _realm.All<IntPropertyObject>().OrderBy(o => o.Int).Skip(7).Take(1).Single();
+            Assert.That(single.Int, Is.EqualTo(7));
+
+            Assert.That(() => _realm.All<IntPropertyObject>().OrderBy(o => o.Int).Skip(7).Take(2).Single(), Throws.TypeOf<InvalidOperationException>());
+        }
+    }
+}
@@ -0,0 +1,60 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Collections.Generic;
+using System.Linq;
+using Realms;
+
+namespace Tests.Database
+{
+    // A fixture of AllTypesObjects with pseudo-random sort keys, for checking that sorting shortcuts agree with
+    // sorting every object in memory. Int64Property is unique and can be used as the last sort key.
+    public abstract class SortKeyTestsBase : RealmInstanceTest
+    {
+        protected AllTypesObject[] _objects;
+
+        protected void AddObjects(int count, int seed)
+        {
+            var random = new Random(seed);
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < count; i++)
+                {
+                    _realm.Add(new AllTypesObject
+                    {
+                        RequiredStringProperty = string.Empty,
+                        Int32Property = random.Next(10),
+                        Int64Property = i,
+                        DoubleProperty = random.Next(50) / 2.0,
+                        BooleanProperty = i % 3 == 0,
+                        NullableInt32Property = i % 7 == 0 ? (int?)null : random.Next(20),
+                        DateTimeOffsetProperty = new DateTimeOffset(2017, 1, 1, 0, 0, 0, TimeSpan.Zero).AddSeconds(random.Next(100)),
+                    });
+                }
+            });
+
+            _objects = _realm.All<AllTypesObject>().ToArray();
+        }
+
+        protected static long[] Ids(IEnumerable<AllTypesObject> objects)
+        {
+            return objects.Select(o => o.Int64Property).ToArray();
+        }
+    }
+}
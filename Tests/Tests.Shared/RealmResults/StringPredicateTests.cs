@@ -0,0 +1,128 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Linq;
+using NUnit.Framework;
+using Realms;
+using Realms.Exceptions;
+
+namespace Tests.Database
+{
+    [TestFixture, Preserve(AllMembers = true)]
+    public class StringPredicateTests : RealmInstanceTest
+    {
+        private Dog _rex;
+
+        protected override void CustomSetUp()
+        {
+            base.CustomSetUp();
+
+            _realm.Write(() =>
+            {
+                for (var i = 0; i < 10; i++)
+                {
+                    _realm.Add(new Person
+                    {
+                        FirstName = i % 2 == 0 ? "John" : "Jane",
+                        LastName = "Smith " + i,
+                        Salary = i * 1000,
+                        Score = i,
+                        Birthday = new DateTimeOffset(2000 + i, 1, 1, 0, 0, 0, TimeSpan.Zero),
+                    });
+                }
+
+                _rex = _realm.Add(new Dog { Name = "Rex", Color = "Black" });
+                _realm.Add(new Owner { Name = "Tim", TopDog = _rex });
+                _realm.Add(new Owner { Name = "Dani", TopDog = _realm.Add(new Dog { Name = "Fido" }) });
+            });
+        }
+
+        [Test]
+        public void Filter_ShouldBindArguments()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>();
+            var filtered = people.Filter("Salary > $0 AND FirstName BEGINSWITH $1", 3000, "Ja");
+
+            Assert.That(filtered.ToArray().Select(p => p.Salary), Is.EqualTo(new long[] { 5000, 7000, 9000 }));
+        }
+
+        [Test]
+        public void Filter_ShouldKeepConditionsAndSorting()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>().Where(p => p.FirstName == "John").OrderByDescending(p => p.Salary);
+            var since = new DateTimeOffset(2003, 1, 1, 0, 0, 0, TimeSpan.Zero);
+            var filtered = people.Filter("Birthday >= $0 OR Score == $1", since, 0f);
+
+            Assert.That(filtered.ToArray().Select(p => p.Salary), Is.EqualTo(new long[] { 8000, 6000, 4000, 0 }));
+        }
+
+        [Test]
+        public void Filter_WhenRepeatedWithOtherArguments_ShouldUseThem()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>();
+
+            for (var i = 0; i < 10; i++)
+            {
+                Assert.That(people.Filter("Salary < $0", i * 1000).Count(), Is.EqualTo(i));
+            }
+        }
+
+        [Test]
+        public void Filter_WithObjectArgument_ShouldCompareLinks()
+        {
+            var owners = (RealmResults<Owner>)_realm.All<Owner>();
+
+            Assert.That(owners.Filter("TopDog == $0", _rex).ToArray().Select(o => o.Name), Is.EqualTo(new[] { "Tim" }));
+            Assert.That(owners.Filter("TopDog.Color == $0", (string)null).ToArray().Select(o => o.Name), Is.EqualTo(new[] { "Dani" }));
+        }
+
+        [Test]
+        public void Filter_WithMissingArgument_ShouldThrow()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>();
+
+            Assert.That(() => people.Filter("Salary > $0 AND Score < $1", 1000), Throws.TypeOf<RealmException>());
+        }
+
+        [Test]
+        public void Filter_WithMismatchedArgument_ShouldThrow()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>();
+
+            Assert.That(() => people.Filter("Salary > $0", "1000"), Throws.TypeOf<RealmException>());
+        }
+
+        [Test]
+        public void Filter_WithInvalidPredicate_ShouldThrow()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>();
+
+            Assert.That(() => people.Filter("Salary >"), Throws.TypeOf<RealmException>());
+            Assert.That(() => people.Filter("NoSuchProperty == 1"), Throws.TypeOf<RealmException>());
+        }
+
+        [Test]
+        public void Filter_WithUnsupportedArgument_ShouldThrow()
+        {
+            var people = (RealmResults<Person>)_realm.All<Person>();
+
+            Assert.That(() => people.Filter("Salary > $0", new object()), Throws.TypeOf<NotSupportedException>());
+        }
+    }
+}
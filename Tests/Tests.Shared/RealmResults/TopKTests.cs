@@ -0,0 +1,138 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+using System;
+using System.Linq;
+using NUnit.Framework;
+using Realms;
+
+namespace Tests.Database
+{
+    [TestFixture, Preserve(AllMembers = true)]
+    public class TopKTests : SortKeyTestsBase
+    {
+        protected override void CustomSetUp()
+        {
+            base.CustomSetUp();
+            AddObjects(200, 42);
+        }
+
+        [Test]
+        public void Take_WhenSortedOnNumber_ShouldMatchFullSort()
+        {
+            Assert.That(Ids(_realm.All<AllTypesObject>().OrderBy(o => o.DoubleProperty).ThenBy(o => o.Int64Property).Take(15)),
+                        Is.EqualTo(Ids(_objects.OrderBy(o => o.DoubleProperty).ThenBy(o => o.Int64Property).Take(15))));
+            Assert.That(Ids(_realm.All<AllTypesObject>().OrderByDescending(o => o.DoubleProperty).ThenByDescending(o => o.Int64Property).Skip(10).Take(15)),
+                        Is.EqualTo(Ids(_objects.OrderByDescending(o => o.DoubleProperty).ThenByDescending(o => o.Int64Property).Skip(10).Take(15))));
+        }
+
+        [Test]
+        public void Take_WhenLeadingKeyHasTies_ShouldOrderTiesOnLaterKeys()
+        {
+            // Only 10 distinct values over 200 rows, so the k-th row always ties with many others.
+            Assert.That(Ids(_realm.All<AllTypesObject>().OrderBy(o => o.Int32Property).ThenByDescending(o => o.Int64Property).Take(25)),
+                        Is.EqualTo(Ids(_objects.OrderBy(o => o.Int32Property).ThenByDescending(o => o.Int64Property).Take(25))));
+            Assert.That(Ids(_realm.All<AllTypesObject>().Where(o => o.Int32Property > 3).OrderByDescending(o => o.DateTimeOffsetProperty).ThenBy(o => o.Int64Property).Take(25)),
+                        Is.EqualTo(Ids(_objects.Where(o => o.Int32Property > 3).OrderByDescending(o => o.DateTimeOffsetProperty).ThenBy(o => o.Int64Property).Take(25))));
+        }
+
+        [Test]
+        public void Take_WhenLeadingKeyIsNullable_ShouldSortNullsFirst()
+        {
+            // LINQ to Objects also orders null before any value.
+            Assert.That(Ids(_realm.All<AllTypesObject>().OrderBy(o => o.NullableInt32Property).ThenBy(o => o.Int64Property).Take(10)),
+                        Is.EqualTo(Ids(_objects.OrderBy(o => o.NullableInt32Property).ThenBy(o => o.Int64Property).Take(10))));
+            Assert.That(Ids(_realm.All<AllTypesObject>().OrderBy(o => o.NullableInt32Property).ThenBy(o => o.Int64Property).Take(50)),
+                        Is.EqualTo(Ids(_objects.OrderBy(o => o.NullableInt32Property).ThenBy(o => o.Int64Property).Take(50))));
+            Assert.That(Ids(_realm.All<AllTypesObject>().OrderByDescending(o => o.NullableInt32Property).ThenBy(o => o.Int64Property).Skip(170).Take(30)),
+                        Is.EqualTo(Ids(_objects.OrderByDescending(o => o.NullableInt32Property).ThenBy(o => o.Int64Property).Skip(170).Take(30))));
+        }
+
+        [Test]
+        public void First_WhenSorted_ShouldReturnTopRow()
+        {
+            var expected = _objects.OrderByDescending(o => o.DoubleProperty).ThenBy(o => o.Int64Property).First();
+            Assert.That(_realm.All<AllTypesObject>().OrderByDescending(o => o.DoubleProperty).ThenBy(o => o.Int64Property).First(), Is.EqualTo(expected));
+            Assert.That(_realm.All<AllTypesObject>().Where(o => o.Int32Property > 100).OrderBy(o => o.DoubleProperty).FirstOrDefault(), Is.Null);
+        }
+
+        [Test]
+        public void ElementAt_WhenSorted_ShouldMatchFullSort()
+        {
+            var expected = _objects.OrderBy(o => o.Int32Property).ThenBy(o => o.Int64Property).ToArray();
+            var query = _realm.All<AllTypesObject>().OrderBy(o => o.Int32Property).ThenBy(o => o.Int64Property);
+
+            Assert.That(query.ElementAt(0), Is.EqualTo(expected[0]));
+            Assert.That(query.ElementAt(17), Is.EqualTo(expected[17]));
+            Assert.That(query.Skip(5).ElementAt(3), Is.EqualTo(expected[8]));
+            Assert.That(query.Skip(5).Take(3).ElementAtOrDefault(3), Is.Null);
+        }
+
+        [Test]
+        public void Take_WhenResultsAreLive_ShouldFollowChanges()
+        {
+            var window = _realm.All<AllTypesObject>().OrderBy(o => o.DoubleProperty).ThenBy(o => o.Int64Property).Take(5);
+            Assert.That(window.Count(), Is.EqualTo(5));
+
+            _realm.Write(() =>
+            {
+                foreach (var o in window.ToArray().Take(3))
+                {
+                    _realm.Remove(o);
+                }
+
+                _objects.OrderByDescending(o => o.DoubleProperty).First().DoubleProperty = -1;
+            });
+
+            var remaining = _realm.All<AllTypesObject>().ToArray();
+            Assert.That(Ids(window), Is.EqualTo(Ids(remaining.OrderBy(o => o.DoubleProperty).ThenBy(o => o.Int64Property).Take(5))));
+        }
+
+        [Test]
+        public void First_WhenLeadingKeyIsNaN_ShouldMatchFullSort()
+        {
+            _realm.Write(() =>
+            {
+                _objects[3].DoubleProperty = double.NaN;
+                _objects[150].DoubleProperty = double.NaN;
+            });
+
+            var sorted = _realm.All<AllTypesObject>().OrderBy(o => o.DoubleProperty).ThenBy(o => o.Int64Property);
+            var expected = sorted.ToArray();
+
+            Assert.That(sorted.First(), Is.EqualTo(expected[0]));
+            Assert.That(sorted.ElementAt(10), Is.EqualTo(expected[10]));
+        }
+
+        [Test]
+        public void Take_WhenLimitIsMaxValue_ShouldNotOverflow()
+        {
+            var sorted = _realm.All<AllTypesObject>().OrderBy(o => o.DoubleProperty).ThenBy(o => o.Int64Property);
+
+            Assert.That(Ids(sorted.Skip(5).Take(int.MaxValue)), Is.EqualTo(Ids(_objects.OrderBy(o => o.DoubleProperty).ThenBy(o => o.Int64Property).Skip(5))));
+            Assert.That(sorted.Skip(5).Take(int.MaxValue).First(), Is.EqualTo(sorted.ElementAt(5)));
+        }
+
+        [Test]
+        public void Take_WhenFewerMatchesThanRequested_ShouldReturnAllSorted()
+        {
+            Assert.That(Ids(_realm.All<AllTypesObject>().Where(o => o.Int32Property == 5).OrderBy(o => o.DoubleProperty).ThenBy(o => o.Int64Property).Take(1000)),
+                        Is.EqualTo(Ids(_objects.Where(o => o.Int32Property == 5).OrderBy(o => o.DoubleProperty).ThenBy(o => o.Int64Property))));
+        }
+    }
+}
@@ -45,6 +45,8 @@ LOCAL_SRC_FILES += src/object-store/src/list.cpp
 LOCAL_SRC_FILES += src/object-store/src/object_schema.cpp
 LOCAL_SRC_FILES += src/object-store/src/object_store.cpp
 LOCAL_SRC_FILES += src/object-store/src/object.cpp
+LOCAL_SRC_FILES += src/object-store/src/parser/parser.cpp
+LOCAL_SRC_FILES += src/object-store/src/parser/query_builder.cpp
 LOCAL_SRC_FILES += src/object-store/src/results.cpp
 LOCAL_SRC_FILES += src/object-store/src/schema.cpp
 LOCAL_SRC_FILES += src/object-store/src/shared_realm.cpp
@@ -73,6 +75,20 @@ LOCAL_SRC_FILES += src/schema_cs.cpp
 LOCAL_SRC_FILES += src/debug.cpp
 LOCAL_SRC_FILES += src/object_cs.cpp
 LOCAL_SRC_FILES += src/event_loop_signal_cs.cpp
+LOCAL_SRC_FILES += src/primary_key_index.cpp
+LOCAL_SRC_FILES += src/handle_pool.cpp
+LOCAL_SRC_FILES += src/row_bitmap.cpp
+LOCAL_SRC_FILES += src/value_set_query.cpp
+LOCAL_SRC_FILES += src/prepared_query_cs.cpp
+LOCAL_SRC_FILES += src/string_query.cpp
+LOCAL_SRC_FILES += src/predicate_program.cpp
+LOCAL_SRC_FILES += src/distinct_cs.cpp
+LOCAL_SRC_FILES += src/keyset_cursor.cpp
+LOCAL_SRC_FILES += src/top_k.cpp
+LOCAL_SRC_FILES += src/aggregate_cs.cpp
+LOCAL_SRC_FILES += src/import_cs.cpp
+LOCAL_SRC_FILES += src/scratch_arena.cpp
+LOCAL_SRC_FILES += src/utf_transcoder.cpp
 
 
 ifeq ($(REALM_ENABLE_SYNC),1)
@@ -98,6 +114,7 @@ LOCAL_LDLIBS += -lz
 LOCAL_CPPFLAGS := -DHAVE_PTHREADS
 LOCAL_C_INCLUDES += core-android/include
 LOCAL_C_INCLUDES += src/object-store/src/
+LOCAL_C_INCLUDES += src/object-store/external/pegtl
 
 include $(BUILD_SHARED_LIBRARY)
 
@@ -0,0 +1,197 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <realm.hpp>
+#include "aggregate_cs.hpp"
+#include "timestamp_helpers.hpp"
+#include "util/format.hpp"
+
+using namespace realm;
+using namespace realm::binding;
+
+namespace {
+
+PrimitiveValue make_value()
+{
+    PrimitiveValue result;
+    result.value.int_value = 0;
+    result.has_value = false;
+    return result;
+}
+
+PrimitiveValue int_value(int64_t value, bool has_value = true)
+{
+    auto result = make_value();
+    result.value.int_value = value;
+    result.has_value = has_value;
+    return result;
+}
+
+PrimitiveValue float_value(float value, bool has_value = true)
+{
+    auto result = make_value();
+    result.value.float_value = value;
+    result.has_value = has_value;
+    return result;
+}
+
+PrimitiveValue double_value(double value, bool has_value = true)
+{
+    auto result = make_value();
+    result.value.double_value = value;
+    result.has_value = has_value;
+    return result;
+}
+
+PrimitiveValue timestamp_value(const Timestamp& value)
+{
+    auto result = make_value();
+    if (!value.is_null()) {
+        result.value.ticks = to_ticks(value);
+        result.has_value = true;
+    }
+    return result;
+}
+
+PrimitiveValue mixed_value(const util::Optional<Mixed>& value)
+{
+    if (!value)
+        return make_value();
+
+    switch (value->get_type()) {
+        case type_Int:
+            return int_value(value->get_int());
+        case type_Float:
+            return float_value(value->get_float());
+        case type_Double:
+            return double_value(value->get_double());
+        case type_Timestamp:
+            return timestamp_value(value->get_timestamp());
+        default:
+            REALM_UNREACHABLE();
+    }
+}
+
+[[noreturn]] void throw_unsupported(const Table& table, size_t column_ndx, AggregateType type)
+{
+    static const char* const names[] = { "sum", "min", "max", "average" };
+    throw std::invalid_argument(util::format("Can't compute the %1 of property '%2'", names[static_cast<size_t>(type)],
+                                             table.get_column_name(column_ndx)));
+}
+
+}
+
+namespace realm {
+namespace binding {
+
+PrimitiveValue aggregate(Query& query, size_t column_ndx, AggregateType type)
+{
+    const Table& table = *query.get_table();
+    size_t count = 0;
+
+    switch (table.get_column_type(column_ndx)) {
+        case type_Int:
+            switch (type) {
+                case AggregateType::Sum:
+                    return int_value(query.sum_int(column_ndx));
+                case AggregateType::Min: {
+                    auto min = query.minimum_int(column_ndx, &count);
+                    return int_value(min, count > 0);
+                }
+                case AggregateType::Max: {
+                    auto max = query.maximum_int(column_ndx, &count);
+                    return int_value(max, count > 0);
+                }
+                case AggregateType::Average: {
+                    auto average = query.average_int(column_ndx, &count);
+                    return double_value(average, count > 0);
+                }
+            }
+            break;
+        case type_Float:
+            switch (type) {
+                case AggregateType::Sum:
+                    return double_value(query.sum_float(column_ndx));
+                case AggregateType::Min: {
+                    auto min = query.minimum_float(column_ndx, &count);
+                    return float_value(min, count > 0);
+                }
+                case AggregateType::Max: {
+                    auto max = query.maximum_float(column_ndx, &count);
+                    return float_value(max, count > 0);
+                }
+                case AggregateType::Average: {
+                    auto average = query.average_float(column_ndx, &count);
+                    return double_value(average, count > 0);
+                }
+            }
+            break;
+        case type_Double:
+            switch (type) {
+                case AggregateType::Sum:
+                    return double_value(query.sum_double(column_ndx));
+                case AggregateType::Min: {
+                    auto min = query.minimum_double(column_ndx, &count);
+                    return double_value(min, count > 0);
+                }
+                case AggregateType::Max: {
+                    auto max = query.maximum_double(column_ndx, &count);
+                    return double_value(max, count > 0);
+                }
+                case AggregateType::Average: {
+                    auto average = query.average_double(column_ndx, &count);
+                    return double_value(average, count > 0);
+                }
+            }
+            break;
+        case type_Timestamp:
+            switch (type) {
+                case AggregateType::Min:
+                    return timestamp_value(query.minimum_timestamp(column_ndx, nullptr));
+                case AggregateType::Max:
+                    return timestamp_value(query.maximum_timestamp(column_ndx, nullptr));
+                default:
+                    break;
+            }
+            break;
+        default:
+            break;
+    }
+
+    throw_unsupported(table, column_ndx, type);
+}
+
+PrimitiveValue aggregate(Results& results, size_t column_ndx, AggregateType type)
+{
+    switch (type) {
+        case AggregateType::Sum:
+            return mixed_value(results.sum(column_ndx));
+        case AggregateType::Min:
+            return mixed_value(results.min(column_ndx));
+        case AggregateType::Max:
+            return mixed_value(results.max(column_ndx));
+        case AggregateType::Average: {
+            auto average = results.average(column_ndx);
+            return average ? double_value(*average) : make_value();
+        }
+    }
+    REALM_UNREACHABLE();
+}
+
+} // namespace binding
+} // namespace realm
@@ -0,0 +1,45 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef AGGREGATE_CS_HPP
+#define AGGREGATE_CS_HPP
+
+#include "object_cs.hpp"
+
+namespace realm {
+namespace binding {
+
+    // Must stay in sync with AggregateType.cs
+    enum class AggregateType : uint8_t {
+        Sum,
+        Min,
+        Max,
+        Average
+    };
+
+    // Aggregates run over core's column aggregates and skip null values. The result is written to the slot of
+    // PrimitiveValue matching the column type, except that sums of float columns and all averages are doubles and
+    // dates are .NET ticks. has_value is false when there is no non-null value to take the min, max or average of;
+    // the sum of no values is zero. Results report unsupported column types through core's own exceptions.
+    PrimitiveValue aggregate(Query& query, size_t column_ndx, AggregateType type);
+    PrimitiveValue aggregate(Results& results, size_t column_ndx, AggregateType type);
+
+} // namespace binding
+} // namespace realm
+
+#endif // AGGREGATE_CS_HPP
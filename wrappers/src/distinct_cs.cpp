@@ -0,0 +1,158 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <set>
+#include <realm.hpp>
+#include "distinct_cs.hpp"
+#include "match_scan.hpp"
+#include "timestamp_helpers.hpp"
+#include "utf_transcoder.hpp"
+#include "util/format.hpp"
+
+using namespace realm;
+using namespace realm::binding;
+
+namespace {
+
+// Orders NaN after every other value so floating point values can be kept in a std::set.
+struct FloatingPointLess {
+    template<typename T>
+    bool operator()(T lhs, T rhs) const
+    {
+        if (std::isnan(lhs))
+            return false;
+        return std::isnan(rhs) || lhs < rhs;
+    }
+};
+
+template<typename T, typename Compare = std::less<T>>
+class DistinctCollector {
+public:
+    template<typename Getter>
+    void collect(Query& query, size_t column_ndx, Getter get)
+    {
+        const Table& table = *query.get_table();
+        const bool nullable = table.is_nullable(column_ndx);
+
+        for_each_match(query, [&](size_t row_ndx) {
+            if (nullable && table.is_null(column_ndx, row_ndx))
+                m_has_null = true;
+            else
+                m_values.insert(get(table, column_ndx, row_ndx));
+            return true;
+        });
+    }
+
+    size_t size() const
+    {
+        return m_values.size() + (m_has_null ? 1 : 0);
+    }
+
+    // Writes the values into slots while there is room, converting each with set_value(slot, value).
+    template<typename Setter>
+    void write(PrimitiveValue* values, size_t values_capacity, Setter set_value) const
+    {
+        size_t i = 0;
+        if (m_has_null && i < values_capacity)
+            values[i++].has_value = false;
+
+        for (auto it = m_values.begin(); it != m_values.end() && i < values_capacity; ++it) {
+            PrimitiveValue& slot = values[i++];
+            slot.has_value = true;
+            set_value(slot, *it);
+        }
+    }
+
+private:
+    std::set<T, Compare> m_values;
+    bool m_has_null = false;
+};
+
+template<typename T, typename Compare, typename Getter, typename Setter>
+size_t distinct(Query& query, size_t column_ndx, PrimitiveValue* values, size_t values_capacity, Getter get, Setter set_value)
+{
+    DistinctCollector<T, Compare> collector;
+    collector.collect(query, column_ndx, get);
+    collector.write(values, values_capacity, set_value);
+    return collector.size();
+}
+
+}
+
+namespace realm {
+namespace binding {
+
+size_t distinct_values(Query& query, size_t column_ndx, PrimitiveValue* values, size_t values_capacity,
+                       uint16_t* string_buffer, size_t string_buffer_size, size_t& string_units)
+{
+    string_units = 0;
+    const Table& table = *query.get_table();
+
+    switch (table.get_column_type(column_ndx)) {
+        case type_Bool:
+            return distinct<bool, std::less<bool>>(query, column_ndx, values, values_capacity,
+                [](const Table& table, size_t column, size_t row) { return table.get_bool(column, row); },
+                [](PrimitiveValue& slot, bool value) { slot.value.bool_value = value; });
+        case type_Int:
+            return distinct<int64_t, std::less<int64_t>>(query, column_ndx, values, values_capacity,
+                [](const Table& table, size_t column, size_t row) { return table.get_int(column, row); },
+                [](PrimitiveValue& slot, int64_t value) { slot.value.int_value = value; });
+        case type_Float:
+            return distinct<float, FloatingPointLess>(query, column_ndx, values, values_capacity,
+                [](const Table& table, size_t column, size_t row) { return table.get_float(column, row); },
+                [](PrimitiveValue& slot, float value) { slot.value.float_value = value; });
+        case type_Double:
+            return distinct<double, FloatingPointLess>(query, column_ndx, values, values_capacity,
+                [](const Table& table, size_t column, size_t row) { return table.get_double(column, row); },
+                [](PrimitiveValue& slot, double value) { slot.value.double_value = value; });
+        case type_Timestamp:
+            return distinct<Timestamp, std::less<Timestamp>>(query, column_ndx, values, values_capacity,
+                [](const Table& table, size_t column, size_t row) { return table.get_timestamp(column, row); },
+                [](PrimitiveValue& slot, const Timestamp& value) { slot.value.ticks = to_ticks(value); });
+        case type_String: {
+            // The strings stay valid for as long as the read transaction, so they are kept without copying. The
+            // decoded string is never longer than the UTF-8 data, so that much room is reserved for each one.
+            auto set_string = [&](PrimitiveValue& slot, StringData value) {
+                slot.value.string.offset = static_cast<uint32_t>(string_units);
+                slot.value.string.length = 0;
+                if (string_units + value.size() <= string_buffer_size) {
+                    const size_t length = utf::utf8_to_utf16(value.data(), value.size(), string_buffer + string_units);
+                    if (length == utf::invalid)
+                        throw std::runtime_error("Corrupted string data");
+
+                    slot.value.string.length = static_cast<uint32_t>(length);
+                    string_units += length;
+                }
+                else {
+                    string_units += value.size();
+                }
+            };
+            return distinct<StringData, std::less<StringData>>(query, column_ndx, values, values_capacity,
+                [](const Table& table, size_t column, size_t row) { return table.get_string(column, row); },
+                set_string);
+        }
+        default:
+            throw std::invalid_argument(util::format("Can't get the distinct values of property '%1'", table.get_column_name(column_ndx)));
+    }
+}
+
+} // namespace binding
+} // namespace realm
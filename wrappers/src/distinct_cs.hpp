@@ -0,0 +1,38 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef DISTINCT_CS_HPP
+#define DISTINCT_CS_HPP
+
+#include "object_cs.hpp"
+
+namespace realm {
+namespace binding {
+
+    // Collects the distinct values of a column over the rows matching query without creating any objects. Values
+    // are written in ascending order with null first; strings are ordered by their UTF-8 bytes and decoded into
+    // string_buffer as object_get_values does. Returns the number of distinct values and sets string_units to the
+    // 16-bit units the strings need. Nothing is written past either buffer, so when one of them is too small the
+    // call should be repeated with larger ones.
+    size_t distinct_values(Query& query, size_t column_ndx, PrimitiveValue* values, size_t values_capacity,
+                           uint16_t* string_buffer, size_t string_buffer_size, size_t& string_units);
+
+} // namespace binding
+} // namespace realm
+
+#endif // DISTINCT_CS_HPP
@@ -23,6 +23,7 @@
 #include <new>
 #include <realm.hpp>
 #include "realm_error_type.hpp"
+#include "scratch_arena.hpp"
 
 namespace realm {
 struct NativeException {
@@ -88,6 +89,7 @@ auto handle_errors(NativeException::Marshallable& ex, F&& func) -> decltype(func
 {
     using RetVal = decltype(func());
     ex.type = RealmErrorType::NoError;
+    binding::ScratchScope scratch_scope;
     try {
         return func();
     }
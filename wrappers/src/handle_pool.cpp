@@ -0,0 +1,49 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <realm.hpp>
+#include "handle_pool.hpp"
+#include "realm_export_decls.hpp"
+#include "object_accessor.hpp"
+#include "object-store/src/list.hpp"
+#include "object-store/src/results.hpp"
+
+using namespace realm;
+using namespace realm::binding;
+
+extern "C" {
+
+// Fills statistics with the statistics of the Object, Results, List and Query pools, in that order.
+REALM_EXPORT void handle_pool_get_statistics(HandlePoolStatistics* statistics)
+{
+    statistics[0] = HandlePool<Object>::instance().statistics();
+    statistics[1] = HandlePool<Results>::instance().statistics();
+    statistics[2] = HandlePool<List>::instance().statistics();
+    statistics[3] = HandlePool<Query>::instance().statistics();
+}
+
+// Lowers the peak of each pool to the number of handles currently live.
+REALM_EXPORT void handle_pool_reset_peaks()
+{
+    HandlePool<Object>::instance().reset_peak();
+    HandlePool<Results>::instance().reset_peak();
+    HandlePool<List>::instance().reset_peak();
+    HandlePool<Query>::instance().reset_peak();
+}
+
+}
@@ -0,0 +1,225 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef HANDLE_POOL_HPP
+#define HANDLE_POOL_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "thread_specific.hpp"
+
+namespace realm {
+namespace binding {
+
+// Must stay in sync with HandlePoolStatistics.cs
+struct HandlePoolStatistics {
+    uint64_t live;      // handles created and not yet destroyed
+    uint64_t peak;      // the most handles live at once
+    uint64_t capacity;  // slots in the slabs allocated so far
+};
+
+// Fixed-size slots for one of the types handed out to C# as handles (Object, Results, List and Query), carved from
+// slabs of slab_size slots. Enumerating and navigating creates and releases these by the million, and taking them
+// from slabs that are kept for reuse stops that churn from fragmenting the heap.
+//
+// Handles are created on their Realm's thread but destroyed from the .NET finalizer thread, so rather than a pool per
+// Realm there is one pool per type, and each thread keeps a cache of free slots. A thread only takes the pool's lock to
+// move a batch of slots between its cache and the shared free list, so creating and destroying are O(1) amortized.
+template<typename T>
+class HandlePool {
+public:
+    static const size_t slab_size = 256;
+    static const size_t batch_size = 64;
+
+    static HandlePool& instance()
+    {
+        // Never destroyed: finalizers can still release handles while the process shuts down.
+        static HandlePool* pool = new HandlePool();
+        return *pool;
+    }
+
+    template<typename... Args>
+    T* create(Args&&... args)
+    {
+        Slot* slot = take();
+        T* handle;
+        try {
+            handle = new (&slot->storage) T(std::forward<Args>(args)...);
+        }
+        catch (...) {
+            give_back(slot);
+            throw;
+        }
+
+        const uint64_t live = m_live.fetch_add(1, std::memory_order_relaxed) + 1;
+        uint64_t peak = m_peak.load(std::memory_order_relaxed);
+        while (live > peak && !m_peak.compare_exchange_weak(peak, live, std::memory_order_relaxed)) { }
+        return handle;
+    }
+
+    void destroy(T* handle)
+    {
+        if (!handle)
+            return;
+
+        handle->~T();
+        give_back(reinterpret_cast<Slot*>(handle));
+        m_live.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    HandlePoolStatistics statistics() const
+    {
+        return { m_live.load(std::memory_order_relaxed), m_peak.load(std::memory_order_relaxed), m_capacity.load(std::memory_order_relaxed) };
+    }
+
+    void reset_peak()
+    {
+        m_peak.store(m_live.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    }
+
+private:
+    union Slot {
+        Slot* next;
+        typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+    };
+
+    struct ThreadCache {
+        Slot* head = nullptr;
+        size_t count = 0;
+
+        ~ThreadCache()
+        {
+            if (head)
+                HandlePool::instance().release(head, count);
+        }
+    };
+
+    std::mutex m_mutex;
+    Slot* m_free = nullptr;
+    std::vector<std::unique_ptr<Slot[]>> m_slabs;
+
+    std::atomic<uint64_t> m_live{0};
+    std::atomic<uint64_t> m_peak{0};
+    std::atomic<uint64_t> m_capacity{0};
+
+    HandlePool() = default;
+
+    // The cache is handed back to the pool when its thread exits.
+    static ThreadCache& thread_cache()
+    {
+        static ThreadSpecific<ThreadCache> cache;
+        return cache.get();
+    }
+
+    Slot* take()
+    {
+        ThreadCache& cache = thread_cache();
+        if (!cache.head)
+            refill(cache);
+
+        Slot* slot = cache.head;
+        cache.head = slot->next;
+        --cache.count;
+        return slot;
+    }
+
+    void give_back(Slot* slot)
+    {
+        ThreadCache& cache = thread_cache();
+        slot->next = cache.head;
+        cache.head = slot;
+        if (++cache.count < 2 * batch_size)
+            return;
+
+        // Keep one batch and return the other, so a thread that only frees, like the finalizer, doesn't hoard slots.
+        Slot* tail = cache.head;
+        for (size_t i = 1; i < batch_size; ++i)
+            tail = tail->next;
+
+        Slot* batch = cache.head;
+        cache.head = tail->next;
+        cache.count -= batch_size;
+        tail->next = nullptr;
+        release(batch, batch_size);
+    }
+
+    void refill(ThreadCache& cache)
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_free)
+            grow();
+
+        Slot* tail = m_free;
+        size_t count = 1;
+        for (; count < batch_size && tail->next; ++count)
+            tail = tail->next;
+
+        cache.head = m_free;
+        cache.count = count;
+        m_free = tail->next;
+        tail->next = nullptr;
+    }
+
+    // Returns a list of count slots to the shared free list.
+    void release(Slot* head, size_t count)
+    {
+        Slot* tail = head;
+        for (size_t i = 1; i < count; ++i)
+            tail = tail->next;
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        tail->next = m_free;
+        m_free = head;
+    }
+
+    void grow()
+    {
+        std::unique_ptr<Slot[]> slab(new Slot[slab_size]);
+        for (size_t i = 0; i + 1 < slab_size; ++i)
+            slab[i].next = &slab[i + 1];
+        slab[slab_size - 1].next = m_free;
+        m_free = &slab[0];
+
+        m_slabs.push_back(std::move(slab));
+        m_capacity.fetch_add(slab_size, std::memory_order_relaxed);
+    }
+};
+
+template<typename T, typename... Args>
+inline T* create_handle(Args&&... args)
+{
+    return HandlePool<T>::instance().create(std::forward<Args>(args)...);
+}
+
+template<typename T>
+inline void destroy_handle(T* handle)
+{
+    HandlePool<T>::instance().destroy(handle);
+}
+
+} // namespace binding
+} // namespace realm
+
+#endif // HANDLE_POOL_HPP
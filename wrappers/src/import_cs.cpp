@@ -0,0 +1,1002 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <realm.hpp>
+#include <realm/util/file.hpp>
+#include "error_handling.hpp"
+#include "marshalling.hpp"
+#include "realm_export_decls.hpp"
+#include "timestamp_helpers.hpp"
+#include "object_cs.hpp"
+#include "import_cs.hpp"
+#include "object-store/src/object_store.hpp"
+#include "util/format.hpp"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <locale>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <unordered_map>
+
+using namespace realm;
+using namespace realm::binding;
+
+namespace {
+
+// The file is parsed in chunks of about this many bytes, each cut at a record boundary.
+const size_t target_chunk_size = 1024 * 1024;
+
+// One parsed field. Strings point into the mapped file when they need no unescaping and into the
+// batch's own storage otherwise.
+struct Cell {
+    enum class State : uint8_t {
+        Absent,
+        Null,
+        Value
+    };
+
+    State state = State::Absent;
+    union {
+        bool bool_value;
+        int64_t int_value;
+        float float_value;
+        double double_value;
+        int64_t ticks;
+    };
+    const char* string_data = nullptr;
+    size_t string_size = 0;
+};
+
+// The rows parsed from one chunk, stored row by row with one cell per imported property.
+struct Batch {
+    size_t row_count = 0;
+    size_t end_offset = 0;
+    std::vector<Cell> cells;
+    std::deque<std::string> owned_strings;
+    std::exception_ptr error;
+};
+
+[[noreturn]] void throw_invalid_value(const Property& property, const char* data, size_t size)
+{
+    throw std::invalid_argument(util::format("Invalid value '%1' for property '%2'", std::string(data, size), property.name));
+}
+
+bool parse_int(const char* begin, const char* end, int64_t& result)
+{
+    bool negative = false;
+    if (begin != end && (*begin == '-' || *begin == '+')) {
+        negative = *begin == '-';
+        ++begin;
+    }
+    if (begin == end)
+        return false;
+
+    const uint64_t limit = uint64_t(std::numeric_limits<int64_t>::max()) + (negative ? 1 : 0);
+    uint64_t value = 0;
+    for (; begin != end; ++begin) {
+        const unsigned digit = unsigned(*begin - '0');
+        if (digit > 9 || value > (limit - digit) / 10)
+            return false;
+        value = value * 10 + digit;
+    }
+    result = negative ? int64_t(0 - value) : int64_t(value);
+    return true;
+}
+
+bool equals_ignore_case(const char* begin, const char* end, const char* literal)
+{
+    for (; begin != end && *literal; ++begin, ++literal) {
+        if (std::tolower(static_cast<unsigned char>(*begin)) != *literal)
+            return false;
+    }
+    return begin == end && !*literal;
+}
+
+// Files use '.' as the decimal separator whatever the process locale is, so numbers are read through a stream
+// in the classic locale. Streams don't read the spellings of NaN and infinity, so those are matched here.
+template <typename T>
+bool parse_floating(const char* begin, const char* end, T& result)
+{
+    if (begin == end)
+        return false;
+
+    const bool negative = *begin == '-';
+    const char* magnitude = begin + (negative || *begin == '+' ? 1 : 0);
+    if (equals_ignore_case(magnitude, end, "nan")) {
+        result = std::numeric_limits<T>::quiet_NaN();
+        return true;
+    }
+    if (equals_ignore_case(magnitude, end, "inf") || equals_ignore_case(magnitude, end, "infinity")) {
+        result = negative ? -std::numeric_limits<T>::infinity() : std::numeric_limits<T>::infinity();
+        return true;
+    }
+
+    std::istringstream stream(std::string(begin, end));
+    stream.imbue(std::locale::classic());
+    double value;
+    stream >> value;
+    if (stream.fail() || stream.peek() != std::char_traits<char>::eof())
+        return false;
+
+    result = static_cast<T>(value);
+    return true;
+}
+
+bool parse_bool(const char* begin, const char* end, bool& result)
+{
+    if (equals_ignore_case(begin, end, "true") || equals_ignore_case(begin, end, "1")) {
+        result = true;
+        return true;
+    }
+    if (equals_ignore_case(begin, end, "false") || equals_ignore_case(begin, end, "0")) {
+        result = false;
+        return true;
+    }
+    return false;
+}
+
+bool parse_digits(const char*& p, const char* end, size_t count, int& result)
+{
+    if (size_t(end - p) < count)
+        return false;
+
+    result = 0;
+    for (size_t i = 0; i < count; ++i, ++p) {
+        const unsigned digit = unsigned(*p - '0');
+        if (digit > 9)
+            return false;
+        result = result * 10 + digit;
+    }
+    return true;
+}
+
+int64_t days_from_civil(int64_t year, unsigned month, unsigned day)
+{
+    year -= month <= 2;
+    const int64_t era = (year >= 0 ? year : year - 399) / 400;
+    const unsigned year_of_era = static_cast<unsigned>(year - era * 400);
+    const unsigned day_of_year = (153 * (month > 2 ? month - 3 : month + 9) + 2) / 5 + day - 1;
+    const unsigned day_of_era = year_of_era * 365 + year_of_era / 4 - year_of_era / 100 + day_of_year;
+    return era * 146097 + static_cast<int64_t>(day_of_era) - 719468;
+}
+
+// Parses ISO 8601 dates such as 2017-05-01, 2017-05-01T13:45:00.1234567Z or 2017-05-01 13:45:00+02:00
+// into .NET ticks. Times without an offset are taken to be UTC.
+bool parse_timestamp(const char* p, const char* end, int64_t& ticks)
+{
+    int year, month, day, hour = 0, minute = 0, second = 0;
+    if (!parse_digits(p, end, 4, year) || p == end || *p++ != '-' ||
+        !parse_digits(p, end, 2, month) || p == end || *p++ != '-' ||
+        !parse_digits(p, end, 2, day))
+        return false;
+
+    int64_t fraction_ticks = 0;
+    if (p != end && (*p == 'T' || *p == ' ')) {
+        ++p;
+        if (!parse_digits(p, end, 2, hour) || p == end || *p++ != ':' || !parse_digits(p, end, 2, minute))
+            return false;
+
+        if (p != end && *p == ':') {
+            ++p;
+            if (!parse_digits(p, end, 2, second))
+                return false;
+
+            if (p != end && *p == '.') {
+                ++p;
+                int64_t scale = ticks_per_second / 10;
+                const char* digits = p;
+                for (; p != end && unsigned(*p - '0') <= 9; ++p, scale /= 10)
+                    fraction_ticks += (*p - '0') * scale;
+                if (p == digits)
+                    return false;
+            }
+        }
+    }
+
+    int offset_minutes = 0;
+    if (p != end && *p == 'Z') {
+        ++p;
+    }
+    else if (p != end && (*p == '+' || *p == '-')) {
+        const bool negative = *p++ == '-';
+        int offset_hours, offset_mins;
+        if (!parse_digits(p, end, 2, offset_hours))
+            return false;
+        if (p != end && *p == ':')
+            ++p;
+        if (!parse_digits(p, end, 2, offset_mins))
+            return false;
+        offset_minutes = (negative ? -1 : 1) * (offset_hours * 60 + offset_mins);
+    }
+
+    if (p != end || month < 1 || month > 12 || day < 1 || day > 31 || hour > 23 || minute > 59 || second > 60)
+        return false;
+
+    const int64_t seconds = days_from_civil(year, month, day) * 86400 + hour * 3600 + (minute - offset_minutes) * 60 + second;
+    ticks = seconds * ticks_per_second + fraction_ticks + unix_epoch_ticks;
+    return true;
+}
+
+void append_utf8(std::string& out, uint32_t code_point)
+{
+    if (code_point < 0x80) {
+        out += char(code_point);
+    }
+    else if (code_point < 0x800) {
+        out += char(0xC0 | (code_point >> 6));
+        out += char(0x80 | (code_point & 0x3F));
+    }
+    else if (code_point < 0x10000) {
+        out += char(0xE0 | (code_point >> 12));
+        out += char(0x80 | ((code_point >> 6) & 0x3F));
+        out += char(0x80 | (code_point & 0x3F));
+    }
+    else {
+        out += char(0xF0 | (code_point >> 18));
+        out += char(0x80 | ((code_point >> 12) & 0x3F));
+        out += char(0x80 | ((code_point >> 6) & 0x3F));
+        out += char(0x80 | (code_point & 0x3F));
+    }
+}
+
+// Converts raw field text into a cell according to the type of the property it is imported into.
+// is_null_literal is set for empty unquoted CSV fields and JSON nulls.
+void convert_field(const Property& property, const char* data, size_t size, bool is_null_literal, Cell& cell)
+{
+    if (is_null_literal) {
+        if (property.is_nullable) {
+            cell.state = Cell::State::Null;
+            return;
+        }
+        if (property.type != PropertyType::String)
+            throw std::invalid_argument(util::format("Property '%1' is required but has no value", property.name));
+
+        // required strings are imported as empty instead
+        size = 0;
+    }
+
+    const char* end = data + size;
+    bool valid = true;
+    switch (property.type) {
+        case PropertyType::Bool:
+            valid = parse_bool(data, end, cell.bool_value);
+            break;
+        case PropertyType::Int:
+            valid = parse_int(data, end, cell.int_value);
+            break;
+        case PropertyType::Float:
+            valid = parse_floating(data, end, cell.float_value);
+            break;
+        case PropertyType::Double:
+            valid = parse_floating(data, end, cell.double_value);
+            break;
+        case PropertyType::Date:
+            valid = parse_timestamp(data, end, cell.ticks);
+            break;
+        case PropertyType::String:
+            cell.string_data = data;
+            cell.string_size = size;
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+
+    if (!valid)
+        throw_invalid_value(property, data, size);
+    cell.state = Cell::State::Value;
+}
+
+class CsvParser {
+public:
+    CsvParser(const char* begin, const char* end, char delimiter) : m_p(begin), m_end(end), m_delimiter(delimiter) {}
+
+    bool at_end() const { return m_p == m_end; }
+    const char* position() const { return m_p; }
+
+    // Reads the next field of the current record. Returns false when the record has no more fields.
+    bool next_field(std::string& scratch, const char*& data, size_t& size, bool& quoted)
+    {
+        if (m_end_of_record) {
+            return false;
+        }
+
+        quoted = m_p != m_end && *m_p == '"';
+        if (!quoted) {
+            data = m_p;
+            while (m_p != m_end && *m_p != m_delimiter && *m_p != '\n')
+                ++m_p;
+            size = m_p - data;
+            if (size > 0 && data[size - 1] == '\r' && (m_p == m_end || *m_p == '\n'))
+                --size;
+        }
+        else {
+            // Quoted fields only need copying if they contain escaped quotes.
+            ++m_p;
+            const char* start = m_p;
+            bool escaped = false;
+            scratch.clear();
+            while (true) {
+                if (m_p == m_end)
+                    throw std::invalid_argument("Unterminated quoted field in CSV data");
+                if (*m_p == '"') {
+                    if (m_p + 1 != m_end && m_p[1] == '"') {
+                        scratch.append(start, m_p + 1);
+                        m_p += 2;
+                        start = m_p;
+                        escaped = true;
+                        continue;
+                    }
+                    break;
+                }
+                ++m_p;
+            }
+            if (escaped) {
+                scratch.append(start, m_p);
+                data = scratch.data();
+                size = scratch.size();
+            }
+            else {
+                data = start;
+                size = m_p - start;
+            }
+            ++m_p;
+            if (m_p != m_end && *m_p == '\r')
+                ++m_p;
+        }
+
+        if (m_p == m_end || *m_p == '\n') {
+            if (m_p != m_end)
+                ++m_p;
+            m_end_of_record = true;
+        }
+        else if (*m_p == m_delimiter) {
+            ++m_p;
+        }
+        else {
+            throw std::invalid_argument("Unexpected character after quoted field in CSV data");
+        }
+        return true;
+    }
+
+    // Moves on to the next record, skipping blank lines.
+    bool next_record()
+    {
+        while (m_p != m_end && (*m_p == '\n' || *m_p == '\r'))
+            ++m_p;
+        m_end_of_record = false;
+        return m_p != m_end;
+    }
+
+private:
+    const char* m_p;
+    const char* m_end;
+    const char m_delimiter;
+    bool m_end_of_record = false;
+};
+
+class JsonLineParser {
+public:
+    JsonLineParser(const char* begin, const char* end) : m_p(begin), m_end(end) {}
+
+    // Parses one {"name": value, ...} object, calling on_value(name, data, size, is_null, is_string) for every member.
+    template <typename Callback>
+    void parse_object(std::string& key_scratch, std::string& value_scratch, Callback&& on_value)
+    {
+        skip_whitespace();
+        expect('{');
+        skip_whitespace();
+        if (peek() == '}') {
+            ++m_p;
+            return;
+        }
+
+        while (true) {
+            skip_whitespace();
+            const char* key;
+            size_t key_size;
+            parse_string(key_scratch, key, key_size);
+            skip_whitespace();
+            expect(':');
+            skip_whitespace();
+
+            const char c = peek();
+            if (c == '"') {
+                const char* value;
+                size_t value_size;
+                parse_string(value_scratch, value, value_size);
+                on_value(key, key_size, value, value_size, false);
+            }
+            else if (c == '{' || c == '[') {
+                throw std::invalid_argument("Nested objects and arrays can't be imported");
+            }
+            else {
+                const char* start = m_p;
+                while (m_p != m_end && *m_p != ',' && *m_p != '}' && !std::isspace(static_cast<unsigned char>(*m_p)))
+                    ++m_p;
+                const size_t size = m_p - start;
+                const bool is_null = size == 4 && std::memcmp(start, "null", 4) == 0;
+                on_value(key, key_size, start, size, is_null);
+            }
+
+            skip_whitespace();
+            if (peek() == ',') {
+                ++m_p;
+                continue;
+            }
+            expect('}');
+            break;
+        }
+
+        skip_whitespace();
+        if (m_p != m_end)
+            throw std::invalid_argument("Unexpected data after JSON object");
+    }
+
+private:
+    char peek() const
+    {
+        if (m_p == m_end)
+            throw std::invalid_argument("Unexpected end of JSON data");
+        return *m_p;
+    }
+
+    void expect(char c)
+    {
+        if (peek() != c)
+            throw std::invalid_argument(util::format("Expected '%1' in JSON data", c));
+        ++m_p;
+    }
+
+    void skip_whitespace()
+    {
+        while (m_p != m_end && std::isspace(static_cast<unsigned char>(*m_p)))
+            ++m_p;
+    }
+
+    uint32_t parse_hex4()
+    {
+        if (m_end - m_p < 4)
+            throw std::invalid_argument("Invalid escape sequence in JSON string");
+
+        uint32_t value = 0;
+        for (int i = 0; i < 4; ++i, ++m_p) {
+            const char c = *m_p;
+            value <<= 4;
+            if (c >= '0' && c <= '9')
+                value |= c - '0';
+            else if (c >= 'a' && c <= 'f')
+                value |= c - 'a' + 10;
+            else if (c >= 'A' && c <= 'F')
+                value |= c - 'A' + 10;
+            else
+                throw std::invalid_argument("Invalid escape sequence in JSON string");
+        }
+        return value;
+    }
+
+    // Strings without escapes are returned in place, the others are unescaped into scratch.
+    void parse_string(std::string& scratch, const char*& data, size_t& size)
+    {
+        expect('"');
+        const char* start = m_p;
+        while (m_p != m_end && *m_p != '"' && *m_p != '\\')
+            ++m_p;
+        if (peek() == '"') {
+            data = start;
+            size = m_p++ - start;
+            return;
+        }
+
+        scratch.assign(start, m_p);
+        while (true) {
+            const char c = peek();
+            ++m_p;
+            if (c == '"')
+                break;
+            if (c != '\\') {
+                scratch += c;
+                continue;
+            }
+
+            const char escape = peek();
+            ++m_p;
+            switch (escape) {
+                case '"': scratch += '"'; break;
+                case '\\': scratch += '\\'; break;
+                case '/': scratch += '/'; break;
+                case 'b': scratch += '\b'; break;
+                case 'f': scratch += '\f'; break;
+                case 'n': scratch += '\n'; break;
+                case 'r': scratch += '\r'; break;
+                case 't': scratch += '\t'; break;
+                case 'u': {
+                    uint32_t code_point = parse_hex4();
+                    if (code_point >= 0xD800 && code_point < 0xDC00) {
+                        if (m_end - m_p < 2 || m_p[0] != '\\' || m_p[1] != 'u')
+                            throw std::invalid_argument("Unpaired surrogate in JSON string");
+                        m_p += 2;
+                        const uint32_t low = parse_hex4();
+                        if (low < 0xDC00 || low >= 0xE000)
+                            throw std::invalid_argument("Unpaired surrogate in JSON string");
+                        code_point = 0x10000 + ((code_point - 0xD800) << 10) + (low - 0xDC00);
+                    }
+                    else if (code_point >= 0xDC00 && code_point < 0xE000) {
+                        throw std::invalid_argument("Unpaired surrogate in JSON string");
+                    }
+                    append_utf8(scratch, code_point);
+                    break;
+                }
+                default:
+                    throw std::invalid_argument("Invalid escape sequence in JSON string");
+            }
+        }
+        data = scratch.data();
+        size = scratch.size();
+    }
+
+    const char* m_p;
+    const char* m_end;
+};
+
+class Importer {
+public:
+    Importer(const ObjectSchema& object_schema, const ImportOptions& options, const char* data, size_t size)
+    : m_options(options)
+    , m_data(data)
+    , m_size(size)
+    {
+        for (auto& property : object_schema.persisted_properties) {
+            m_properties_by_name.emplace(property.name, &property);
+        }
+
+        size_t begin = 0;
+        if (size >= 3 && std::memcmp(data, "\xEF\xBB\xBF", 3) == 0)
+            begin = 3;
+
+        if (options.format == ImportFormat::Csv && options.has_header) {
+            begin = read_header(begin);
+        }
+        else {
+            for (auto& property : object_schema.persisted_properties) {
+                if (is_importable(property))
+                    add_column(property);
+            }
+        }
+
+        split_into_chunks(begin);
+    }
+
+    const std::vector<const Property*>& columns() const { return m_columns; }
+    const std::vector<std::pair<size_t, size_t>>& chunks() const { return m_chunks; }
+
+    Batch parse_chunk(size_t chunk_ndx) const
+    {
+        Batch batch;
+        batch.end_offset = m_chunks[chunk_ndx].second;
+        try {
+            const char* begin = m_data + m_chunks[chunk_ndx].first;
+            const char* end = m_data + m_chunks[chunk_ndx].second;
+            if (m_options.format == ImportFormat::Csv)
+                parse_csv(begin, end, batch);
+            else
+                parse_ndjson(begin, end, batch);
+        }
+        catch (...) {
+            batch.error = std::current_exception();
+        }
+        return batch;
+    }
+
+private:
+    static bool is_importable(const Property& property)
+    {
+        switch (property.type) {
+            case PropertyType::Bool:
+            case PropertyType::Int:
+            case PropertyType::Float:
+            case PropertyType::Double:
+            case PropertyType::Date:
+            case PropertyType::String:
+                return true;
+            default:
+                return false;
+        }
+    }
+
+    void add_column(const Property& property)
+    {
+        if (!is_importable(property))
+            throw std::invalid_argument(util::format("Property '%1' can't be imported", property.name));
+
+        m_column_by_property.emplace(&property, m_columns.size());
+        m_columns.push_back(&property);
+    }
+
+    size_t read_header(size_t begin)
+    {
+        CsvParser parser(m_data + begin, m_data + m_size, m_options.delimiter);
+        if (!parser.next_record())
+            return m_size;
+
+        std::string scratch;
+        const char* data;
+        size_t size;
+        bool quoted;
+        while (parser.next_field(scratch, data, size, quoted)) {
+            auto it = m_properties_by_name.find(std::string(data, size));
+            if (it == m_properties_by_name.end())
+                throw std::invalid_argument(util::format("Property '%1' does not exist", std::string(data, size)));
+            add_column(*it->second);
+        }
+        return parser.position() - m_data;
+    }
+
+    // Cuts the data into chunks of about target_chunk_size bytes, each ending at a record boundary.
+    // For CSV this has to track quotes, as quoted fields may contain line breaks.
+    void split_into_chunks(size_t begin)
+    {
+        const bool track_quotes = m_options.format == ImportFormat::Csv;
+        while (begin < m_size) {
+            size_t end = std::min(begin + target_chunk_size, m_size);
+            if (track_quotes) {
+                bool in_quotes = false;
+                size_t p = begin;
+                for (; p < m_size; ++p) {
+                    const char c = m_data[p];
+                    if (c == '"')
+                        in_quotes = !in_quotes;
+                    else if (c == '\n' && !in_quotes && p >= end)
+                        break;
+                }
+                end = std::min(p + 1, m_size);
+            }
+            else if (end < m_size) {
+                const void* newline = std::memchr(m_data + end, '\n', m_size - end);
+                end = newline ? static_cast<const char*>(newline) - m_data + 1 : m_size;
+            }
+            m_chunks.emplace_back(begin, end);
+            begin = end;
+        }
+    }
+
+    void parse_csv(const char* begin, const char* end, Batch& batch) const
+    {
+        CsvParser parser(begin, end, m_options.delimiter);
+        std::string scratch;
+        const char* data;
+        size_t size;
+        bool quoted;
+        while (parser.next_record()) {
+            const size_t first_cell = batch.cells.size();
+            batch.cells.resize(first_cell + m_columns.size());
+
+            size_t field = 0;
+            while (parser.next_field(scratch, data, size, quoted)) {
+                if (field == m_columns.size())
+                    throw std::invalid_argument("A CSV record has more fields than there are properties to import");
+
+                Cell& cell = batch.cells[first_cell + field];
+                convert_field(*m_columns[field], data, size, !quoted && size == 0, cell);
+                if (cell.string_data == scratch.data() && cell.state == Cell::State::Value) {
+                    batch.owned_strings.emplace_back(scratch);
+                    cell.string_data = batch.owned_strings.back().data();
+                }
+                ++field;
+            }
+            ++batch.row_count;
+        }
+    }
+
+    void parse_ndjson(const char* begin, const char* end, Batch& batch) const
+    {
+        std::string key_scratch, value_scratch;
+        while (begin != end) {
+            const char* line_end = static_cast<const char*>(std::memchr(begin, '\n', end - begin));
+            if (!line_end)
+                line_end = end;
+
+            const char* line_begin = begin;
+            begin = line_end == end ? end : line_end + 1;
+            if (std::all_of(line_begin, line_end, [](char c) { return std::isspace(static_cast<unsigned char>(c)); }))
+                continue;
+
+            const size_t first_cell = batch.cells.size();
+            batch.cells.resize(first_cell + m_columns.size());
+
+            JsonLineParser parser(line_begin, line_end);
+            parser.parse_object(key_scratch, value_scratch, [&](const char* key, size_t key_size, const char* data, size_t size, bool is_null) {
+                auto property = m_properties_by_name.find(std::string(key, key_size));
+                if (property == m_properties_by_name.end())
+                    throw std::invalid_argument(util::format("Property '%1' does not exist", std::string(key, key_size)));
+
+                auto column = m_column_by_property.find(property->second);
+                if (column == m_column_by_property.end())
+                    throw std::invalid_argument(util::format("Property '%1' can't be imported", property->second->name));
+
+                Cell& cell = batch.cells[first_cell + column->second];
+                convert_field(*property->second, data, size, is_null, cell);
+                if (cell.string_data == value_scratch.data() && cell.state == Cell::State::Value) {
+                    batch.owned_strings.emplace_back(value_scratch);
+                    cell.string_data = batch.owned_strings.back().data();
+                }
+            });
+            ++batch.row_count;
+        }
+    }
+
+    const ImportOptions& m_options;
+    const char* m_data;
+    const size_t m_size;
+    std::unordered_map<std::string, const Property*> m_properties_by_name;
+    std::unordered_map<const Property*, size_t> m_column_by_property;
+    std::vector<const Property*> m_columns;
+    std::vector<std::pair<size_t, size_t>> m_chunks;
+};
+
+// Parses the chunks on a pool of threads while the caller consumes the batches in file order.
+// Workers stay at most a few chunks ahead of the consumer so memory use stays bounded.
+class ParallelParser {
+public:
+    ParallelParser(const Importer& importer, size_t thread_count)
+    : m_importer(importer)
+    , m_batches(importer.chunks().size())
+    , m_window(thread_count * 2)
+    {
+        try {
+            for (size_t i = 0; i < thread_count; ++i)
+                m_threads.emplace_back([this] { work(); });
+        }
+        catch (...) {
+            stop();
+            throw;
+        }
+    }
+
+    ~ParallelParser()
+    {
+        stop();
+    }
+
+    std::unique_ptr<Batch> take(size_t chunk_ndx)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_batch_ready.wait(lock, [&] { return m_batches[chunk_ndx] != nullptr || m_error; });
+        if (!m_batches[chunk_ndx])
+            std::rethrow_exception(m_error);
+        m_consumed = chunk_ndx + 1;
+        m_consumed_changed.notify_all();
+        return std::move(m_batches[chunk_ndx]);
+    }
+
+private:
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stopping = true;
+        }
+        m_consumed_changed.notify_all();
+        for (auto& thread : m_threads)
+            thread.join();
+    }
+
+    void work()
+    {
+        while (true) {
+            size_t chunk_ndx;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                if (m_next_chunk == m_batches.size())
+                    return;
+                chunk_ndx = m_next_chunk++;
+                m_consumed_changed.wait(lock, [&] { return m_stopping || chunk_ndx < m_consumed + m_window; });
+                if (m_stopping)
+                    return;
+            }
+
+            // Parse errors are reported through the batch, but running out of memory for the batch itself
+            // must not escape the thread either: the consumer rethrows it once it reaches this chunk.
+            try {
+                auto batch = std::make_unique<Batch>(m_importer.parse_chunk(chunk_ndx));
+
+                std::lock_guard<std::mutex> lock(m_mutex);
+                m_batches[chunk_ndx] = std::move(batch);
+                m_batch_ready.notify_all();
+            }
+            catch (...) {
+                std::lock_guard<std::mutex> lock(m_mutex);
+                if (!m_error)
+                    m_error = std::current_exception();
+                m_batch_ready.notify_all();
+                return;
+            }
+        }
+    }
+
+    const Importer& m_importer;
+    std::vector<std::unique_ptr<Batch>> m_batches;
+    const size_t m_window;
+    size_t m_next_chunk = 0;
+    size_t m_consumed = 0;
+    bool m_stopping = false;
+    std::exception_ptr m_error;
+    std::mutex m_mutex;
+    std::condition_variable m_batch_ready;
+    std::condition_variable m_consumed_changed;
+    std::vector<std::thread> m_threads;
+};
+
+void set_primary_key(const SharedRealm& realm, Table& table, size_t row_ndx, size_t column_ndx, const Property& property, const Cell& cell)
+{
+    if (cell.state != Cell::State::Value)
+        set_null_unique(realm, table, row_ndx, column_ndx);
+    else if (property.type == PropertyType::Int)
+        set_int_unique(realm, table, row_ndx, column_ndx, cell.int_value);
+    else
+        set_string_unique(realm, table, row_ndx, column_ndx, StringData(cell.string_data, cell.string_size));
+}
+
+void set_value(Table& table, size_t row_ndx, size_t column_ndx, const Property& property, const Cell& cell)
+{
+    if (cell.state == Cell::State::Absent)
+        return;
+
+    if (cell.state == Cell::State::Null) {
+        table.set_null(column_ndx, row_ndx);
+        return;
+    }
+
+    switch (property.type) {
+        case PropertyType::Bool:
+            table.set_bool(column_ndx, row_ndx, cell.bool_value);
+            break;
+        case PropertyType::Int:
+            table.set_int(column_ndx, row_ndx, cell.int_value);
+            break;
+        case PropertyType::Float:
+            table.set_float(column_ndx, row_ndx, cell.float_value);
+            break;
+        case PropertyType::Double:
+            table.set_double(column_ndx, row_ndx, cell.double_value);
+            break;
+        case PropertyType::Date:
+            table.set_timestamp(column_ndx, row_ndx, from_ticks(cell.ticks));
+            break;
+        case PropertyType::String:
+            table.set_string(column_ndx, row_ndx, StringData(cell.string_data, cell.string_size));
+            break;
+        default:
+            REALM_UNREACHABLE();
+    }
+}
+
+} // anonymous namespace
+
+extern "C" {
+
+// Imports a CSV or newline delimited JSON file into the table of object_type and returns the number of rows imported.
+// The file is parsed on several threads while the calling thread writes the rows, committing every
+// rows_per_transaction rows, so it must not already be in a write transaction.
+REALM_EXPORT size_t shared_realm_import_file(SharedRealm& realm, uint16_t* object_type, size_t object_type_len, uint16_t* path, size_t path_len, ImportOptions options, NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() -> size_t {
+        realm->verify_thread();
+        if (realm->is_in_transaction())
+            throw std::logic_error("Files can't be imported inside a write transaction.");
+
+        const std::string object_name = Utf16StringAccessor(object_type, object_type_len);
+        auto object_schema = realm->schema().find(object_name);
+        if (object_schema == realm->schema().end())
+            throw std::invalid_argument(util::format("Object type '%1' is not part of the schema", object_name));
+
+        util::File file(Utf16StringAccessor(path, path_len));
+        const size_t file_size = static_cast<size_t>(file.get_size());
+        if (file_size == 0)
+            return 0;
+
+        util::File::Map<char> map(file, util::File::access_ReadOnly, file_size);
+        Importer importer(*object_schema, options, map.get_addr(), file_size);
+
+        const auto& columns = importer.columns();
+        const Property* primary_key = object_schema->primary_key_property();
+        size_t primary_key_column = npos;
+        for (size_t i = 0; i < columns.size(); ++i) {
+            if (columns[i] == primary_key)
+                primary_key_column = i;
+        }
+        if (primary_key && primary_key_column == npos)
+            throw std::invalid_argument(util::format("The primary key '%1' must be imported", primary_key->name));
+
+        const size_t rows_per_transaction = std::max<size_t>(options.rows_per_transaction, 1);
+        size_t thread_count = options.thread_count;
+        if (thread_count == 0)
+            thread_count = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+
+        ParallelParser parser(importer, thread_count);
+
+        size_t rows_imported = 0;
+        size_t rows_in_transaction = 0;
+        realm->begin_transaction();
+        try {
+            for (size_t chunk_ndx = 0; chunk_ndx < importer.chunks().size(); ++chunk_ndx) {
+                auto batch = parser.take(chunk_ndx);
+                if (batch->error)
+                    std::rethrow_exception(batch->error);
+
+                for (size_t row = 0; row < batch->row_count;) {
+                    TableRef table = ObjectStore::table_for_object_type(realm->read_group(), object_name);
+
+                    // Write as many rows as fit into the current transaction.
+                    const size_t row_count = std::min(batch->row_count - row, rows_per_transaction - rows_in_transaction);
+                    const Cell* cells = &batch->cells[row * columns.size()];
+
+                    size_t first_row;
+                    if (primary_key) {
+                        first_row = table->size();
+                        for (size_t i = 0; i < row_count; ++i) {
+                            set_primary_key(realm, *table, table->add_empty_row(), primary_key->table_column, *primary_key,
+                                            cells[i * columns.size() + primary_key_column]);
+                        }
+                    }
+                    else {
+                        first_row = table->add_empty_row(row_count);
+                    }
+
+                    for (size_t column = 0; column < columns.size(); ++column) {
+                        if (column == primary_key_column)
+                            continue;
+                        for (size_t i = 0; i < row_count; ++i)
+                            set_value(*table, first_row + i, columns[column]->table_column, *columns[column], cells[i * columns.size() + column]);
+                    }
+
+                    row += row_count;
+                    rows_imported += row_count;
+                    rows_in_transaction += row_count;
+                    if (rows_in_transaction == rows_per_transaction) {
+                        realm->commit_transaction();
+                        rows_in_transaction = 0;
+
+                        const uint64_t bytes_processed = row == batch->row_count ? batch->end_offset : importer.chunks()[chunk_ndx].first;
+                        if (options.progress_callback && !options.progress_callback(options.managed_state, rows_imported, bytes_processed, file_size))
+                            return rows_imported;
+
+                        realm->begin_transaction();
+                    }
+                }
+            }
+            realm->commit_transaction();
+        }
+        catch (...) {
+            if (realm->is_in_transaction())
+                realm->cancel_transaction();
+            throw;
+        }
+
+        if (options.progress_callback)
+            options.progress_callback(options.managed_state, rows_imported, file_size, file_size);
+
+        return rows_imported;
+    });
+}
+
+}   // extern "C"
@@ -0,0 +1,53 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef IMPORT_CS_HPP
+#define IMPORT_CS_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+enum class ImportFormat : uint8_t {
+    Csv,
+    NdJson
+};
+
+// Must stay in sync with ImportOptions.cs
+struct ImportOptions
+{
+    ImportFormat format;
+
+    // CSV only. When there is a header its field names select the properties to import, otherwise the
+    // fields map to the persisted bool, int, float, double, date and string properties in order.
+    bool has_header;
+    char delimiter;
+
+    // Rows committed per write transaction. The progress callback is invoked after every commit and
+    // the import stops once it returns false.
+    size_t rows_per_transaction;
+
+    // Number of parser threads, or 0 to use one per core.
+    size_t thread_count;
+
+    // Must not throw: the managed side catches exceptions from the user's callback, stops the import by
+    // returning false and rethrows once the import has returned.
+    bool (*progress_callback)(void* managed_state, uint64_t rows_imported, uint64_t bytes_processed, uint64_t total_bytes);
+    void* managed_state;
+};
+
+#endif // IMPORT_CS_HPP
@@ -0,0 +1,282 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <cstring>
+#include <realm/query_expression.hpp>
+#include "keyset_cursor.hpp"
+
+using namespace realm;
+using namespace realm::binding;
+
+namespace {
+
+const uint8_t cursor_version = 1;
+
+// A cursor is a header followed by one key per sort clause.
+struct CursorHeader {
+    uint8_t version;
+    uint8_t reserved[3];
+    uint32_t clause_count;
+};
+static_assert(sizeof(CursorHeader) == 8, "CursorHeader must stay fixed in size");
+
+struct CursorKey {
+    int8_t type;
+    bool has_value;
+    int32_t nanoseconds;
+    union {
+        bool bool_value;
+        int64_t int_value;
+        float float_value;
+        double double_value;
+        int64_t seconds;
+    } value;
+};
+static_assert(sizeof(CursorKey) == 16, "CursorKey must stay fixed in size");
+
+// Follows the links of a sort key path to the table holding the sorted column.
+const Table& sorted_table(const Table& table, const std::vector<size_t>& path)
+{
+    const Table* current = &table;
+    for (size_t i = 0; i + 1 < path.size(); ++i)
+        current = current->get_link_target(path[i]).get();
+    return *current;
+}
+
+DataType sorted_column_type(const Table& table, const std::vector<size_t>& path)
+{
+    auto type = sorted_table(table, path).get_column_type(path.back());
+    switch (type) {
+        case type_Bool:
+        case type_Int:
+        case type_Float:
+        case type_Double:
+        case type_Timestamp:
+            return type;
+        default:
+            throw std::invalid_argument("Keyset pagination only supports sorting on bool, int, float, double and date properties");
+    }
+}
+
+CursorKey read_key(const Table& table, size_t row_ndx, const std::vector<size_t>& path)
+{
+    CursorKey key;
+    std::memset(&key, 0, sizeof(key));
+
+    const Table* current = &table;
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        if (current->is_null_link(path[i], row_ndx))
+            return key;
+        row_ndx = current->get_link(path[i], row_ndx);
+        current = current->get_link_target(path[i]).get();
+    }
+
+    const size_t column_ndx = path.back();
+    if (current->is_nullable(column_ndx) && current->is_null(column_ndx, row_ndx))
+        return key;
+
+    key.has_value = true;
+    switch (current->get_column_type(column_ndx)) {
+        case type_Bool:
+            key.value.bool_value = current->get_bool(column_ndx, row_ndx);
+            break;
+        case type_Int:
+            key.value.int_value = current->get_int(column_ndx, row_ndx);
+            break;
+        case type_Float:
+            key.value.float_value = current->get_float(column_ndx, row_ndx);
+            break;
+        case type_Double:
+            key.value.double_value = current->get_double(column_ndx, row_ndx);
+            break;
+        case type_Timestamp: {
+            auto timestamp = current->get_timestamp(column_ndx, row_ndx);
+            key.value.seconds = timestamp.get_seconds();
+            key.nanoseconds = timestamp.get_nanoseconds();
+            break;
+        }
+        default:
+            REALM_UNREACHABLE();
+    }
+    return key;
+}
+
+// Builds the conditions of one sort clause over the column at the end of its path. Each condition starts a new
+// expression because following links with Table::link() is consumed by the column it ends in.
+template<typename T>
+class ClauseConditions {
+public:
+    ClauseConditions(Table& table, const std::vector<size_t>& path, bool ascending, bool has_value, T value)
+    : m_table(table), m_path(path), m_ascending(ascending), m_has_value(has_value), m_value(value)
+    {
+        m_may_be_null = path.size() > 1 || sorted_table(table, path).is_nullable(path.back());
+    }
+
+    Query equal()
+    {
+        return m_has_value ? column() == m_value : column() == null();
+    }
+
+    // Rows sorting strictly after the key. Nulls sort first when ascending and last when descending, like core sorts
+    // them. Returns false when no row can sort after the key.
+    bool after(Query& condition)
+    {
+        if (m_ascending) {
+            condition = m_has_value ? column() > m_value : column() != null();
+            return true;
+        }
+
+        if (!m_has_value)
+            return false;
+
+        condition = column() < m_value;
+        if (m_may_be_null)
+            condition = condition || column() == null();
+        return true;
+    }
+
+private:
+    Table& m_table;
+    const std::vector<size_t>& m_path;
+    const bool m_ascending;
+    const bool m_has_value;
+    const T m_value;
+    bool m_may_be_null;
+
+    Columns<T> column()
+    {
+        for (size_t i = 0; i + 1 < m_path.size(); ++i)
+            m_table.link(m_path[i]);
+        return m_table.column<T>(m_path.back());
+    }
+};
+
+// Bools can only be compared for equality, so the rows after a key are spelled out instead.
+template<>
+bool ClauseConditions<bool>::after(Query& condition)
+{
+    const bool first_value = !m_ascending;
+    if (m_ascending && !m_has_value) {
+        condition = column() != null();
+        return true;
+    }
+    if (m_has_value && m_value == first_value) {
+        condition = column() == !first_value;
+        if (!m_ascending && m_may_be_null)
+            condition = condition || column() == null();
+        return true;
+    }
+    if (!m_ascending && m_has_value && m_may_be_null) {
+        condition = column() == null();
+        return true;
+    }
+    return false;
+}
+
+// Adds "all earlier clauses are equal to the key and this one sorts after it" to condition, then extends the
+// equality prefix with this clause.
+template<typename T>
+void add_clause(ClauseConditions<T> clause, util::Optional<Query>& prefix, util::Optional<Query>& condition)
+{
+    Query after;
+    if (clause.after(after)) {
+        if (prefix)
+            after = *prefix && after;
+        condition = condition ? *condition || after : after;
+    }
+
+    auto equal = clause.equal();
+    prefix = prefix ? *prefix && equal : equal;
+}
+
+}
+
+namespace realm {
+namespace binding {
+
+size_t keyset_cursor_size(size_t clause_count)
+{
+    return sizeof(CursorHeader) + clause_count * sizeof(CursorKey);
+}
+
+void write_keyset_cursor(const Table& table, size_t row_ndx, const std::vector<std::vector<size_t>>& column_indices, uint8_t* cursor)
+{
+    CursorHeader header;
+    std::memset(&header, 0, sizeof(header));
+    header.version = cursor_version;
+    header.clause_count = static_cast<uint32_t>(column_indices.size());
+    std::memcpy(cursor, &header, sizeof(header));
+    cursor += sizeof(header);
+
+    for (auto& path : column_indices) {
+        auto key = read_key(table, row_ndx, path);
+        key.type = static_cast<int8_t>(sorted_column_type(table, path));
+        std::memcpy(cursor, &key, sizeof(key));
+        cursor += sizeof(key);
+    }
+}
+
+void add_keyset_condition(Query& query, const std::vector<std::vector<size_t>>& column_indices, const std::vector<bool>& ascending,
+                          const uint8_t* cursor, size_t cursor_size)
+{
+    CursorHeader header;
+    if (cursor_size != keyset_cursor_size(column_indices.size()))
+        throw std::invalid_argument("The cursor was not created for this sort order");
+    std::memcpy(&header, cursor, sizeof(header));
+    if (header.version != cursor_version || header.clause_count != column_indices.size())
+        throw std::invalid_argument("The cursor was not created for this sort order");
+    cursor += sizeof(header);
+
+    Table& table = *query.get_table();
+    util::Optional<Query> prefix;
+    util::Optional<Query> condition;
+    for (size_t i = 0; i < column_indices.size(); ++i) {
+        CursorKey key;
+        std::memcpy(&key, cursor + i * sizeof(key), sizeof(key));
+
+        auto& path = column_indices[i];
+        if (key.type != sorted_column_type(table, path))
+            throw std::invalid_argument("The cursor was not created for this sort order");
+
+        switch (key.type) {
+            case type_Bool:
+                add_clause(ClauseConditions<bool>(table, path, ascending[i], key.has_value, key.value.bool_value), prefix, condition);
+                break;
+            case type_Int:
+                add_clause(ClauseConditions<int64_t>(table, path, ascending[i], key.has_value, key.value.int_value), prefix, condition);
+                break;
+            case type_Float:
+                add_clause(ClauseConditions<float>(table, path, ascending[i], key.has_value, key.value.float_value), prefix, condition);
+                break;
+            case type_Double:
+                add_clause(ClauseConditions<double>(table, path, ascending[i], key.has_value, key.value.double_value), prefix, condition);
+                break;
+            case type_Timestamp:
+                add_clause(ClauseConditions<Timestamp>(table, path, ascending[i], key.has_value, Timestamp(key.value.seconds, key.nanoseconds)), prefix, condition);
+                break;
+        }
+    }
+
+    if (condition)
+        query.and_query(*condition);
+    else
+        query.and_query(std::unique_ptr<Expression>(new FalseExpression));
+}
+
+} // namespace binding
+} // namespace realm
@@ -0,0 +1,48 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef KEYSET_CURSOR_HPP
+#define KEYSET_CURSOR_HPP
+
+#include <vector>
+#include <realm.hpp>
+
+namespace realm {
+namespace binding {
+
+    // A keyset cursor records the sort key of the last row of a page, so the next page can be found with a query
+    // condition instead of by skipping every earlier row. The cursor is opaque to the managed side: it only stores
+    // the bytes and hands them back. Sort keys are column index paths as produced by unflatten_sort_clauses and may
+    // follow links; the sorted columns must be bool, int, float, double or timestamp columns.
+
+    // The number of bytes of a cursor for the given number of sort clauses.
+    size_t keyset_cursor_size(size_t clause_count);
+
+    // Writes the sort key of row_ndx into cursor, which must hold keyset_cursor_size(column_indices.size()) bytes.
+    void write_keyset_cursor(const Table& table, size_t row_ndx, const std::vector<std::vector<size_t>>& column_indices, uint8_t* cursor);
+
+    // Restricts query to the rows that sort strictly after the sort key in cursor. Rows whose key is equal to the
+    // cursor's are excluded too, so the last sort clause should be unique, e.g. the primary key, for paging not to
+    // skip rows. Throws std::invalid_argument when the cursor wasn't written for the same sort clauses.
+    void add_keyset_condition(Query& query, const std::vector<std::vector<size_t>>& column_indices, const std::vector<bool>& ascending,
+                              const uint8_t* cursor, size_t cursor_size);
+
+} // namespace binding
+} // namespace realm
+
+#endif // KEYSET_CURSOR_HPP
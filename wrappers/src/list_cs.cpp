@@ -21,10 +21,12 @@
 #include "error_handling.hpp"
 #include "marshalling.hpp"
 #include "realm_export_decls.hpp"
+#include "handle_pool.hpp"
 #include "wrapper_exceptions.hpp"
 #include "object_accessor.hpp"
 #include "object-store/src/thread_safe_reference.hpp"
 #include "notifications_cs.hpp"
+#include "aggregate_cs.hpp"
 
 using namespace realm;
 using namespace realm::binding;
@@ -56,7 +58,7 @@ REALM_EXPORT Object* list_get(List* list, size_t link_ndx, NativeException::Mars
         if (link_ndx >= count)
             throw IndexOutOfRangeException("Get from RealmList", link_ndx, count);
         auto rowExpr = list->get(link_ndx);
-        return new Object(list->get_realm(), list->get_object_schema(), Row(rowExpr));
+        return create_handle<Object>(list->get_realm(), list->get_object_schema(), Row(rowExpr));
     });
 }
 
@@ -92,9 +94,32 @@ REALM_EXPORT size_t list_size(List* list, NativeException::Marshallable& ex)
     });
 }
   
+// Runs over the list's query, which visits every entry of the link list, so objects linked more than once are
+// counted once per link.
+REALM_EXPORT void list_aggregate(List& list, size_t property_ndx, AggregateType type, PrimitiveValue& result, NativeException::Marshallable& ex)
+{
+    handle_errors(ex, [&]() {
+        list.get_realm()->verify_thread();
+
+        auto& property = list.get_object_schema().persisted_properties.at(property_ndx);
+        auto query = list.get_query();
+        result = aggregate(query, property.table_column, type);
+    });
+}
+
+// Results over the objects of the list, in table order and with each object once however many times it is linked.
+REALM_EXPORT Results* list_get_results(List& list, NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        list.get_realm()->verify_thread();
+
+        return create_handle<Results>(list.get_realm(), list.get_query());
+    });
+}
+
 REALM_EXPORT void list_destroy(List* list)
 {
-    delete list;
+    destroy_handle(list);
 }
     
 REALM_EXPORT ManagedNotificationTokenContext* list_add_notification_callback(List* list, void* managed_list, ManagedNotificationCallback callback, NativeException::Marshallable& ex)
@@ -47,34 +47,15 @@ size_t realm::binding::stringdata_to_csharpstringbuffer(StringData str, uint16_t
     if (str.size() <= 0) {
         return 0;
     }
-    const char* in_begin = str.data();
-    const char* in_end = str.data() + str.size();
-
-    uint16_t* out_begin = csharpbuffer;
-    uint16_t* out_end = csharpbuffer + bufsize;
-
-    typedef realm::util::Utf8x16<uint16_t, std::char_traits<char16_t>>Xcode;    //This might not work in old compilers (the std::char_traits<char16_t> ). 
-
-    size_t size = Xcode::find_utf16_buf_size(in_begin, in_end);//Figure how much space is actually needed
-
-    if (in_begin != in_end) {
+    // No UTF-8 sequence decodes to more 16-bit units than it has bytes, so having passed the size check
+    // above the transcoded string is guaranteed to fit and we can decode in a single pass.
+    const size_t chars_used = utf::utf8_to_utf16(str.data(), str.size(), csharpbuffer);
+    if (chars_used == utf::invalid) {
         std::cerr << "BAD UTF8 DATA IN stringdata_tocsharpbuffer :" << str.data() << "\n";
-        return -1;//bad uft8 data    
+        return -1;//bad uft8 data
     }
-    if (size > bufsize)
-        return size; //bufsize is too small. Return needed size
 
-      //the transcoded string fits in the buffer
-
-    in_begin = str.data();
-    in_end = str.data() + str.size();
-
-    if (Xcode::to_utf16(in_begin, in_end, out_begin, out_end)) {
-        size_t chars_used = out_begin - csharpbuffer;
-        //csharpbuffer[chars_used-5]=0; //slightly ugly hack. C# looks for a null terminated string in the buffer, so we have to null terminate this string for C# to pick up where the end is
-        return (chars_used);        //transcode complete. return the number of 16-bit characters used in the buffer,excluding the null terminator
-    }
-    return -1;//bad utf8 data. this cannot happen
+    return chars_used;        //transcode complete. return the number of 16-bit characters used in the buffer,excluding the null terminator
 }
 
 
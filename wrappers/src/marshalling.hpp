@@ -20,7 +20,8 @@
 #define MARSHALLING_HPP
 
 #include <realm.hpp>
-#include <realm/util/utf8.hpp>
+#include "utf_transcoder.hpp"
+#include "scratch_arena.hpp"
 
 namespace realm {
 namespace binding {
@@ -31,63 +32,65 @@ public:
     {
         // For efficiency, if the incoming UTF-16 string is sufficiently
         // small, we will choose an UTF-8 output buffer whose size (in
-        // bytes) is simply 4 times the number of 16-bit elements in the
+        // bytes) is simply 3 times the number of 16-bit elements in the
         // input. This is guaranteed to be enough. However, to avoid
         // excessive over allocation, this is not done for larger input
         // strings.
 
         error = false;
-        typedef realm::util::Utf8x16<uint16_t, std::char_traits<char16_t>>Xcode;    //This might not work in old compilers (the std::char_traits<char16_t> ).     
         size_t max_project_size = 48;
 
-        REALM_ASSERT(max_project_size <= std::numeric_limits<size_t>::max() / 4);
+        REALM_ASSERT(max_project_size <= std::numeric_limits<size_t>::max() / 3);
 
         size_t u8buf_size;
         if (csbufsize <= max_project_size) {
-            u8buf_size = csbufsize * 4;
+            u8buf_size = csbufsize * 3;
         }
         else {
-            const uint16_t* begin = csbuffer;
-            const uint16_t* end = csbuffer + csbufsize;
-            u8buf_size = Xcode::find_utf8_buf_size(begin, end);
+            u8buf_size = utf::utf8_length(csbuffer, csbufsize);
         }
-        m_data.reset(new char[u8buf_size]);
-        {
-            const uint16_t* in_begin = csbuffer;
-            const uint16_t* in_end = csbuffer + csbufsize;
-            char* out_begin = m_data.get();
-            char* out_end = m_data.get() + u8buf_size;
-            if (!Xcode::to_utf8(in_begin, in_end, out_begin, out_end)) {
-                m_size = 0;
-                error = true;
-                return;//calling method should handle this. We can't throw exceptions
-            }
-            REALM_ASSERT(in_begin == in_end);
-            m_size = out_begin - m_data.get();
+        // Inside an export the buffer comes from the thread's scratch arena and is released when
+        // handle_errors returns. Huge strings, and strings converted outside of any export, go to the heap.
+        m_data = ScratchArena::current().allocate(u8buf_size);
+        if (m_data) {
+            ++ScratchArena::arena_allocations;
+        }
+        else {
+            m_heap_data.reset(new char[u8buf_size]);
+            m_data = m_heap_data.get();
+            ++ScratchArena::heap_allocations;
+        }
+
+        m_size = utf::utf16_to_utf8(csbuffer, csbufsize, m_data);
+        if (m_size == utf::invalid) {
+            m_size = 0;
+            error = true;
+            return;//calling method should handle this. We can't throw exceptions
         }
     }
 
     operator realm::StringData() const //ASD has this vanished from core? REALM_NOEXCEPT
     {
-        return realm::StringData(m_data.get(), m_size);
+        return realm::StringData(m_data, m_size);
     }
 
     std::string to_string() const
     {
-        return std::string(m_data.get(), m_size);
+        return std::string(m_data, m_size);
     }
 
     operator std::string() const noexcept
     {
-        return std::string(m_data.get(), m_size);
+        return std::string(m_data, m_size);
     }
     
-    const char* data() const { return m_data.get();  }
+    const char* data() const { return m_data;  }
     size_t size() const { return m_size;  }
 
     bool error;
 private:
-    std::unique_ptr<char[]> m_data;
+    char* m_data;
+    std::unique_ptr<char[]> m_heap_data;
     std::size_t m_size;
 };
 
@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef MATCH_SCAN_HPP
+#define MATCH_SCAN_HPP
+
+#include <algorithm>
+#include <realm.hpp>
+
+namespace realm {
+namespace binding {
+
+    // Matches are found one block of table rows at a time, so memory stays bounded by the block rather than by the
+    // number of matches.
+    const size_t scan_block_size = 1 << 16;
+
+    // Calls visit(row_ndx) for every row matching query, in table order, until it returns false. Returns false when
+    // the scan was stopped early.
+    template<typename Visitor>
+    bool for_each_match(Query& query, Visitor visit)
+    {
+        const size_t table_size = query.get_table()->size();
+        for (size_t begin = 0; begin < table_size; begin += scan_block_size) {
+            auto matches = query.find_all(begin, std::min(begin + scan_block_size, table_size));
+            for (size_t i = 0; i < matches.size(); ++i) {
+                if (!visit(matches.get_source_ndx(i)))
+                    return false;
+            }
+        }
+        return true;
+    }
+
+} // namespace binding
+} // namespace realm
+
+#endif // MATCH_SCAN_HPP
@@ -20,15 +20,130 @@
 #include "error_handling.hpp"
 #include "marshalling.hpp"
 #include "realm_export_decls.hpp"
+#include "handle_pool.hpp"
 #include "object_accessor.hpp"
 #include "timestamp_helpers.hpp"
 #include "object_cs.hpp"
 #include "object-store/src/thread_safe_reference.hpp"
 #include "notifications_cs.hpp"
+#include "shared_realm_cs.hpp"
 
 using namespace realm;
 using namespace realm::binding;
 
+namespace {
+
+void set_int_unique(Object& object, size_t column_ndx, int64_t value)
+{
+    realm::set_int_unique(object.realm(), *object.row().get_table(), object.row().get_index(), column_ndx, value);
+}
+
+void set_string_unique(Object& object, size_t column_ndx, StringData value)
+{
+    realm::set_string_unique(object.realm(), *object.row().get_table(), object.row().get_index(), column_ndx, value);
+}
+
+void set_null_unique(Object& object, size_t column_ndx)
+{
+    realm::set_null_unique(object.realm(), *object.row().get_table(), object.row().get_index(), column_ndx);
+}
+
+void verify_value(const Property& property, const PropertyValue& entry)
+{
+    if (entry.type == PropertyValueType::Null) {
+        if (!property.is_nullable && property.type != PropertyType::Object)
+            throw std::invalid_argument(util::format("Property '%1' is not nullable", property.name));
+    }
+    else if (entry.type != value_type_for(property)) {
+        throw std::invalid_argument(util::format("The value for property '%1' has the wrong type", property.name));
+    }
+
+    if (entry.is_primary_key && !property.is_primary)
+        throw std::invalid_argument(util::format("Property '%1' is not the primary key", property.name));
+}
+
+// For the setters that don't check uniqueness, which are not used for primary keys, but could be.
+void column_written(Object& object, size_t column_ndx)
+{
+    primary_key_column_written(object.realm(), *object.row().get_table(), column_ndx);
+}
+
+} // anonymous namespace
+
+namespace realm {
+
+PropertyValueType value_type_for(const Property& property)
+{
+    switch (property.type) {
+        case PropertyType::Bool: return PropertyValueType::Bool;
+        case PropertyType::Int: return PropertyValueType::Int;
+        case PropertyType::Float: return PropertyValueType::Float;
+        case PropertyType::Double: return PropertyValueType::Double;
+        case PropertyType::Date: return PropertyValueType::Timestamp;
+        case PropertyType::String: return PropertyValueType::String;
+        case PropertyType::Data: return PropertyValueType::Binary;
+        case PropertyType::Object: return PropertyValueType::Link;
+        default:
+            throw std::invalid_argument(util::format("Property '%1' can't be set through a value buffer", property.name));
+    }
+}
+
+void ReadVersionPins::add(ReadVersionPin* pin)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_live.insert(pin);
+}
+
+void ReadVersionPins::destroy(ReadVersionPin* pin)
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_closed) {
+            m_live.erase(pin);
+            if (pin->owner != std::this_thread::get_id()) {
+                m_pending.push_back(pin);
+                return;
+            }
+        }
+    }
+
+    // Either on the owning thread, or the reference was already released when the Realm closed.
+    delete pin;
+}
+
+void ReadVersionPins::release_pending()
+{
+    std::vector<ReadVersionPin*> pending;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pending.swap(m_pending);
+    }
+
+    for (auto pin : pending)
+        delete pin;
+}
+
+void ReadVersionPins::close()
+{
+    std::vector<ReadVersionPin*> pending;
+    std::vector<std::unique_ptr<ThreadSafeReference<Object>>> references;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        pending.swap(m_pending);
+        for (auto pin : m_live)
+            references.push_back(std::move(pin->reference));
+        m_live.clear();
+        m_closed = true;
+    }
+
+    // Destroying the references unpins their versions while the Realm is still open.
+    references.clear();
+    for (auto pin : pending)
+        delete pin;
+}
+
+} // namespace realm
+
 extern "C" {
     REALM_EXPORT bool object_get_is_valid(const Object& object, NativeException::Marshallable& ex)
     {
@@ -39,7 +154,7 @@ extern "C" {
 
     REALM_EXPORT void object_destroy(Object* object)
     {
-        delete object;
+        destroy_handle(object);
     }
 
     REALM_EXPORT size_t object_get_row_index(const Object& object, NativeException::Marshallable& ex)
@@ -63,9 +178,8 @@ extern "C" {
                 return nullptr;
 
             auto target_table_ptr = object.row().get_table()->get_link_target(column_ndx);
-            const std::string target_name(ObjectStore::object_type_for_table_name(target_table_ptr->get_name()));
-            auto& target_schema = *object.realm()->schema().find(target_name);
-            return new Object(object.realm(), target_schema, Row((*target_table_ptr)[link_row_ndx]));
+            auto& target_schema = object_schema_for_table(object.realm(), *target_table_ptr);
+            return create_handle<Object>(object.realm(), target_schema, Row((*target_table_ptr)[link_row_ndx]));
         });
     }
 
@@ -75,7 +189,7 @@ extern "C" {
             verify_can_get(object);
 
             const size_t column_ndx = get_column_index(object, property_ndx);
-            return new List(object.realm(), object.row().get_linklist(column_ndx));
+            return create_handle<List>(object.realm(), object.row().get_linklist(column_ndx));
         });
     }
 
@@ -201,6 +315,139 @@ extern "C" {
         });
     }
 
+    // Zero-copy alternative to object_get_string: returns a pointer to the UTF-8 bytes inside the mapped file.
+    // The pointer is only valid until the Realm advances to a newer version or is written to, unless the
+    // version has been pinned with object_pin_read_version first.
+    REALM_EXPORT const char* object_get_string_view(const Object& object, size_t property_ndx, size_t& size, bool* is_null, NativeException::Marshallable& ex)
+    {
+        return handle_errors(ex, [&]() -> const char* {
+            verify_can_get(object);
+
+            const size_t column_ndx = get_column_index(object, property_ndx);
+            const StringData fielddata(object.row().get_string(column_ndx));
+            size = fielddata.size();
+            if ((*is_null = fielddata.is_null()))
+                return nullptr;
+
+            return fielddata.data();
+        });
+    }
+
+    REALM_EXPORT ReadVersionPin* object_pin_read_version(const Object& object, NativeException::Marshallable& ex)
+    {
+        return handle_errors(ex, [&]() {
+            verify_can_get(object);
+
+            std::shared_ptr<ReadVersionPins> pins;
+            if (auto context = static_cast<CSharpBindingContext*>(object.realm()->m_binding_context.get())) {
+                auto& context_pins = context->read_version_pins();
+                if (!context_pins)
+                    context_pins = std::make_shared<ReadVersionPins>();
+                context_pins->release_pending();
+                pins = context_pins;
+            }
+
+            auto reference = std::make_unique<ThreadSafeReference<Object>>(object.realm()->obtain_thread_safe_reference(object));
+            auto pin = new ReadVersionPin{ std::move(reference), std::this_thread::get_id(), pins };
+            if (pins)
+                pins->add(pin);
+            return pin;
+        });
+    }
+
+    // Called from the finalizer thread as well as the Realm's own thread, see ReadVersionPins.
+    REALM_EXPORT void read_version_pin_destroy(ReadVersionPin* pin)
+    {
+        if (pin->pins)
+            pin->pins->destroy(pin);
+        else
+            delete pin;
+    }
+
+    // Reads every persisted property whose bit is set in mask (bit i of mask[i / 64] for property i) into
+    // consecutive slots of values, validating the object only once. Binary, link and list properties are not
+    // read and their slots are left without a value. Throws if more properties are selected than values has
+    // slots for. Returns the number of 16-bit units the strings need;
+    // if that is more than string_buffer_size the string slots are not valid and the call should be repeated
+    // with a larger buffer.
+    REALM_EXPORT size_t object_get_values(const Object& object, const uint64_t* mask, size_t mask_words, PrimitiveValue* values, size_t values_count, uint16_t* string_buffer, size_t string_buffer_size, NativeException::Marshallable& ex)
+    {
+        return handle_errors(ex, [&]() {
+            verify_can_get(object);
+
+            const Row& row = object.row();
+            const auto& properties = object.get_object_schema().persisted_properties;
+            const size_t property_count = std::min(properties.size(), mask_words * 64);
+
+            size_t selected_count = 0;
+            for (size_t property_ndx = 0; property_ndx < property_count; ++property_ndx) {
+                if (mask[property_ndx / 64] & (uint64_t(1) << (property_ndx % 64)))
+                    ++selected_count;
+            }
+            if (selected_count > values_count)
+                throw std::invalid_argument(util::format("The mask selects %1 properties but there are only %2 value slots", selected_count, values_count));
+
+            size_t string_units = 0;
+            PrimitiveValue* value = values;
+            for (size_t property_ndx = 0; property_ndx < property_count; ++property_ndx) {
+                if (!(mask[property_ndx / 64] & (uint64_t(1) << (property_ndx % 64))))
+                    continue;
+
+                const Property& property = properties[property_ndx];
+                const size_t column_ndx = property.table_column;
+                PrimitiveValue& slot = *value++;
+
+                slot.has_value = false;
+                if (property.is_nullable && row.is_null(column_ndx))
+                    continue;
+
+                switch (property.type) {
+                    case PropertyType::Bool:
+                        slot.value.bool_value = row.get_bool(column_ndx);
+                        break;
+                    case PropertyType::Int:
+                        slot.value.int_value = row.get_int(column_ndx);
+                        break;
+                    case PropertyType::Float:
+                        slot.value.float_value = row.get_float(column_ndx);
+                        break;
+                    case PropertyType::Double:
+                        slot.value.double_value = row.get_double(column_ndx);
+                        break;
+                    case PropertyType::Date:
+                        slot.value.ticks = to_ticks(row.get_timestamp(column_ndx));
+                        break;
+                    case PropertyType::String: {
+                        const StringData fielddata(row.get_string(column_ndx));
+                        if (fielddata.is_null())
+                            continue;
+
+                        // The decoded string is never longer than the UTF-8 data, so reserve that much up front.
+                        slot.value.string.offset = static_cast<uint32_t>(string_units);
+                        if (string_units + fielddata.size() <= string_buffer_size) {
+                            const size_t length = utf::utf8_to_utf16(fielddata.data(), fielddata.size(), string_buffer + string_units);
+                            if (length == utf::invalid)
+                                throw std::runtime_error("Corrupted string data");
+
+                            slot.value.string.length = static_cast<uint32_t>(length);
+                            string_units += length;
+                        }
+                        else {
+                            slot.value.string.length = 0;
+                            string_units += fielddata.size();
+                        }
+                        break;
+                    }
+                    default:
+                        continue;
+                }
+                slot.has_value = true;
+            }
+
+            return string_units;
+        });
+    }
+
     REALM_EXPORT size_t object_get_binary(const Object& object, size_t property_ndx, char* return_buffer, size_t buffer_size, bool* is_null, NativeException::Marshallable& ex)
     {
         return handle_errors(ex, [&]() {
@@ -220,6 +467,38 @@ extern "C" {
         });
     }
 
+    REALM_EXPORT size_t object_get_binary_size(const Object& object, size_t property_ndx, bool* is_null, NativeException::Marshallable& ex)
+    {
+        return handle_errors(ex, [&]() {
+            verify_can_get(object);
+
+            const size_t column_ndx = get_column_index(object, property_ndx);
+            const BinaryData fielddata = object.row().get_binary(column_ndx);
+
+            *is_null = fielddata.is_null();
+            return fielddata.size();
+        });
+    }
+
+    // Copies up to buffer_size bytes starting at offset and returns the number of bytes copied,
+    // which is 0 once offset reaches the end of the value.
+    REALM_EXPORT size_t object_get_binary_chunk(const Object& object, size_t property_ndx, size_t offset, char* return_buffer, size_t buffer_size, bool* is_null, NativeException::Marshallable& ex)
+    {
+        return handle_errors(ex, [&]() {
+            verify_can_get(object);
+
+            const size_t column_ndx = get_column_index(object, property_ndx);
+            const BinaryData fielddata = object.row().get_binary(column_ndx);
+
+            if ((*is_null = fielddata.is_null()) || offset >= fielddata.size())
+                return (size_t)0;
+
+            const size_t chunk_size = std::min(buffer_size, fielddata.size() - offset);
+            std::copy(fielddata.data() + offset, fielddata.data() + offset + chunk_size, return_buffer);
+            return chunk_size;
+        });
+    }
+
     REALM_EXPORT int64_t object_get_timestamp_ticks(const Object& object, size_t property_ndx, NativeException::Marshallable& ex)
     {
         return handle_errors(ex, [&]() {
@@ -256,7 +535,7 @@ extern "C" {
             const Property& link = *relationship.property_for_name(prop.link_origin_property_name);
 
             TableView backlink_view = object.row().get_table()->get_backlink_view(object.row().get_index(), table.get(), link.table_column);
-            return new Results(object.realm(), backlink_view);
+            return create_handle<Results>(object.realm(), backlink_view);
         });
     }
 
@@ -290,6 +569,7 @@ extern "C" {
                 throw std::invalid_argument("Column is not nullable");
 
             object.row().set_null(column_ndx);
+            column_written(object, column_ndx);
         });
     }
 
@@ -298,21 +578,7 @@ extern "C" {
         return handle_errors(ex, [&]() {
             verify_can_set(object);
 
-            const size_t column_ndx = get_column_index(object, property_ndx);
-            if (!object.row().get_table()->is_nullable(column_ndx))
-                throw std::invalid_argument("Column is not nullable");
-
-            auto existing = object.row().get_table()->find_first_null(column_ndx);
-            if (existing != object.row().get_index()) {
-                if (existing != not_found) {
-                    throw SetDuplicatePrimaryKeyValueException(
-                        object.row().get_table()->get_name(),
-                        object.row().get_table()->get_column_name(column_ndx),
-                        "null");
-                }
-            }
-
-            object.row().set_null_unique(column_ndx);
+            set_null_unique(object, get_column_index(object, property_ndx));
         });
     }
 
@@ -332,6 +598,7 @@ extern "C" {
 
             const size_t column_ndx = get_column_index(object, property_ndx);
             object.row().set_int(column_ndx, value);
+            column_written(object, column_ndx);
         });
     }
 
@@ -340,19 +607,7 @@ extern "C" {
         return handle_errors(ex, [&]() {
             verify_can_set(object);
 
-            const size_t column_ndx = get_column_index(object, property_ndx);
-            auto existing = object.row().get_table()->find_first_int(column_ndx, value);
-            if (existing != object.row().get_index()) {
-                if (existing != not_found) {
-                    throw SetDuplicatePrimaryKeyValueException(
-                        object.row().get_table()->get_name(),
-                        object.row().get_table()->get_column_name(column_ndx),
-                        util::format("%1", value)
-                    );
-                }
-            }
-
-            object.row().set_int_unique(column_ndx, value);
+            set_int_unique(object, get_column_index(object, property_ndx), value);
         });
     }
 
@@ -383,6 +638,7 @@ extern "C" {
             const size_t column_ndx = get_column_index(object, property_ndx);
             Utf16StringAccessor str(value, value_len);
             object.row().set_string(column_ndx, str);
+            column_written(object, column_ndx);
         });
     }
 
@@ -391,20 +647,89 @@ extern "C" {
         return handle_errors(ex, [&]() {
             verify_can_set(object);
 
-            const size_t column_ndx = get_column_index(object, property_ndx);
             Utf16StringAccessor str(value, value_len);
-            auto existing = object.row().get_table()->find_first_string(column_ndx, str);
-            if (existing != object.row().get_index()) {
-                if (object.row().get_table()->find_first_string(column_ndx, str) != not_found) {
-                    throw SetDuplicatePrimaryKeyValueException(
-                        object.row().get_table()->get_name(),
-                        object.row().get_table()->get_column_name(column_ndx),
-                        str.to_string()
-                    );
+            set_string_unique(object, get_column_index(object, property_ndx), str);
+        });
+    }
+
+    // Applies a packed buffer of property values to the object in one call, validating it only once.
+    // Entries marked as primary keys get the same uniqueness checks as the *_unique setters. Entries whose type
+    // doesn't match their property are rejected before anything is written.
+    REALM_EXPORT void object_set_values(Object& object, const PropertyValue* values, size_t values_count, const uint16_t* string_pool, const char* binary_pool, NativeException::Marshallable& ex)
+    {
+        handle_errors(ex, [&]() {
+            verify_can_set(object);
+
+            // Check every entry first, so that a malformed buffer doesn't leave the object half written.
+            const auto& properties = object.get_object_schema().persisted_properties;
+            for (const PropertyValue* entry = values; entry != values + values_count; ++entry)
+                verify_value(properties.at(entry->property_ndx), *entry);
+
+            auto&& row = object.row();
+            for (const PropertyValue* entry = values; entry != values + values_count; ++entry) {
+                const size_t column_ndx = properties[entry->property_ndx].table_column;
+
+                switch (entry->type) {
+                    case PropertyValueType::Null:
+                        if (properties[entry->property_ndx].type == PropertyType::Object) {
+                            row.nullify_link(column_ndx);
+                        }
+                        else if (entry->is_primary_key) {
+                            set_null_unique(object, column_ndx);
+                        }
+                        else {
+                            row.set_null(column_ndx);
+                            column_written(object, column_ndx);
+                        }
+                        break;
+                    case PropertyValueType::Bool:
+                        row.set_bool(column_ndx, entry->value.bool_value);
+                        break;
+                    case PropertyValueType::Int:
+                        if (entry->is_primary_key)
+                            set_int_unique(object, column_ndx, entry->value.int_value);
+                        else {
+                            row.set_int(column_ndx, entry->value.int_value);
+                            column_written(object, column_ndx);
+                        }
+                        break;
+                    case PropertyValueType::Float:
+                        row.set_float(column_ndx, entry->value.float_value);
+                        break;
+                    case PropertyValueType::Double:
+                        row.set_double(column_ndx, entry->value.double_value);
+                        break;
+                    case PropertyValueType::Timestamp:
+                        row.set_timestamp(column_ndx, from_ticks(entry->value.ticks));
+                        break;
+                    case PropertyValueType::String: {
+                        Utf16StringAccessor str(string_pool + entry->value.data.offset, entry->value.data.length);
+                        if (entry->is_primary_key)
+                            set_string_unique(object, column_ndx, str);
+                        else {
+                            row.set_string(column_ndx, str);
+                            column_written(object, column_ndx);
+                        }
+                        break;
+                    }
+                    case PropertyValueType::Binary: {
+                        // a BinaryData with a null pointer would be a null value, so an empty blob needs a dummy pointer
+                        const char* data = binary_pool ? binary_pool + entry->value.data.offset : "";
+                        row.set_binary(column_ndx, BinaryData(data, entry->value.data.length));
+                        break;
+                    }
+                    case PropertyValueType::Link: {
+                        const TableRef target_table = row.get_table()->get_link_target(column_ndx);
+                        if (entry->value.link_row >= target_table->size())
+                            throw std::out_of_range("Link target row index out of range");
+
+                        row.set_link(column_ndx, static_cast<size_t>(entry->value.link_row));
+                        break;
+                    }
+                    default:
+                        throw std::invalid_argument("Unknown property value type");
                 }
             }
-
-            object.row().set_string_unique(column_ndx, str);
         });
     }
 
@@ -418,6 +743,44 @@ extern "C" {
         });
     }
 
+    REALM_EXPORT BinaryWriter* object_open_binary_writer(Object& object, size_t property_ndx, size_t expected_size, NativeException::Marshallable& ex)
+    {
+        return handle_errors(ex, [&]() {
+            verify_can_set(object);
+
+            auto writer = new BinaryWriter{ object, get_column_index(object, property_ndx), {} };
+            writer->buffer.reserve(expected_size);
+            return writer;
+        });
+    }
+
+    REALM_EXPORT void binary_writer_append(BinaryWriter& writer, char* value, size_t value_len, NativeException::Marshallable& ex)
+    {
+        handle_errors(ex, [&]() {
+            verify_can_set(writer.object);
+
+            writer.buffer.insert(writer.buffer.end(), value, value + value_len);
+        });
+    }
+
+    REALM_EXPORT void binary_writer_commit(BinaryWriter& writer, NativeException::Marshallable& ex)
+    {
+        handle_errors(ex, [&]() {
+            verify_can_set(writer.object);
+
+            // a BinaryData with a null pointer would be a null value, so an empty blob needs a dummy pointer
+            const char* data = writer.buffer.empty() ? "" : writer.buffer.data();
+            writer.object.row().set_binary(writer.column_ndx, BinaryData(data, writer.buffer.size()));
+
+            std::vector<char>().swap(writer.buffer);
+        });
+    }
+
+    REALM_EXPORT void binary_writer_destroy(BinaryWriter* writer)
+    {
+        delete writer;
+    }
+
     REALM_EXPORT void object_set_timestamp_ticks(Object& object, size_t property_ndx, int64_t value, NativeException::Marshallable& ex)
     {
         return handle_errors(ex, [&]() {
@@ -438,6 +801,7 @@ extern "C" {
             verify_can_set(object);
 
             auto const row_index = object.row().get_index();
+            primary_key_row_removing(realm, *object.row().get_table(), row_index);
             object.row().get_table()->move_last_over(row_index);
         });
     }
@@ -16,8 +16,20 @@
 //
 ////////////////////////////////////////////////////////////////////////////
 
+#ifndef OBJECT_CS_HPP
+#define OBJECT_CS_HPP
+
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
 #include "object_accessor.hpp"
 #include "shared_realm_cs.hpp"
+#include "primary_key_index.hpp"
+#include "object-store/src/thread_safe_reference.hpp"
+#include "error_handling.hpp"
+#include "util/format.hpp"
 
 using namespace realm;
 using namespace realm::binding;
@@ -46,4 +58,155 @@ namespace realm {
     inline size_t get_column_index(const Object& object, const size_t property_index) {
         return object.get_object_schema().persisted_properties[property_index].table_column;
     }
+
+    inline void verify_nullable(const Table& table, size_t column_ndx) {
+        if (!table.is_nullable(column_ndx))
+            throw std::invalid_argument("Column is not nullable");
+    }
+
+    inline void throw_duplicate_primary_key(const Table& table, size_t column_ndx, std::string value) {
+        throw SetDuplicatePrimaryKeyValueException(table.get_name(), table.get_column_name(column_ndx), std::move(value));
+    }
+
+    // Primary key setters that refuse to take a value some other row already has. The check goes through the
+    // primary key index of the Realm's binding context, which they keep up to date, also for a row that was just
+    // added with the default key when setting its key fails.
+    inline void set_int_unique(const SharedRealm& realm, Table& table, size_t row_ndx, size_t column_ndx, int64_t value) {
+        PrimaryKeyUpdate update(realm, table, column_ndx, row_ndx);
+        if (find_primary_key(realm, table, column_ndx, value, row_ndx) != not_found)
+            throw_duplicate_primary_key(table, column_ndx, util::format("%1", value));
+
+        table.set_int_unique(column_ndx, row_ndx, value);
+    }
+
+    inline void set_string_unique(const SharedRealm& realm, Table& table, size_t row_ndx, size_t column_ndx, StringData value) {
+        PrimaryKeyUpdate update(realm, table, column_ndx, row_ndx);
+        if (find_primary_key(realm, table, column_ndx, value, row_ndx) != not_found)
+            throw_duplicate_primary_key(table, column_ndx, std::string(value));
+
+        table.set_string_unique(column_ndx, row_ndx, value);
+    }
+
+    inline void set_null_unique(const SharedRealm& realm, Table& table, size_t row_ndx, size_t column_ndx) {
+        verify_nullable(table, column_ndx);
+
+        PrimaryKeyUpdate update(realm, table, column_ndx, row_ndx);
+        if (find_null_primary_key(realm, table, column_ndx, row_ndx) != not_found)
+            throw_duplicate_primary_key(table, column_ndx, "null");
+
+        table.set_null_unique(column_ndx, row_ndx);
+    }
+
+    class ReadVersionPins;
+
+    // Holding a thread safe reference pins the read version it was obtained at, which keeps the memory
+    // backing that version (and so any string or binary views into it) alive after the Realm moves on.
+    // Destroying the reference unpins the version through the Realm of the calling thread, so it must only
+    // happen on the thread that owns the Realm while the Realm is open; ReadVersionPins takes care of that.
+    struct ReadVersionPin {
+        std::unique_ptr<ThreadSafeReference<Object>> reference;
+        std::thread::id owner;
+        std::shared_ptr<ReadVersionPins> pins;  // null for Realms without a binding context
+    };
+
+    // The pins of one Realm. Pins released from another thread, such as the finalizer thread, are queued and
+    // destroyed by the owning thread the next time it pins a version or the Realm changes, and closing the
+    // Realm unpins everything that is left, after which pins can be freed from any thread.
+    class ReadVersionPins {
+    public:
+        void add(ReadVersionPin* pin);
+        void destroy(ReadVersionPin* pin);
+
+        // Both must be called on the thread that owns the Realm.
+        void release_pending();
+        void close();
+
+    private:
+        std::mutex m_mutex;
+        std::unordered_set<ReadVersionPin*> m_live;
+        std::vector<ReadVersionPin*> m_pending;
+        bool m_closed = false;
+    };
+
+    // Accumulates a binary value that is passed in chunks and sets it on the object in one go when committed,
+    // as core has no way to append to an existing blob.
+    struct BinaryWriter {
+        Object object;
+        size_t column_ndx;
+        std::vector<char> buffer;
+    };
+
+    // One slot of the packed buffer filled by object_get_values. Must stay in sync with PrimitiveValue.cs.
+    // Strings are decoded into a separate UTF-16 buffer and the slot records where, in 16-bit units.
+    struct alignas(8) PrimitiveValue {
+        union {
+            bool bool_value;
+            int64_t int_value;
+            float float_value;
+            double double_value;
+            int64_t ticks;
+            struct {
+                uint32_t offset;
+                uint32_t length;
+            } string;
+        } value;
+        bool has_value;
+    };
+    static_assert(sizeof(PrimitiveValue) == 16, "PrimitiveValue must match its managed layout");
+
+    enum class PropertyValueType : uint8_t {
+        Null,
+        Bool,
+        Int,
+        Float,
+        Double,
+        Timestamp,
+        String,
+        Binary,
+        Link
+    };
+
+    // The type tag a value of property is passed with, besides Null. Throws for properties that can't be
+    // passed as a single value, such as lists.
+    PropertyValueType value_type_for(const Property& property);
+
+    // One entry of the packed buffer applied by object_set_values. Must stay in sync with PropertyValue.cs.
+    // String and binary values point into pools that are passed alongside the entries, in 16-bit units and
+    // bytes respectively. Links are given as a row index in the target table.
+    struct alignas(8) PropertyValue {
+        uint32_t property_ndx;
+        PropertyValueType type;
+        bool is_primary_key;
+        union {
+            bool bool_value;
+            int64_t int_value;
+            float float_value;
+            double double_value;
+            int64_t ticks;
+            struct {
+                uint32_t offset;
+                uint32_t length;
+            } data;
+            uint64_t link_row;
+        } value;
+    };
+    static_assert(sizeof(PropertyValue) == 16, "PropertyValue must match its managed layout");
+
+    // The values of one property for all the rows inserted by table_add_objects. Must stay in sync with ColumnData.cs.
+    // values points to row_count elements of bool (one byte each), int64_t, float, double or int64_t ticks. For
+    // strings it points to a UTF-16 pool and offsets holds row_count + 1 offsets into it, in 16-bit units.
+    // Bit i of null_bitmap (least significant bit first) marks row i as null; it may be null if no row is.
+    struct ColumnData {
+        size_t property_ndx;
+        PropertyValueType type;
+        const void* values;
+        const uint32_t* offsets;
+        const uint8_t* null_bitmap;
+
+        bool is_null(size_t row) const {
+            return null_bitmap && (null_bitmap[row / 8] & (1 << (row % 8)));
+        }
+    };
 }
+
+#endif // OBJECT_CS_HPP
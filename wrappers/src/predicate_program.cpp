@@ -0,0 +1,386 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <realm.hpp>
+#include <realm/query_expression.hpp>
+#include "predicate_program.hpp"
+#include "marshalling.hpp"
+#include "timestamp_helpers.hpp"
+#include "util/format.hpp"
+
+using namespace realm;
+using namespace realm::binding;
+
+namespace {
+
+[[noreturn]] void throw_malformed()
+{
+    throw std::invalid_argument("Malformed predicate program");
+}
+
+DataType column_type_for(PropertyValueType type)
+{
+    switch (type) {
+        case PropertyValueType::Bool:
+            return type_Bool;
+        case PropertyValueType::Int:
+            return type_Int;
+        case PropertyValueType::Float:
+            return type_Float;
+        case PropertyValueType::Double:
+            return type_Double;
+        case PropertyValueType::Timestamp:
+            return type_Timestamp;
+        case PropertyValueType::String:
+            return type_String;
+        case PropertyValueType::Binary:
+            return type_Binary;
+        default:
+            throw_malformed();
+    }
+}
+
+class ProgramRunner {
+public:
+    ProgramRunner(Query& query, const PredicateProgram& program) : m_query(query), m_program(program) { }
+
+    // Groups don't have to be balanced within one program: the managed side flushes a partial program before conditions
+    // it can't encode, so a group may open in one program and close in the next. Query itself tracks the nesting.
+    void run()
+    {
+        for (size_t i = 0; i < m_program.instruction_count; ++i) {
+            const PredicateInstruction& instruction = m_program.instructions[i];
+            switch (instruction.op_code) {
+                case PredicateOpCode::BeginGroup:
+                    m_query.group();
+                    break;
+                case PredicateOpCode::EndGroup:
+                    m_query.end_group();
+                    break;
+                case PredicateOpCode::Or:
+                    m_query.Or();
+                    break;
+                case PredicateOpCode::Not:
+                    m_query.Not();
+                    break;
+                case PredicateOpCode::Compare:
+                    if (instruction.link_count == 0)
+                        compare_column(instruction);
+                    else
+                        compare_link(instruction);
+                    break;
+                default:
+                    throw_malformed();
+            }
+        }
+    }
+
+private:
+    Query& m_query;
+    const PredicateProgram& m_program;
+
+    const PrimitiveValue& literal(const PredicateInstruction& instruction) const
+    {
+        if (instruction.literal_ndx >= m_program.literal_count)
+            throw_malformed();
+        return m_program.literals[instruction.literal_ndx];
+    }
+
+    // A literal without a value compares as null, which is how prepared queries bind null to a parameter.
+    PropertyValueType compared_type(const PredicateInstruction& instruction) const
+    {
+        if (instruction.type != PropertyValueType::Null && !literal(instruction).has_value)
+            return PropertyValueType::Null;
+        return instruction.type;
+    }
+
+    StringData string_literal(const PredicateInstruction& instruction, std::unique_ptr<Utf16StringAccessor>& holder) const
+    {
+        auto& value = literal(instruction).value.string;
+        if (size_t(value.offset) + value.length > m_program.string_pool_size)
+            throw_malformed();
+        holder.reset(new Utf16StringAccessor(m_program.string_pool + value.offset, value.length));
+        return *holder;
+    }
+
+    BinaryData binary_literal(const PredicateInstruction& instruction) const
+    {
+        auto& value = literal(instruction).value.string;
+        if (size_t(value.offset) + value.length > m_program.binary_pool_size)
+            throw_malformed();
+
+        // An empty binary literal still has to be non-null to match empty values rather than null ones.
+        return value.length == 0 ? BinaryData("", 0) : BinaryData(m_program.binary_pool + value.offset, value.length);
+    }
+
+    // Checks that the instruction's column exists on table and holds the type of its literal, returning that type.
+    DataType verify_column(const Table& table, const PredicateInstruction& instruction) const
+    {
+        if (instruction.column_ndx >= table.get_column_count())
+            throw_malformed();
+
+        auto type = table.get_column_type(instruction.column_ndx);
+        if (instruction.type != PropertyValueType::Null && column_type_for(instruction.type) != type)
+            throw std::invalid_argument(util::format("Property '%1' can't be compared with this value", table.get_column_name(instruction.column_ndx)));
+        return type;
+    }
+
+    template<typename T>
+    void compare_value(size_t column_ndx, PredicateComparison comparison, T value)
+    {
+        switch (comparison) {
+            case PredicateComparison::Equal:
+                m_query.equal(column_ndx, value);
+                break;
+            case PredicateComparison::NotEqual:
+                m_query.not_equal(column_ndx, value);
+                break;
+            case PredicateComparison::Less:
+                m_query.less(column_ndx, value);
+                break;
+            case PredicateComparison::LessEqual:
+                m_query.less_equal(column_ndx, value);
+                break;
+            case PredicateComparison::Greater:
+                m_query.greater(column_ndx, value);
+                break;
+            case PredicateComparison::GreaterEqual:
+                m_query.greater_equal(column_ndx, value);
+                break;
+            default:
+                throw_malformed();
+        }
+    }
+
+    void compare_column(const PredicateInstruction& instruction)
+    {
+        const size_t column_ndx = instruction.column_ndx;
+        verify_column(*m_query.get_table(), instruction);
+
+        switch (compared_type(instruction)) {
+            case PropertyValueType::Null:
+                if (instruction.comparison == PredicateComparison::Equal)
+                    m_query.equal(column_ndx, null());
+                else if (instruction.comparison == PredicateComparison::NotEqual)
+                    m_query.not_equal(column_ndx, null());
+                else
+                    throw_malformed();
+                break;
+            case PropertyValueType::Bool:
+                if (instruction.comparison == PredicateComparison::Equal)
+                    m_query.equal(column_ndx, literal(instruction).value.bool_value);
+                else if (instruction.comparison == PredicateComparison::NotEqual)
+                    m_query.not_equal(column_ndx, literal(instruction).value.bool_value);
+                else
+                    throw_malformed();
+                break;
+            case PropertyValueType::Int:
+                compare_value(column_ndx, instruction.comparison, literal(instruction).value.int_value);
+                break;
+            case PropertyValueType::Float:
+                compare_value(column_ndx, instruction.comparison, literal(instruction).value.float_value);
+                break;
+            case PropertyValueType::Double:
+                compare_value(column_ndx, instruction.comparison, literal(instruction).value.double_value);
+                break;
+            case PropertyValueType::Timestamp:
+                compare_value(column_ndx, instruction.comparison, from_ticks(literal(instruction).value.ticks));
+                break;
+            case PropertyValueType::String: {
+                std::unique_ptr<Utf16StringAccessor> holder;
+                auto value = string_literal(instruction, holder);
+                const bool case_sensitive = instruction.case_sensitive;
+                switch (instruction.comparison) {
+                    case PredicateComparison::Equal:
+                        m_query.equal(column_ndx, value, case_sensitive);
+                        break;
+                    case PredicateComparison::NotEqual:
+                        m_query.not_equal(column_ndx, value, case_sensitive);
+                        break;
+                    case PredicateComparison::BeginsWith:
+                        m_query.begins_with(column_ndx, value, case_sensitive);
+                        break;
+                    case PredicateComparison::EndsWith:
+                        m_query.ends_with(column_ndx, value, case_sensitive);
+                        break;
+                    case PredicateComparison::Contains:
+                        m_query.contains(column_ndx, value, case_sensitive);
+                        break;
+                    case PredicateComparison::Like:
+                        m_query.like(column_ndx, value, case_sensitive);
+                        break;
+                    default:
+                        throw_malformed();
+                }
+                break;
+            }
+            case PropertyValueType::Binary:
+                if (instruction.comparison == PredicateComparison::Equal)
+                    m_query.equal(column_ndx, binary_literal(instruction));
+                else if (instruction.comparison == PredicateComparison::NotEqual)
+                    m_query.not_equal(column_ndx, binary_literal(instruction));
+                else
+                    throw_malformed();
+                break;
+            default:
+                throw_malformed();
+        }
+    }
+
+    // Follows the instruction's links with Table::link(), which the next call to Table::column() consumes.
+    template<typename T>
+    Columns<T> link_column(const PredicateInstruction& instruction)
+    {
+        Table& table = *m_query.get_table();
+        for (size_t i = 0; i < instruction.link_count; ++i)
+            table.link(m_program.link_columns[instruction.link_offset + i]);
+        return table.column<T>(instruction.column_ndx);
+    }
+
+    template<typename T, typename Value>
+    Query compare_link_value(const PredicateInstruction& instruction, Value value)
+    {
+        switch (instruction.comparison) {
+            case PredicateComparison::Equal:
+                return link_column<T>(instruction) == value;
+            case PredicateComparison::NotEqual:
+                return link_column<T>(instruction) != value;
+            case PredicateComparison::Less:
+                return link_column<T>(instruction) < value;
+            case PredicateComparison::LessEqual:
+                return link_column<T>(instruction) <= value;
+            case PredicateComparison::Greater:
+                return link_column<T>(instruction) > value;
+            case PredicateComparison::GreaterEqual:
+                return link_column<T>(instruction) >= value;
+            default:
+                throw_malformed();
+        }
+    }
+
+    template<typename T, typename Value>
+    Query compare_link_equality(const PredicateInstruction& instruction, Value value)
+    {
+        if (instruction.comparison == PredicateComparison::Equal)
+            return link_column<T>(instruction) == value;
+        if (instruction.comparison == PredicateComparison::NotEqual)
+            return link_column<T>(instruction) != value;
+        throw_malformed();
+    }
+
+    Query compare_link_string(const PredicateInstruction& instruction, StringData value)
+    {
+        auto column = link_column<String>(instruction);
+        const bool case_sensitive = instruction.case_sensitive;
+        switch (instruction.comparison) {
+            case PredicateComparison::Equal:
+                return column.equal(value, case_sensitive);
+            case PredicateComparison::NotEqual:
+                return column.not_equal(value, case_sensitive);
+            case PredicateComparison::BeginsWith:
+                return column.begins_with(value, case_sensitive);
+            case PredicateComparison::EndsWith:
+                return column.ends_with(value, case_sensitive);
+            case PredicateComparison::Contains:
+                return column.contains(value, case_sensitive);
+            case PredicateComparison::Like:
+                return column.like(value, case_sensitive);
+            default:
+                throw_malformed();
+        }
+    }
+
+    Query compare_link_null(const PredicateInstruction& instruction, DataType column_type)
+    {
+        switch (column_type) {
+            case type_Bool:
+                return compare_link_equality<Bool>(instruction, null());
+            case type_Int:
+                return compare_link_equality<Int>(instruction, null());
+            case type_Float:
+                return compare_link_equality<Float>(instruction, null());
+            case type_Double:
+                return compare_link_equality<Double>(instruction, null());
+            case type_Timestamp:
+                return compare_link_equality<Timestamp>(instruction, null());
+            case type_String:
+                return compare_link_string(instruction, StringData());
+            default:
+                throw std::invalid_argument("Null comparisons through links are only supported for bool, int, float, double, date and string properties");
+        }
+    }
+
+    void compare_link(const PredicateInstruction& instruction)
+    {
+        if (size_t(instruction.link_offset) + instruction.link_count > m_program.link_column_count)
+            throw_malformed();
+
+        // Validate the path up front, so a bad program fails with an exception rather than an assertion in core.
+        const Table* target = m_query.get_table().get();
+        for (size_t i = 0; i < instruction.link_count; ++i) {
+            const size_t link_ndx = m_program.link_columns[instruction.link_offset + i];
+            if (link_ndx >= target->get_column_count() || target->get_column_type(link_ndx) != type_Link)
+                throw_malformed();
+            target = target->get_link_target(link_ndx).get();
+        }
+        const DataType column_type = verify_column(*target, instruction);
+
+        Query condition;
+        switch (compared_type(instruction)) {
+            case PropertyValueType::Null:
+                condition = compare_link_null(instruction, column_type);
+                break;
+            case PropertyValueType::Bool:
+                condition = compare_link_equality<Bool>(instruction, literal(instruction).value.bool_value);
+                break;
+            case PropertyValueType::Int:
+                condition = compare_link_value<Int>(instruction, literal(instruction).value.int_value);
+                break;
+            case PropertyValueType::Float:
+                condition = compare_link_value<Float>(instruction, literal(instruction).value.float_value);
+                break;
+            case PropertyValueType::Double:
+                condition = compare_link_value<Double>(instruction, literal(instruction).value.double_value);
+                break;
+            case PropertyValueType::Timestamp:
+                condition = compare_link_value<Timestamp>(instruction, from_ticks(literal(instruction).value.ticks));
+                break;
+            case PropertyValueType::String: {
+                std::unique_ptr<Utf16StringAccessor> holder;
+                condition = compare_link_string(instruction, string_literal(instruction, holder));
+                break;
+            }
+            default:
+                throw std::invalid_argument("Only bool, int, float, double, date and string properties can be compared through links");
+        }
+        m_query.and_query(condition);
+    }
+};
+
+}
+
+namespace realm {
+namespace binding {
+
+void apply_predicate_program(Query& query, const PredicateProgram& program)
+{
+    ProgramRunner(query, program).run();
+}
+
+} // namespace binding
+} // namespace realm
@@ -0,0 +1,87 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef PREDICATE_PROGRAM_HPP
+#define PREDICATE_PROGRAM_HPP
+
+#include "object_cs.hpp"
+
+namespace realm {
+namespace binding {
+
+    // Must stay in sync with PredicateProgram.cs
+    enum class PredicateOpCode : uint8_t {
+        BeginGroup,
+        EndGroup,
+        Or,
+        Not,
+        Compare
+    };
+
+    enum class PredicateComparison : uint8_t {
+        Equal,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual,
+        BeginsWith,
+        EndsWith,
+        Contains,
+        Like
+    };
+
+    // One step of a predicate program. Compare instructions compare the column with the literal at literal_ndx,
+    // or with null when type is Null. When link_count is not 0 the column is on the table reached by following the
+    // link columns link_columns[link_offset..link_offset + link_count) from the queried table.
+    struct PredicateInstruction {
+        PredicateOpCode op_code;
+        PredicateComparison comparison;
+        PropertyValueType type;
+        bool case_sensitive;
+        uint32_t column_ndx;
+        uint32_t literal_ndx;
+        uint32_t link_offset;
+        uint32_t link_count;
+    };
+    static_assert(sizeof(PredicateInstruction) == 20, "PredicateInstruction must match its managed layout");
+
+    // A predicate program with its pools. String literals are offsets and lengths into string_pool in 16-bit units,
+    // binary literals into binary_pool in bytes; dates are .NET ticks. A literal whose has_value is false compares as
+    // null, so only Equal and NotEqual can use it.
+    struct PredicateProgram {
+        const PredicateInstruction* instructions;
+        size_t instruction_count;
+        const PrimitiveValue* literals;
+        size_t literal_count;
+        const uint16_t* string_pool;
+        size_t string_pool_size;
+        const char* binary_pool;
+        size_t binary_pool_size;
+        const size_t* link_columns;
+        size_t link_column_count;
+    };
+
+    // Appends the conditions of program to query, as the equivalent sequence of query_* calls would.
+    // Throws std::invalid_argument when the program is malformed or compares a column with the wrong type.
+    void apply_predicate_program(Query& query, const PredicateProgram& program);
+
+} // namespace binding
+} // namespace realm
+
+#endif // PREDICATE_PROGRAM_HPP
@@ -0,0 +1,154 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <realm.hpp>
+#include "error_handling.hpp"
+#include "marshalling.hpp"
+#include "realm_export_decls.hpp"
+#include "handle_pool.hpp"
+#include "prepared_query_cs.hpp"
+#include "object-store/src/results.hpp"
+#include "object-store/src/shared_realm.hpp"
+#include "object_accessor.hpp"
+#include "shared_realm_cs.hpp"
+
+using namespace realm;
+using namespace realm::binding;
+
+namespace {
+
+// Literals are compared on their raw bits, so that e.g. a NaN bound again is still the same value.
+bool same_literal(const PrimitiveValue& lhs, const PrimitiveValue& rhs)
+{
+    return lhs.has_value == rhs.has_value && lhs.value.int_value == rhs.value.int_value;
+}
+
+}
+
+namespace realm {
+namespace binding {
+
+PreparedQuery::PreparedQuery(const Query& base, const PredicateProgram& program)
+: m_base(base)
+, m_instructions(program.instructions, program.instructions + program.instruction_count)
+, m_link_columns(program.link_columns, program.link_columns + program.link_column_count)
+, m_literals(program.literals, program.literals + program.literal_count)
+, m_string_pool(program.string_pool, program.string_pool + program.string_pool_size)
+, m_binary_pool(program.binary_pool, program.binary_pool + program.binary_pool_size)
+, m_query(build(program))
+{
+}
+
+Query& PreparedQuery::bind(const PrimitiveValue* literals, size_t literal_count, const uint16_t* string_pool, size_t string_pool_size,
+                           const char* binary_pool, size_t binary_pool_size)
+{
+    if (literal_count != m_literals.size())
+        throw std::invalid_argument(util::format("The prepared query has %1 literals but %2 were given", m_literals.size(), literal_count));
+
+    if (is_bound_to(literals, string_pool, string_pool_size, binary_pool, binary_pool_size))
+        return m_query;
+
+    // The literals are only kept once the query is built, so a failed bind leaves the previous one in place.
+    PredicateProgram program { m_instructions.data(), m_instructions.size(), literals, literal_count,
+                               string_pool, string_pool_size, binary_pool, binary_pool_size,
+                               m_link_columns.data(), m_link_columns.size() };
+    m_query = build(program);
+    m_literals.assign(literals, literals + literal_count);
+    m_string_pool.assign(string_pool, string_pool + string_pool_size);
+    m_binary_pool.assign(binary_pool, binary_pool + binary_pool_size);
+    return m_query;
+}
+
+bool PreparedQuery::is_bound_to(const PrimitiveValue* literals, const uint16_t* string_pool, size_t string_pool_size,
+                                const char* binary_pool, size_t binary_pool_size) const
+{
+    return std::equal(m_literals.begin(), m_literals.end(), literals, same_literal) &&
+           string_pool_size == m_string_pool.size() && std::equal(m_string_pool.begin(), m_string_pool.end(), string_pool) &&
+           binary_pool_size == m_binary_pool.size() && std::equal(m_binary_pool.begin(), m_binary_pool.end(), binary_pool);
+}
+
+Query PreparedQuery::build(const PredicateProgram& program) const
+{
+    Query query(m_base);
+    apply_predicate_program(query, program);
+    return query;
+}
+
+} // namespace binding
+} // namespace realm
+
+extern "C" {
+
+REALM_EXPORT PreparedQuery* prepared_query_create(const Query& base, const PredicateInstruction* instructions, size_t instruction_count,
+                                                  const PrimitiveValue* literals, size_t literal_count, const uint16_t* string_pool, size_t string_pool_size,
+                                                  const char* binary_pool, size_t binary_pool_size, const size_t* link_columns, size_t link_column_count,
+                                                  NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        PredicateProgram program { instructions, instruction_count, literals, literal_count, string_pool, string_pool_size,
+                                   binary_pool, binary_pool_size, link_columns, link_column_count };
+        return new PreparedQuery(base, program);
+    });
+}
+
+REALM_EXPORT void prepared_query_destroy(PreparedQuery* prepared_query)
+{
+    delete prepared_query;
+}
+
+REALM_EXPORT size_t prepared_query_count(PreparedQuery& prepared_query, SharedRealm& realm, const PrimitiveValue* literals, size_t literal_count,
+                                         const uint16_t* string_pool, size_t string_pool_size, const char* binary_pool, size_t binary_pool_size,
+                                         NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        realm->verify_thread();
+
+        return prepared_query.bind(literals, literal_count, string_pool, string_pool_size, binary_pool, binary_pool_size).count();
+    });
+}
+
+REALM_EXPORT Object* prepared_query_find(PreparedQuery& prepared_query, SharedRealm& realm, const PrimitiveValue* literals, size_t literal_count,
+                                         const uint16_t* string_pool, size_t string_pool_size, const char* binary_pool, size_t binary_pool_size,
+                                         NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() -> Object* {
+        realm->verify_thread();
+
+        auto& query = prepared_query.bind(literals, literal_count, string_pool, string_pool_size, binary_pool, binary_pool_size);
+        const size_t row_ndx = query.find();
+        if (row_ndx == not_found)
+            return nullptr;
+
+        auto& object_schema = object_schema_for_table(realm, *query.get_table());
+        return create_handle<Object>(realm, object_schema, Row((*query.get_table())[row_ndx]));
+    });
+}
+
+REALM_EXPORT Results* prepared_query_create_results(PreparedQuery& prepared_query, SharedRealm& realm, const PrimitiveValue* literals, size_t literal_count,
+                                                    const uint16_t* string_pool, size_t string_pool_size, const char* binary_pool, size_t binary_pool_size,
+                                                    NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        realm->verify_thread();
+
+        return create_handle<Results>(realm, prepared_query.bind(literals, literal_count, string_pool, string_pool_size, binary_pool, binary_pool_size));
+    });
+}
+
+}   // extern "C"
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef PREPARED_QUERY_CS_HPP
+#define PREPARED_QUERY_CS_HPP
+
+#include <vector>
+#include <realm/query.hpp>
+#include "predicate_program.hpp"
+
+namespace realm {
+namespace binding {
+
+    // A predicate program captured once for a base query, so that the same query shape can be run again and again with
+    // new values for its literals. Each run passes the whole literal array with its pools in a single call. The query
+    // built for the previous literals is kept and reused as long as they don't change.
+    class PreparedQuery {
+    public:
+        // Copies the program and applies it once, so a program that doesn't fit the table fails here rather than
+        // on its first run.
+        PreparedQuery(const Query& base, const PredicateProgram& program);
+
+        // The query for literals, which replace the ones the program was prepared with and must be as many.
+        Query& bind(const PrimitiveValue* literals, size_t literal_count, const uint16_t* string_pool, size_t string_pool_size,
+                    const char* binary_pool, size_t binary_pool_size);
+
+    private:
+        const Query m_base;
+        const std::vector<PredicateInstruction> m_instructions;
+        const std::vector<size_t> m_link_columns;
+        std::vector<PrimitiveValue> m_literals;
+        std::vector<uint16_t> m_string_pool;
+        std::vector<char> m_binary_pool;
+        Query m_query;
+
+        bool is_bound_to(const PrimitiveValue* literals, const uint16_t* string_pool, size_t string_pool_size,
+                         const char* binary_pool, size_t binary_pool_size) const;
+        Query build(const PredicateProgram& program) const;
+    };
+
+} // namespace binding
+} // namespace realm
+
+#endif // PREPARED_QUERY_CS_HPP
@@ -0,0 +1,347 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include "primary_key_index.hpp"
+#include "shared_realm_cs.hpp"
+
+using namespace realm;
+using namespace realm::binding;
+
+namespace {
+
+const uint64_t tag_mask = 0xFFFFFFFF00000000ULL;
+
+// Tables and slots hold row indices plus one in 32 bits. Leave plenty of room so that rows added to an indexed table
+// can't run out of it before the next lookup drops the index.
+const size_t max_indexed_rows = size_t(1) << 31;
+
+// The murmur3 finalizer, to spread the bits of a key over the whole hash, in particular its top bits, which pick the
+// slot.
+inline uint64_t mix(uint64_t hash)
+{
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+inline uint64_t hash_int(int64_t value)
+{
+    return mix(static_cast<uint64_t>(value));
+}
+
+// FNV-1a over the bytes of the string.
+inline uint64_t hash_string(StringData value)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    for (size_t i = 0; i < value.size(); ++i) {
+        hash ^= static_cast<unsigned char>(value.data()[i]);
+        hash *= 1099511628211ULL;
+    }
+    return mix(hash);
+}
+
+inline size_t slot_row(uint64_t slot)
+{
+    return static_cast<size_t>((slot & ~tag_mask) - 1);
+}
+
+inline uint64_t make_slot(uint64_t hash, size_t row_ndx)
+{
+    return (hash & tag_mask) | (static_cast<uint64_t>(row_ndx) + 1);
+}
+
+CSharpBindingContext* binding_context(const SharedRealm& realm)
+{
+    return static_cast<CSharpBindingContext*>(realm->m_binding_context.get());
+}
+
+// The index of table, if it is for column_ndx.
+PrimaryKeyIndex* index_for_column(const SharedRealm& realm, const Table& table, size_t column_ndx)
+{
+    auto context = binding_context(realm);
+    if (!context)
+        return nullptr;
+
+    auto index = context->get_primary_key_index(*realm, table);
+    return index && index->column_ndx() == column_ndx ? index : nullptr;
+}
+
+// The index of table if it has been built. Changes only need reporting to an index that exists, as one that is built
+// later reads the rows as they are by then.
+PrimaryKeyIndex* existing_index(const SharedRealm& realm, const Table& table)
+{
+    auto context = binding_context(realm);
+    return context ? context->find_primary_key_index(table) : nullptr;
+}
+
+} // anonymous namespace
+
+namespace realm {
+namespace binding {
+
+    PrimaryKeyIndex::PrimaryKeyIndex(const Table& table, size_t column_ndx)
+        : m_column_ndx(column_ndx)
+        , m_is_string(table.get_column_type(column_ndx) == type_String)
+        , m_is_nullable(table.is_nullable(column_ndx))
+    {
+        const size_t row_count = table.size();
+        size_t capacity = 16;
+        while (capacity / 4 * 3 < row_count)
+            capacity *= 2;
+        rehash(capacity);
+
+        for (size_t row_ndx = 0; row_ndx < row_count; ++row_ndx)
+            insert(table, row_ndx);
+    }
+
+    bool PrimaryKeyIndex::can_index(const Table& table)
+    {
+        return table.size() < max_indexed_rows;
+    }
+
+    size_t PrimaryKeyIndex::find(const Table& table, int64_t value, size_t except_row) const
+    {
+        const uint64_t tag = hash_int(value) & tag_mask;
+        const size_t mask = m_slots.size() - 1;
+        for (size_t i = ideal_slot(tag); m_slots[i]; i = (i + 1) & mask) {
+            if ((m_slots[i] & tag_mask) != tag)
+                continue;
+
+            const size_t row_ndx = slot_row(m_slots[i]);
+            if (row_ndx != except_row && row_ndx < table.size() && !is_null(table, row_ndx) &&
+                table.get_int(m_column_ndx, row_ndx) == value)
+                return row_ndx;
+        }
+        return not_found;
+    }
+
+    size_t PrimaryKeyIndex::find(const Table& table, StringData value, size_t except_row) const
+    {
+        if (value.is_null())
+            return find_null(table, except_row);
+
+        const uint64_t tag = hash_string(value) & tag_mask;
+        const size_t mask = m_slots.size() - 1;
+        for (size_t i = ideal_slot(tag); m_slots[i]; i = (i + 1) & mask) {
+            if ((m_slots[i] & tag_mask) != tag)
+                continue;
+
+            const size_t row_ndx = slot_row(m_slots[i]);
+            if (row_ndx != except_row && row_ndx < table.size() && !is_null(table, row_ndx) &&
+                table.get_string(m_column_ndx, row_ndx) == value)
+                return row_ndx;
+        }
+        return not_found;
+    }
+
+    size_t PrimaryKeyIndex::find_null(const Table& table, size_t except_row) const
+    {
+        for (size_t row_ndx : m_null_rows) {
+            if (row_ndx != except_row && row_ndx < table.size() && is_null(table, row_ndx))
+                return row_ndx;
+        }
+        return not_found;
+    }
+
+    void PrimaryKeyIndex::insert(const Table& table, size_t row_ndx)
+    {
+        if (is_null(table, row_ndx)) {
+            m_null_rows.push_back(row_ndx);
+            return;
+        }
+
+        if ((m_size + 1) * 4 > m_slots.size() * 3)
+            rehash(m_slots.size() * 2);
+        insert_slot(make_slot(hash_of_row(table, row_ndx), row_ndx));
+    }
+
+    void PrimaryKeyIndex::erase(const Table& table, size_t row_ndx)
+    {
+        if (is_null(table, row_ndx)) {
+            auto it = std::find(m_null_rows.begin(), m_null_rows.end(), row_ndx);
+            if (it != m_null_rows.end())
+                m_null_rows.erase(it);
+            return;
+        }
+
+        const size_t slot_ndx = find_slot(hash_of_row(table, row_ndx), row_ndx);
+        if (slot_ndx != npos)
+            erase_slot(slot_ndx);
+    }
+
+    void PrimaryKeyIndex::move(const Table& table, size_t from_ndx, size_t to_ndx)
+    {
+        if (is_null(table, from_ndx)) {
+            std::replace(m_null_rows.begin(), m_null_rows.end(), from_ndx, to_ndx);
+            return;
+        }
+
+        const size_t slot_ndx = find_slot(hash_of_row(table, from_ndx), from_ndx);
+        if (slot_ndx != npos)
+            m_slots[slot_ndx] = make_slot(m_slots[slot_ndx], to_ndx);
+    }
+
+    bool PrimaryKeyIndex::is_null(const Table& table, size_t row_ndx) const
+    {
+        return m_is_nullable && table.is_null(m_column_ndx, row_ndx);
+    }
+
+    uint64_t PrimaryKeyIndex::hash_of_row(const Table& table, size_t row_ndx) const
+    {
+        if (m_is_string)
+            return hash_string(table.get_string(m_column_ndx, row_ndx));
+        return hash_int(table.get_int(m_column_ndx, row_ndx));
+    }
+
+    size_t PrimaryKeyIndex::find_slot(uint64_t hash, size_t row_ndx) const
+    {
+        const uint64_t slot = make_slot(hash, row_ndx);
+        const size_t mask = m_slots.size() - 1;
+        for (size_t i = ideal_slot(slot); m_slots[i]; i = (i + 1) & mask) {
+            if (m_slots[i] == slot)
+                return i;
+        }
+        return npos;
+    }
+
+    void PrimaryKeyIndex::insert_slot(uint64_t slot)
+    {
+        const size_t mask = m_slots.size() - 1;
+        size_t i = ideal_slot(slot);
+        while (m_slots[i])
+            i = (i + 1) & mask;
+        m_slots[i] = slot;
+        ++m_size;
+    }
+
+    // Removes the slot without leaving a tombstone, by moving back the entries after it that would no longer be found
+    // once the probe stops at the hole.
+    void PrimaryKeyIndex::erase_slot(size_t slot_ndx)
+    {
+        const size_t mask = m_slots.size() - 1;
+        size_t hole = slot_ndx;
+        for (size_t i = (hole + 1) & mask; m_slots[i]; i = (i + 1) & mask) {
+            const size_t ideal = ideal_slot(m_slots[i]);
+            const bool reachable = hole <= i ? (ideal > hole && ideal <= i) : (ideal > hole || ideal <= i);
+            if (!reachable) {
+                m_slots[hole] = m_slots[i];
+                hole = i;
+            }
+        }
+        m_slots[hole] = 0;
+        --m_size;
+    }
+
+    void PrimaryKeyIndex::rehash(size_t capacity)
+    {
+        unsigned bits = 0;
+        while ((size_t(1) << bits) < capacity)
+            ++bits;
+        REALM_ASSERT(bits <= 32);
+
+        std::vector<uint64_t> slots(capacity, 0);
+        slots.swap(m_slots);
+        m_shift = 32 - bits;
+        m_size = 0;
+        for (uint64_t slot : slots) {
+            if (slot)
+                insert_slot(slot);
+        }
+    }
+
+    size_t find_primary_key(const SharedRealm& realm, const Table& table, size_t column_ndx, int64_t value, size_t except_row)
+    {
+        if (auto index = index_for_column(realm, table, column_ndx))
+            return index->find(table, value, except_row);
+
+        auto row_ndx = table.find_first_int(column_ndx, value);
+        return row_ndx == except_row ? not_found : row_ndx;
+    }
+
+    size_t find_primary_key(const SharedRealm& realm, const Table& table, size_t column_ndx, StringData value, size_t except_row)
+    {
+        if (auto index = index_for_column(realm, table, column_ndx))
+            return index->find(table, value, except_row);
+
+        auto row_ndx = table.find_first_string(column_ndx, value);
+        return row_ndx == except_row ? not_found : row_ndx;
+    }
+
+    size_t find_null_primary_key(const SharedRealm& realm, const Table& table, size_t column_ndx, size_t except_row)
+    {
+        if (auto index = index_for_column(realm, table, column_ndx))
+            return index->find_null(table, except_row);
+
+        auto row_ndx = table.find_first_null(column_ndx);
+        return row_ndx == except_row ? not_found : row_ndx;
+    }
+
+    void primary_key_row_added(const SharedRealm& realm, const Table& table, size_t row_ndx)
+    {
+        if (auto index = existing_index(realm, table))
+            index->insert(table, row_ndx);
+    }
+
+    void primary_key_row_removing(const SharedRealm& realm, const Table& table, size_t row_ndx)
+    {
+        if (auto index = existing_index(realm, table)) {
+            index->erase(table, row_ndx);
+
+            const size_t last_ndx = table.size() - 1;
+            if (row_ndx != last_ndx)
+                index->move(table, last_ndx, row_ndx);
+        }
+    }
+
+    void primary_key_column_written(const SharedRealm& realm, const Table& table, size_t column_ndx)
+    {
+        auto index = existing_index(realm, table);
+        if (index && index->column_ndx() == column_ndx)
+            binding_context(realm)->drop_primary_key_index(table);
+    }
+
+    PrimaryKeyUpdate::PrimaryKeyUpdate(const SharedRealm& realm, const Table& table, size_t column_ndx, size_t row_ndx)
+        : m_realm(realm)
+        , m_table(table)
+        , m_row_ndx(row_ndx)
+        , m_index(index_for_column(realm, table, column_ndx))
+    {
+        if (m_index)
+            m_index->erase(table, row_ndx);
+    }
+
+    PrimaryKeyUpdate::~PrimaryKeyUpdate()
+    {
+        if (!m_index)
+            return;
+
+        try {
+            m_index->insert(m_table, m_row_ndx);
+        }
+        catch (...) {
+            // Growing the index failed, so it can no longer be trusted to find every row.
+            binding_context(m_realm)->drop_primary_key_index(m_table);
+        }
+    }
+
+} // namespace binding
+} // namespace realm
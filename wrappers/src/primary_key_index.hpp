@@ -0,0 +1,124 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef PRIMARY_KEY_INDEX_HPP
+#define PRIMARY_KEY_INDEX_HPP
+
+#include <cstdint>
+#include <vector>
+#include <realm.hpp>
+#include "shared_realm.hpp"
+
+namespace realm {
+namespace binding {
+
+    // A hash index over the primary key column of one table, so that looking up an object by its primary key and
+    // checking a new key for uniqueness don't need to search the column. It is kept by the binding context, built from
+    // the table on first use and thrown away whenever the table may have changed behind the binding's back.
+    //
+    // Slots only hold a hash tag and a row index; keys are compared by reading the row, so an entry that went stale
+    // can never produce a wrong match, but every change to a primary key made through the binding must be reported
+    // for lookups not to miss a row.
+    class PrimaryKeyIndex {
+    public:
+        PrimaryKeyIndex(const Table& table, size_t column_ndx);
+
+        size_t column_ndx() const
+        {
+            return m_column_ndx;
+        }
+
+        // The row whose primary key is value, skipping except_row, or not_found.
+        size_t find(const Table& table, int64_t value, size_t except_row = npos) const;
+        size_t find(const Table& table, StringData value, size_t except_row = npos) const;
+        size_t find_null(const Table& table, size_t except_row = npos) const;
+
+        // Adds or removes the entry for the current primary key of row_ndx.
+        void insert(const Table& table, size_t row_ndx);
+        void erase(const Table& table, size_t row_ndx);
+
+        // Points the entry of from_ndx at to_ndx, for when move_last_over is about to move the row.
+        void move(const Table& table, size_t from_ndx, size_t to_ndx);
+
+        // Tables with more rows than fit in a slot are left to core's search index.
+        static bool can_index(const Table& table);
+
+    private:
+        size_t m_column_ndx;
+        bool m_is_string;
+        bool m_is_nullable;
+
+        // Each slot is a 32 bit hash tag followed by the row index plus one, 0 marking an empty slot. The slot a key
+        // hashes to is taken from the top bits of its tag, so that growing doesn't need to read the keys again.
+        std::vector<uint64_t> m_slots;
+        unsigned m_shift;
+        size_t m_size = 0;
+
+        // Rows with a null primary key. There is at most one, except for rows just added with a nullable key.
+        std::vector<size_t> m_null_rows;
+
+        bool is_null(const Table& table, size_t row_ndx) const;
+        uint64_t hash_of_row(const Table& table, size_t row_ndx) const;
+        size_t find_slot(uint64_t hash, size_t row_ndx) const;
+        void insert_slot(uint64_t slot);
+        void erase_slot(size_t slot_ndx);
+        void rehash(size_t capacity);
+
+        size_t ideal_slot(uint64_t slot) const
+        {
+            return static_cast<size_t>((slot >> 32) >> m_shift);
+        }
+    };
+
+    // Primary key lookups through the index of the Realm's binding context, falling back to core for Realms without one
+    // and for tables that can't be indexed.
+    size_t find_primary_key(const SharedRealm& realm, const Table& table, size_t column_ndx, int64_t value, size_t except_row = npos);
+    size_t find_primary_key(const SharedRealm& realm, const Table& table, size_t column_ndx, StringData value, size_t except_row = npos);
+    size_t find_null_primary_key(const SharedRealm& realm, const Table& table, size_t column_ndx, size_t except_row = npos);
+
+    // Reports a row that was added with the default primary key.
+    void primary_key_row_added(const SharedRealm& realm, const Table& table, size_t row_ndx);
+
+    // Reports a row that is about to be removed with move_last_over.
+    void primary_key_row_removing(const SharedRealm& realm, const Table& table, size_t row_ndx);
+
+    // Reports a write to column_ndx through a setter that doesn't keep the index up to date. Drops the index if the
+    // column is the primary key.
+    void primary_key_column_written(const SharedRealm& realm, const Table& table, size_t column_ndx);
+
+    // Keeps the index up to date while the primary key of a row is set: the row's entry is removed on construction and
+    // added back for whatever key the row has on destruction, including when setting it failed.
+    class PrimaryKeyUpdate {
+    public:
+        PrimaryKeyUpdate(const SharedRealm& realm, const Table& table, size_t column_ndx, size_t row_ndx);
+        ~PrimaryKeyUpdate();
+
+        PrimaryKeyUpdate(const PrimaryKeyUpdate&) = delete;
+        PrimaryKeyUpdate& operator=(const PrimaryKeyUpdate&) = delete;
+
+    private:
+        const SharedRealm& m_realm;
+        const Table& m_table;
+        size_t m_row_ndx;
+        PrimaryKeyIndex* m_index;
+    };
+
+} // namespace binding
+} // namespace realm
+
+#endif // PRIMARY_KEY_INDEX_HPP
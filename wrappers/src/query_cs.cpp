@@ -16,17 +16,27 @@
 //
 ////////////////////////////////////////////////////////////////////////////
  
+#include <algorithm>
 #include <realm.hpp>
 #include <realm/lang_bind_helper.hpp>
 #include "marshalling.hpp"
 #include "error_handling.hpp"
 #include "realm_export_decls.hpp"
+#include "handle_pool.hpp"
 #include "object-store/src/shared_realm.hpp"
 #include "object-store/src/schema.hpp"
 #include "timestamp_helpers.hpp"
 #include "object-store/src/results.hpp"
 #include "marshalable_sort_clause.hpp"
 #include "object_accessor.hpp"
+#include "aggregate_cs.hpp"
+#include "top_k.hpp"
+#include "keyset_cursor.hpp"
+#include "distinct_cs.hpp"
+#include "predicate_program.hpp"
+#include "string_query.hpp"
+#include "value_set_query.hpp"
+#include "shared_realm_cs.hpp"
 
 
 using namespace realm;
@@ -36,7 +46,7 @@ extern "C" {
 
 REALM_EXPORT void query_destroy(Query* query_ptr)
 {
-    delete(query_ptr);
+    destroy_handle(query_ptr);
 }
 
 REALM_EXPORT Object* query_find(Query* query_ptr, size_t begin_at_table_row, SharedRealm* realm, NativeException::Marshallable& ex)
@@ -50,9 +60,8 @@ REALM_EXPORT Object* query_find(Query* query_ptr, size_t begin_at_table_row, Sha
         if (row_ndx == not_found)
             return nullptr;
 
-        const std::string object_name(ObjectStore::object_type_for_table_name(query_ptr->get_table()->get_name()));
-        auto& object_schema = *realm->get()->schema().find(object_name);
-        return new Object(*realm, object_schema, Row((*query_ptr->get_table())[row_ndx]));
+        auto& object_schema = object_schema_for_table(*realm, *query_ptr->get_table());
+        return create_handle<Object>(*realm, object_schema, Row((*query_ptr->get_table())[row_ndx]));
     });
 }
     
@@ -69,6 +78,50 @@ REALM_EXPORT size_t query_count(Query * query_ptr, NativeException::Marshallable
     });
 }
 
+REALM_EXPORT void query_aggregate(Query& query, size_t column_ndx, AggregateType type, PrimitiveValue& result, NativeException::Marshallable& ex)
+{
+    handle_errors(ex, [&]() {
+        result = aggregate(query, column_ndx, type);
+    });
+}
+
+// Appends a whole predicate, built on the managed side as a program of instructions and literal pools, in a single call
+// instead of one call per condition. See predicate_program.hpp for the layout.
+REALM_EXPORT void query_apply_predicate_program(Query& query, const PredicateInstruction* instructions, size_t instruction_count,
+                                                const PrimitiveValue* literals, size_t literal_count, const uint16_t* string_pool, size_t string_pool_size,
+                                                const char* binary_pool, size_t binary_pool_size, const size_t* link_columns, size_t link_column_count,
+                                                NativeException::Marshallable& ex)
+{
+    handle_errors(ex, [&]() {
+        PredicateProgram program { instructions, instruction_count, literals, literal_count, string_pool, string_pool_size,
+                                   binary_pool, binary_pool_size, link_columns, link_column_count };
+        apply_predicate_program(query, program);
+    });
+}
+
+// Appends a predicate given as a string in the object store's query language, e.g. "age > $0 AND name BEGINSWITH $1",
+// with the values for its placeholders. See string_query.hpp for how the arguments are passed.
+REALM_EXPORT void query_from_string(Query& query, SharedRealm& realm, uint16_t* predicate_buf, size_t predicate_len,
+                                    const PropertyValue* arguments, size_t argument_count, const uint16_t* string_pool, size_t string_pool_size,
+                                    const char* binary_pool, size_t binary_pool_size, NativeException::Marshallable& ex)
+{
+    handle_errors(ex, [&]() {
+        Utf16StringAccessor predicate(predicate_buf, predicate_len);
+        StringQueryArguments query_arguments { arguments, argument_count, string_pool, string_pool_size, binary_pool, binary_pool_size };
+        apply_string_predicate(query, realm, predicate, query_arguments);
+    });
+}
+
+// Fills values with the distinct values of a column over the matching rows; see distinct_values for the layout.
+// Returns the number of distinct values, which may be more than values_capacity.
+REALM_EXPORT size_t query_get_distinct_values(Query& query, size_t column_ndx, PrimitiveValue* values, size_t values_capacity,
+                                              uint16_t* string_buffer, size_t string_buffer_size, size_t& string_units, NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        return distinct_values(query, column_ndx, values, values_capacity, string_buffer, string_buffer_size, string_units);
+    });
+}
+
 
 //convert from columnName to columnIndex returns -1 if the string is not a column name
 //assuming that the get_table() does not return anything that must be deleted
@@ -415,6 +468,30 @@ REALM_EXPORT void query_null_not_equal(Query* query_ptr, size_t columnIndex, Nat
     });   
 }
 
+// Matches the rows whose value in columnIndex is one of values, or null when match_null is set.
+REALM_EXPORT void query_int_in(Query& query, size_t columnIndex, const int64_t* values, size_t count, bool match_null, NativeException::Marshallable& ex)
+{
+    handle_errors(ex, [&]() {
+        add_int_in(query, columnIndex, values, count, match_null);
+    });
+}
+
+// Like query_int_in, with the values given as consecutive UTF-16 strings in string_pool; value_lengths holds the length
+// of each in 16-bit units.
+REALM_EXPORT void query_string_in(Query& query, size_t columnIndex, const uint16_t* string_pool, const size_t* value_lengths, size_t count,
+                                  bool match_null, NativeException::Marshallable& ex)
+{
+    handle_errors(ex, [&]() {
+        std::vector<std::string> values;
+        values.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            values.push_back(Utf16StringAccessor(string_pool, value_lengths[i]));
+            string_pool += value_lengths[i];
+        }
+        add_string_in(query, columnIndex, std::move(values), match_null);
+    });
+}
+
 typedef enum
 {
 	None,
@@ -735,7 +812,21 @@ REALM_EXPORT void query_and(Query * query_ptr, const Query & linkquery, NativeEx
 REALM_EXPORT Results* query_create_results(Query* query_ptr, SharedRealm* realm, NativeException::Marshallable& ex)
 {
     return handle_errors(ex, [&]() {
-        return new Results(*realm, *query_ptr);
+        return create_handle<Results>(*realm, *query_ptr);
+    });
+}
+
+// Results for the first offset + limit matches of an unsorted query, for a window of [offset, offset + limit) that the
+// managed handle applies by match ordinal. The query is only evaluated until it has produced offset + limit matches.
+// The table view is always rerun from the first row, so the window stays the same matches in table order when rows
+// before it are deleted or moved. Pass npos as limit for no limit.
+REALM_EXPORT Results* query_create_windowed_results(Query& query, SharedRealm& realm, size_t offset, size_t limit, NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        realm->verify_thread();
+
+        const size_t match_limit = limit > size_t(-1) - offset ? size_t(-1) : offset + limit;
+        return create_handle<Results>(realm, query.find_all(0, size_t(-1), match_limit));
     });
 }
 
@@ -745,12 +836,98 @@ REALM_EXPORT Results* query_create_sorted_results(Query* query_ptr, SharedRealm*
         std::vector<std::vector<size_t>> column_indices;
         std::vector<bool> ascending;
 
-        const std::string object_name(ObjectStore::object_type_for_table_name(table_ptr->get_name()));
-        auto& properties = realm->get()->schema().find(object_name)->persisted_properties;
+        auto& properties = object_schema_for_table(*realm, *table_ptr).persisted_properties;
         unflatten_sort_clauses(sort_clauses, clause_count, flattened_property_indices, column_indices, ascending, properties);
 
         auto sort_descriptor = SortDescriptor(*table_ptr, column_indices, ascending);
-        return new Results(*realm, *query_ptr, sort_descriptor);
+        return create_handle<Results>(*realm, *query_ptr, sort_descriptor);
+    });
+}
+
+// Like query_create_sorted_results, but only the first k rows of the sorted results are needed. When the leading sort
+// property is a number or date on the queried table, the query is first narrowed to the rows that can be among the
+// first k so core sorts those instead of every match. The results can hold more than k rows when the k-th row ties
+// with others on the leading property, so callers still take the first k themselves. The narrowing is not redone when
+// the realm changes, so the results must be read and destroyed before the next write or refresh.
+REALM_EXPORT Results* query_create_top_k_results(Query& query, SharedRealm& realm, Table& table, MarshalableSortClause* sort_clauses, size_t clause_count, size_t* flattened_property_indices, size_t k, NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        std::vector<std::vector<size_t>> column_indices;
+        std::vector<bool> ascending;
+
+        auto& properties = object_schema_for_table(realm, table).persisted_properties;
+        unflatten_sort_clauses(sort_clauses, clause_count, flattened_property_indices, column_indices, ascending, properties);
+
+        Query top_k_query(query);
+        if (!column_indices.empty() && column_indices[0].size() == 1)
+            narrow_to_top_k(top_k_query, column_indices[0][0], ascending[0], k);
+
+        return create_handle<Results>(realm, top_k_query, SortDescriptor(table, column_indices, ascending));
+    });
+}
+
+// Creates results holding only the first row, in sort order, of each distinct combination of values of the distinct key
+// paths. Both the sort and the distinct key paths use the flattened encoding of query_create_sorted_results; the
+// ascending flag of distinct clauses is ignored. clause_count may be 0 for no sort.
+REALM_EXPORT Results* query_create_distinct_results(Query& query, SharedRealm& realm, Table& table,
+                                                    MarshalableSortClause* sort_clauses, size_t sort_clause_count, size_t* flattened_sort_property_indices,
+                                                    MarshalableSortClause* distinct_clauses, size_t distinct_clause_count, size_t* flattened_distinct_property_indices,
+                                                    NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        auto& properties = object_schema_for_table(realm, table).persisted_properties;
+
+        std::vector<std::vector<size_t>> sort_column_indices;
+        std::vector<bool> ascending;
+        unflatten_sort_clauses(sort_clauses, sort_clause_count, flattened_sort_property_indices, sort_column_indices, ascending, properties);
+
+        std::vector<std::vector<size_t>> distinct_column_indices;
+        std::vector<bool> unused_ascending;
+        unflatten_sort_clauses(distinct_clauses, distinct_clause_count, flattened_distinct_property_indices, distinct_column_indices, unused_ascending, properties);
+
+        auto sort_descriptor = sort_column_indices.empty() ? SortDescriptor() : SortDescriptor(table, sort_column_indices, ascending);
+        return create_handle<Results>(realm, query, std::move(sort_descriptor), DistinctDescriptor(table, distinct_column_indices));
+    });
+}
+
+REALM_EXPORT size_t query_get_keyset_cursor_size(size_t clause_count)
+{
+    return keyset_cursor_size(clause_count);
+}
+
+// Creates a page of a sorted query for keyset pagination: the first page_size rows that sort strictly after the row the
+// cursor was written for, or the first page when cursor is null. The cursor becomes a query condition built from column
+// expressions, which core evaluates row by row without the search index, so every page still scans the matches. What
+// deep pages avoid is sorting or materializing the rows before the cursor: only rows after it are narrowed to the
+// page and sorted. Like query_create_top_k_results the results can hold more than page_size rows. The page is a
+// snapshot, since its narrowing is only valid for the version it was built on.
+// The cursor of the page's last row is written to next_cursor, which must hold query_get_keyset_cursor_size bytes;
+// next_cursor_size is set to 0 when the page is empty.
+REALM_EXPORT Results* query_create_keyset_page(Query& query, SharedRealm& realm, Table& table, MarshalableSortClause* sort_clauses, size_t clause_count, size_t* flattened_property_indices,
+                                               const uint8_t* cursor, size_t cursor_size, size_t page_size, uint8_t* next_cursor, size_t& next_cursor_size, NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        std::vector<std::vector<size_t>> column_indices;
+        std::vector<bool> ascending;
+
+        auto& properties = object_schema_for_table(realm, table).persisted_properties;
+        unflatten_sort_clauses(sort_clauses, clause_count, flattened_property_indices, column_indices, ascending, properties);
+
+        Query page_query(query);
+        if (cursor)
+            add_keyset_condition(page_query, column_indices, ascending, cursor, cursor_size);
+        if (!column_indices.empty() && column_indices[0].size() == 1)
+            narrow_to_top_k(page_query, column_indices[0][0], ascending[0], page_size);
+
+        Results page(realm, page_query, SortDescriptor(table, column_indices, ascending));
+        const size_t size = std::min(page.size(), page_size);
+        next_cursor_size = 0;
+        if (size > 0) {
+            auto last_row = page.get(size - 1);
+            write_keyset_cursor(*last_row.get_table(), last_row.get_index(), column_indices, next_cursor);
+            next_cursor_size = keyset_cursor_size(clause_count);
+        }
+        return create_handle<Results>(page.snapshot());
     });
 }
 
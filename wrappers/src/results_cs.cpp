@@ -16,24 +16,136 @@
 //
 //////////////////////////////////////////////////////////////////////////// 
 
+#include <algorithm>
 #include <realm.hpp>
 #include "error_handling.hpp"
 #include "marshalling.hpp"
 #include "realm_export_decls.hpp"
+#include "handle_pool.hpp"
 #include "results.hpp"
 #include "object_accessor.hpp"
 #include "object-store/src/thread_safe_reference.hpp"
 #include "notifications_cs.hpp"
+#include "object_cs.hpp"
+#include "aggregate_cs.hpp"
+#include "timestamp_helpers.hpp"
+#include "row_bitmap.hpp"
 
 using namespace realm;
 using namespace realm::binding;
 
+namespace {
+
+PropertyValueType column_value_type(PropertyType type)
+{
+    switch (type) {
+        case PropertyType::Bool:
+            return PropertyValueType::Bool;
+        case PropertyType::Int:
+            return PropertyValueType::Int;
+        case PropertyType::Float:
+            return PropertyValueType::Float;
+        case PropertyType::Double:
+            return PropertyValueType::Double;
+        case PropertyType::Date:
+            return PropertyValueType::Timestamp;
+        default:
+            return PropertyValueType::Null;
+    }
+}
+
+// Reads one column for a window of rows of a Results straight from the underlying table.
+class ColumnReader {
+public:
+    ColumnReader(Results& results, size_t column_ndx, size_t start, uint8_t* null_bitmap)
+    : m_results(results), m_column_ndx(column_ndx), m_start(start), m_null_bitmap(null_bitmap) { }
+
+    template<typename T, typename Getter>
+    void read(T* values, size_t count, Getter getter)
+    {
+        for (size_t i = 0; i < count; ++i) {
+            auto row = m_results.get(m_start + i);
+            if (is_null(row, i))
+                values[i] = T();
+            else
+                values[i] = getter(*row.get_table(), m_column_ndx, row.get_index());
+        }
+    }
+
+    // Timestamps are gathered a block at a time into separate seconds/nanoseconds arrays so the conversion to ticks
+    // can run as one vectorized pass over each block.
+    void read_ticks(int64_t* ticks, size_t count)
+    {
+        static const size_t block_size = 256;
+        int32_t nanoseconds[block_size];
+        bool nulls[block_size];
+
+        for (size_t block_start = 0; block_start < count; block_start += block_size) {
+            const size_t block_count = std::min(block_size, count - block_start);
+            bool has_nulls = false;
+            for (size_t j = 0; j < block_count; ++j) {
+                const size_t i = block_start + j;
+                auto row = m_results.get(m_start + i);
+                nulls[j] = is_null(row, i);
+                if (nulls[j]) {
+                    ticks[i] = 0;
+                    nanoseconds[j] = 0;
+                    has_nulls = true;
+                    continue;
+                }
+
+                auto timestamp = row.get_table()->get_timestamp(m_column_ndx, row.get_index());
+                ticks[i] = timestamp.get_seconds();
+                nanoseconds[j] = timestamp.get_nanoseconds();
+            }
+
+            to_ticks(ticks + block_start, nanoseconds, block_count);
+
+            if (has_nulls) {
+                for (size_t j = 0; j < block_count; ++j) {
+                    if (nulls[j])
+                        ticks[block_start + j] = 0;
+                }
+            }
+        }
+    }
+
+private:
+    Results& m_results;
+    const size_t m_column_ndx;
+    const size_t m_start;
+    uint8_t* const m_null_bitmap;
+
+    bool is_null(const RowExpr& row, size_t i)
+    {
+        if (row.is_attached() && !(m_null_bitmap && row.get_table()->is_null(m_column_ndx, row.get_index())))
+            return false;
+
+        if (m_null_bitmap)
+            m_null_bitmap[i / 8] |= uint8_t(1 << (i % 8));
+        return true;
+    }
+};
+
+TableRef get_common_table(Results& lhs, Results& rhs)
+{
+    if (lhs.get_realm() != rhs.get_realm())
+        throw ObjectManagedByAnotherRealmException("Can only combine results from the same Realm.");
+
+    auto table = lhs.get_query().get_table();
+    if (rhs.get_query().get_table() != table)
+        throw std::invalid_argument("Can only combine results of the same object type.");
+    return table;
+}
+
+}
+
 
 extern "C" {
 
 REALM_EXPORT void results_destroy(Results* results_ptr)
 {
-    delete results_ptr;
+    destroy_handle(results_ptr);
 }
 
 // TODO issue https://github.com/realm/realm-dotnet-private/issues/40 added as needs
@@ -51,7 +163,7 @@ REALM_EXPORT Object* results_get_row(Results* results_ptr, size_t ndx, NativeExc
         try {
             results_ptr->get_realm()->verify_thread();
             
-            return new Object(results_ptr->get_realm(), results_ptr->get_object_schema(), results_ptr->get(ndx));
+            return create_handle<Object>(results_ptr->get_realm(), results_ptr->get_object_schema(), results_ptr->get(ndx));
         }
         catch (std::out_of_range &exp) {
             return static_cast<Object*>(nullptr);
@@ -59,6 +171,131 @@ REALM_EXPORT Object* results_get_row(Results* results_ptr, size_t ndx, NativeExc
     });
 }
 
+// Copies the table row indices of the rows in [start, start + count) into row_indices, checking the thread only once for
+// the whole window. Rows that have been deleted since the results were last updated are reported as -1.
+// Returns the number of indices written, which is less than count when the window runs past the end of the results.
+REALM_EXPORT size_t results_get_rows(Results& results, size_t start, size_t count, int64_t* row_indices, NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        results.get_realm()->verify_thread();
+
+        const size_t size = results.size();
+        if (start >= size)
+            return size_t(0);
+
+        count = std::min(count, size - start);
+        for (size_t i = 0; i < count; ++i) {
+            auto row = results.get(start + i);
+            row_indices[i] = row.is_attached() ? static_cast<int64_t>(row.get_index()) : -1;
+        }
+        return count;
+    });
+}
+
+// Like results_get_row, but creates the objects for a whole window in one call. Each object is still its own allocation
+// because the managed side releases them one by one through object_destroy. Deleted rows come back as nullptr.
+REALM_EXPORT size_t results_get_objects(Results& results, size_t start, size_t count, Object** objects, NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        auto realm = results.get_realm();
+        realm->verify_thread();
+
+        const size_t size = results.size();
+        if (start >= size)
+            return size_t(0);
+
+        count = std::min(count, size - start);
+        auto& object_schema = results.get_object_schema();
+        size_t created = 0;
+        try {
+            for (; created < count; ++created) {
+                auto row = results.get(start + created);
+                objects[created] = row.is_attached() ? create_handle<Object>(realm, object_schema, row) : nullptr;
+            }
+        }
+        catch (...) {
+            for (size_t i = 0; i < created; ++i)
+                destroy_handle(objects[i]);
+            throw;
+        }
+        return count;
+    });
+}
+
+// Copies one property of the rows in [start, start + count) into values, which holds one element per row: a byte for
+// bool, int64_t for int, float, double, or int64_t .NET ticks for dates. type must match the property type, so a
+// mismatched buffer is rejected instead of overrun. Bit i of null_bitmap (least significant bit first) is set when row
+// start + i is null or has been deleted; the bitmap may be null for required properties.
+// Returns the number of rows copied, which is less than count when the window runs past the end of the results.
+REALM_EXPORT size_t results_get_column(Results& results, size_t property_ndx, PropertyValueType type, size_t start, size_t count,
+                                       void* values, uint8_t* null_bitmap, NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        results.get_realm()->verify_thread();
+
+        auto& property = results.get_object_schema().persisted_properties.at(property_ndx);
+        if (column_value_type(property.type) != type)
+            throw std::invalid_argument(util::format("Property '%1' can't be read into this buffer", property.name));
+        if (property.is_nullable && !null_bitmap)
+            throw std::invalid_argument(util::format("Property '%1' is nullable and needs a null bitmap", property.name));
+
+        const size_t size = results.size();
+        if (start >= size)
+            return size_t(0);
+
+        count = std::min(count, size - start);
+        if (null_bitmap)
+            std::fill_n(null_bitmap, (count + 7) / 8, uint8_t(0));
+
+        ColumnReader reader(results, property.table_column, start, null_bitmap);
+        switch (type) {
+            case PropertyValueType::Bool:
+                reader.read(static_cast<bool*>(values), count, [](const Table& table, size_t column, size_t row) { return table.get_bool(column, row); });
+                break;
+            case PropertyValueType::Int:
+                reader.read(static_cast<int64_t*>(values), count, [](const Table& table, size_t column, size_t row) { return table.get_int(column, row); });
+                break;
+            case PropertyValueType::Float:
+                reader.read(static_cast<float*>(values), count, [](const Table& table, size_t column, size_t row) { return table.get_float(column, row); });
+                break;
+            case PropertyValueType::Double:
+                reader.read(static_cast<double*>(values), count, [](const Table& table, size_t column, size_t row) { return table.get_double(column, row); });
+                break;
+            case PropertyValueType::Timestamp:
+                reader.read_ticks(static_cast<int64_t*>(values), count);
+                break;
+            default:
+                REALM_UNREACHABLE();
+        }
+        return count;
+    });
+}
+
+// Combines the objects of lhs and rhs, which must be of the same type, into new results holding the objects in
+// either, in both or only in lhs. The results are a snapshot in table order: they are not updated by later changes.
+REALM_EXPORT Results* results_combine(Results& lhs, Results& rhs, RowSetOperation operation, NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        auto realm = lhs.get_realm();
+        realm->verify_thread();
+
+        auto table = get_common_table(lhs, rhs);
+        auto bitmap = std::make_shared<RowBitmap>(row_bitmap(lhs).combine(row_bitmap(rhs), operation));
+        return create_handle<Results>(results_for_rows(realm, *table, std::move(bitmap)));
+    });
+}
+
+// The number of objects results_combine would return, without creating the results.
+REALM_EXPORT size_t results_combined_count(Results& lhs, Results& rhs, RowSetOperation operation, NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        lhs.get_realm()->verify_thread();
+
+        get_common_table(lhs, rhs);
+        return row_bitmap(lhs).combined_size(row_bitmap(rhs), operation);
+    });
+}
+
 REALM_EXPORT void results_clear(Results* results_ptr, SharedRealm& realm, NativeException::Marshallable& ex)
 {
     handle_errors(ex, [&]() {
@@ -69,6 +306,7 @@ REALM_EXPORT void results_clear(Results* results_ptr, SharedRealm& realm, Native
         results_ptr->get_realm()->verify_in_write();
       
         results_ptr->clear();
+        drop_primary_key_indexes(realm);
     });
 }
 
@@ -81,6 +319,16 @@ REALM_EXPORT size_t results_count(Results* results_ptr, NativeException::Marshal
     });
 }
 
+REALM_EXPORT void results_aggregate(Results& results, size_t property_ndx, AggregateType type, PrimitiveValue& result, NativeException::Marshallable& ex)
+{
+    handle_errors(ex, [&]() {
+        results.get_realm()->verify_thread();
+
+        auto& property = results.get_object_schema().persisted_properties.at(property_ndx);
+        result = aggregate(results, property.table_column, type);
+    });
+}
+
 REALM_EXPORT ManagedNotificationTokenContext* results_add_notification_callback(Results* results_ptr, void* managed_results, ManagedNotificationCallback callback, NativeException::Marshallable& ex)
 {
     return handle_errors(ex, [=]() {
@@ -93,7 +341,7 @@ REALM_EXPORT ManagedNotificationTokenContext* results_add_notification_callback(
 REALM_EXPORT Query* results_get_query(Results* results_ptr, NativeException::Marshallable& ex)
 {
     return handle_errors(ex, [&]() {
-        return new Query(results_ptr->get_query());
+        return create_handle<Query>(results_ptr->get_query());
     });
 }
     
@@ -0,0 +1,413 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <iterator>
+#include <stdexcept>
+#include <realm/query_expression.hpp>
+#include "row_bitmap.hpp"
+
+using namespace realm;
+using namespace realm::binding;
+
+namespace {
+
+const size_t container_rows = size_t(1) << 16;
+const size_t bitset_words = container_rows / 64;
+
+// A container switches to a bitset once its sorted array would take more memory than the 8KB bitset.
+const size_t array_limit = 4096;
+
+inline size_t popcount(uint64_t word)
+{
+    word = word - ((word >> 1) & 0x5555555555555555ULL);
+    word = (word & 0x3333333333333333ULL) + ((word >> 2) & 0x3333333333333333ULL);
+    word = (word + (word >> 4)) & 0x0F0F0F0F0F0F0F0FULL;
+    return static_cast<size_t>((word * 0x0101010101010101ULL) >> 56);
+}
+
+// The index of the lowest set bit of a non-zero word, with a de Bruijn sequence since 32-bit MSVC has no 64-bit
+// bit scan intrinsic.
+inline size_t lowest_bit(uint64_t word)
+{
+    static const uint8_t positions[64] = {
+        0, 1, 48, 2, 57, 49, 28, 3, 61, 58, 50, 42, 38, 29, 17, 4,
+        62, 55, 59, 36, 53, 51, 43, 22, 45, 39, 33, 30, 24, 18, 12, 5,
+        63, 47, 56, 27, 60, 41, 37, 16, 54, 35, 52, 21, 44, 32, 23, 11,
+        46, 26, 40, 15, 34, 20, 31, 10, 25, 14, 19, 9, 13, 8, 7, 6
+    };
+    return positions[((word & (0 - word)) * 0x03F79D71B4CB0A89ULL) >> 58];
+}
+
+// A query node matching the rows in a bitmap, which is shared between the clones core makes of the query. It matches
+// fixed row indices, so it is only valid for the version it was built on and refuses to be handed over.
+class RowBitmapExpression : public Expression {
+public:
+    RowBitmapExpression(std::shared_ptr<const RowBitmap> bitmap) : m_bitmap(std::move(bitmap)) { }
+
+    size_t find_first(size_t start, size_t end) const override
+    {
+        const size_t row_ndx = m_bitmap->next(start);
+        return row_ndx < end ? row_ndx : not_found;
+    }
+
+    void set_base_table(const Table* table) override
+    {
+        m_table = table;
+    }
+
+    const Table* get_base_table() const override
+    {
+        return m_table;
+    }
+
+    void verify_column() const override
+    {
+    }
+
+    std::unique_ptr<Expression> clone(QueryNodeHandoverPatches* patches) const override
+    {
+        if (patches)
+            throw std::logic_error("Combined results are a snapshot and can't be passed to another thread.");
+        return std::unique_ptr<Expression>(new RowBitmapExpression(*this));
+    }
+
+private:
+    const Table* m_table = nullptr;
+    const std::shared_ptr<const RowBitmap> m_bitmap;
+};
+
+}
+
+namespace realm {
+namespace binding {
+
+void RowBitmap::add(size_t row_ndx)
+{
+    add(get_container(static_cast<uint32_t>(row_ndx >> 16)), static_cast<uint16_t>(row_ndx));
+}
+
+bool RowBitmap::contains(size_t row_ndx) const
+{
+    auto container = find_container(static_cast<uint32_t>(row_ndx >> 16));
+    return container && contains(*container, static_cast<uint16_t>(row_ndx));
+}
+
+size_t RowBitmap::next(size_t row_ndx) const
+{
+    const uint32_t key = static_cast<uint32_t>(row_ndx >> 16);
+    auto it = std::lower_bound(m_containers.begin(), m_containers.end(), key, [](const Container& container, uint32_t key) {
+        return container.key < key;
+    });
+    for (; it != m_containers.end(); ++it) {
+        const size_t low = next(*it, it->key == key ? row_ndx & 0xFFFF : 0);
+        if (low < container_rows)
+            return (size_t(it->key) << 16) | low;
+    }
+    return not_found;
+}
+
+size_t RowBitmap::size() const
+{
+    size_t size = 0;
+    for (auto& container : m_containers)
+        size += container.cardinality;
+    return size;
+}
+
+RowBitmap RowBitmap::combine(const RowBitmap& rhs, RowSetOperation operation) const
+{
+    RowBitmap result;
+    auto lhs_it = m_containers.begin();
+    auto rhs_it = rhs.m_containers.begin();
+    while (lhs_it != m_containers.end() || rhs_it != rhs.m_containers.end()) {
+        if (rhs_it == rhs.m_containers.end() || (lhs_it != m_containers.end() && lhs_it->key < rhs_it->key)) {
+            if (operation != RowSetOperation::Intersection)
+                result.m_containers.push_back(*lhs_it);
+            ++lhs_it;
+        }
+        else if (lhs_it == m_containers.end() || rhs_it->key < lhs_it->key) {
+            if (operation == RowSetOperation::Union)
+                result.m_containers.push_back(*rhs_it);
+            ++rhs_it;
+        }
+        else {
+            auto container = combine(*lhs_it, *rhs_it, operation);
+            if (container.cardinality > 0)
+                result.m_containers.push_back(std::move(container));
+            ++lhs_it;
+            ++rhs_it;
+        }
+    }
+    return result;
+}
+
+size_t RowBitmap::combined_size(const RowBitmap& rhs, RowSetOperation operation) const
+{
+    size_t intersection = 0;
+    auto lhs_it = m_containers.begin();
+    auto rhs_it = rhs.m_containers.begin();
+    while (lhs_it != m_containers.end() && rhs_it != rhs.m_containers.end()) {
+        if (lhs_it->key < rhs_it->key) {
+            ++lhs_it;
+        }
+        else if (rhs_it->key < lhs_it->key) {
+            ++rhs_it;
+        }
+        else {
+            intersection += intersection_size(*lhs_it, *rhs_it);
+            ++lhs_it;
+            ++rhs_it;
+        }
+    }
+
+    switch (operation) {
+        case RowSetOperation::Union:
+            return size() + rhs.size() - intersection;
+        case RowSetOperation::Intersection:
+            return intersection;
+        case RowSetOperation::Difference:
+            return size() - intersection;
+    }
+    REALM_UNREACHABLE();
+}
+
+const RowBitmap::Container* RowBitmap::find_container(uint32_t key) const
+{
+    auto it = std::lower_bound(m_containers.begin(), m_containers.end(), key, [](const Container& container, uint32_t key) {
+        return container.key < key;
+    });
+    return it != m_containers.end() && it->key == key ? &*it : nullptr;
+}
+
+RowBitmap::Container& RowBitmap::get_container(uint32_t key)
+{
+    if (m_last_container < m_containers.size() && m_containers[m_last_container].key == key)
+        return m_containers[m_last_container];
+
+    auto it = std::lower_bound(m_containers.begin(), m_containers.end(), key, [](const Container& container, uint32_t key) {
+        return container.key < key;
+    });
+    if (it == m_containers.end() || it->key != key) {
+        Container container;
+        container.key = key;
+        it = m_containers.insert(it, std::move(container));
+    }
+    m_last_container = it - m_containers.begin();
+    return *it;
+}
+
+void RowBitmap::add(Container& container, uint16_t low)
+{
+    if (container.is_bitset()) {
+        uint64_t& word = container.bits[low / 64];
+        const uint64_t mask = uint64_t(1) << (low % 64);
+        if (!(word & mask)) {
+            word |= mask;
+            ++container.cardinality;
+        }
+        return;
+    }
+
+    auto& array = container.array;
+    if (array.empty() || array.back() < low) {
+        array.push_back(low);
+    }
+    else {
+        auto it = std::lower_bound(array.begin(), array.end(), low);
+        if (*it == low)
+            return;
+        array.insert(it, low);
+    }
+
+    if (++container.cardinality > array_limit)
+        to_bitset(container);
+}
+
+bool RowBitmap::contains(const Container& container, uint16_t low)
+{
+    if (container.is_bitset())
+        return ((container.bits[low / 64] >> (low % 64)) & 1) != 0;
+
+    return std::binary_search(container.array.begin(), container.array.end(), low);
+}
+
+// Returns the first row of container at or after low, or container_rows.
+size_t RowBitmap::next(const Container& container, size_t low)
+{
+    if (!container.is_bitset()) {
+        auto it = std::lower_bound(container.array.begin(), container.array.end(), low);
+        return it != container.array.end() ? *it : container_rows;
+    }
+
+    size_t word_ndx = low / 64;
+    uint64_t word = container.bits[word_ndx] & (~uint64_t(0) << (low % 64));
+    while (true) {
+        if (word)
+            return word_ndx * 64 + lowest_bit(word);
+        if (++word_ndx == bitset_words)
+            return container_rows;
+        word = container.bits[word_ndx];
+    }
+}
+
+size_t RowBitmap::intersection_size(const Container& lhs, const Container& rhs)
+{
+    if (lhs.is_bitset() && rhs.is_bitset()) {
+        size_t size = 0;
+        for (size_t i = 0; i < bitset_words; ++i)
+            size += popcount(lhs.bits[i] & rhs.bits[i]);
+        return size;
+    }
+
+    if (!lhs.is_bitset() && !rhs.is_bitset()) {
+        size_t size = 0;
+        auto lhs_it = lhs.array.begin();
+        auto rhs_it = rhs.array.begin();
+        while (lhs_it != lhs.array.end() && rhs_it != rhs.array.end()) {
+            if (*lhs_it < *rhs_it) {
+                ++lhs_it;
+            }
+            else if (*rhs_it < *lhs_it) {
+                ++rhs_it;
+            }
+            else {
+                ++size;
+                ++lhs_it;
+                ++rhs_it;
+            }
+        }
+        return size;
+    }
+
+    auto& array = lhs.is_bitset() ? rhs : lhs;
+    auto& bitset = lhs.is_bitset() ? lhs : rhs;
+    return std::count_if(array.array.begin(), array.array.end(), [&](uint16_t low) { return contains(bitset, low); });
+}
+
+RowBitmap::Container RowBitmap::combine(const Container& lhs, const Container& rhs, RowSetOperation operation)
+{
+    Container result;
+    result.key = lhs.key;
+
+    if (!lhs.is_bitset() && !rhs.is_bitset()) {
+        auto out = std::back_inserter(result.array);
+        switch (operation) {
+            case RowSetOperation::Union:
+                std::set_union(lhs.array.begin(), lhs.array.end(), rhs.array.begin(), rhs.array.end(), out);
+                break;
+            case RowSetOperation::Intersection:
+                std::set_intersection(lhs.array.begin(), lhs.array.end(), rhs.array.begin(), rhs.array.end(), out);
+                break;
+            case RowSetOperation::Difference:
+                std::set_difference(lhs.array.begin(), lhs.array.end(), rhs.array.begin(), rhs.array.end(), out);
+                break;
+        }
+        result.cardinality = result.array.size();
+        if (result.cardinality > array_limit)
+            to_bitset(result);
+        return result;
+    }
+
+    // Filtering a small array against a bitset avoids expanding it.
+    if (!lhs.is_bitset() && operation != RowSetOperation::Union) {
+        const bool keep_contained = operation == RowSetOperation::Intersection;
+        std::copy_if(lhs.array.begin(), lhs.array.end(), std::back_inserter(result.array), [&](uint16_t low) {
+            return contains(rhs, low) == keep_contained;
+        });
+        result.cardinality = result.array.size();
+        return result;
+    }
+
+    result.bits = lhs.bits;
+    if (result.bits.empty()) {
+        result.array = lhs.array;
+        to_bitset(result);
+    }
+    Container rhs_bits;
+    auto* rhs_words = &rhs.bits;
+    if (!rhs.is_bitset()) {
+        rhs_bits.array = rhs.array;
+        to_bitset(rhs_bits);
+        rhs_words = &rhs_bits.bits;
+    }
+
+    result.cardinality = 0;
+    for (size_t i = 0; i < bitset_words; ++i) {
+        switch (operation) {
+            case RowSetOperation::Union:
+                result.bits[i] |= (*rhs_words)[i];
+                break;
+            case RowSetOperation::Intersection:
+                result.bits[i] &= (*rhs_words)[i];
+                break;
+            case RowSetOperation::Difference:
+                result.bits[i] &= ~(*rhs_words)[i];
+                break;
+        }
+        result.cardinality += popcount(result.bits[i]);
+    }
+    optimize(result);
+    return result;
+}
+
+void RowBitmap::to_bitset(Container& container)
+{
+    if (container.is_bitset())
+        return;
+
+    container.bits.assign(bitset_words, 0);
+    for (auto low : container.array)
+        container.bits[low / 64] |= uint64_t(1) << (low % 64);
+    std::vector<uint16_t>().swap(container.array);
+}
+
+// Turns a bitset that has become sparse back into an array.
+void RowBitmap::optimize(Container& container)
+{
+    if (!container.is_bitset() || container.cardinality > array_limit)
+        return;
+
+    container.array.reserve(container.cardinality);
+    for (size_t i = 0; i < bitset_words; ++i) {
+        for (uint64_t word = container.bits[i]; word; word &= word - 1)
+            container.array.push_back(static_cast<uint16_t>(i * 64 + lowest_bit(word)));
+    }
+    std::vector<uint64_t>().swap(container.bits);
+}
+
+RowBitmap row_bitmap(Results& results)
+{
+    RowBitmap bitmap;
+    const size_t size = results.size();
+    for (size_t i = 0; i < size; ++i) {
+        auto row = results.get(i);
+        if (row.is_attached())
+            bitmap.add(row.get_index());
+    }
+    return bitmap;
+}
+
+Results results_for_rows(SharedRealm realm, Table& table, std::shared_ptr<const RowBitmap> bitmap)
+{
+    Query query(table, std::unique_ptr<Expression>(new RowBitmapExpression(std::move(bitmap))));
+    return Results(std::move(realm), query.find_all()).snapshot();
+}
+
+} // namespace binding
+} // namespace realm
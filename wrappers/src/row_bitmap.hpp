@@ -0,0 +1,92 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef ROW_BITMAP_HPP
+#define ROW_BITMAP_HPP
+
+#include <memory>
+#include <vector>
+#include <realm.hpp>
+#include "object-store/src/results.hpp"
+
+namespace realm {
+namespace binding {
+
+    // Must stay in sync with RowSetOperation.cs
+    enum class RowSetOperation : uint8_t {
+        Union,
+        Intersection,
+        Difference
+    };
+
+    // A compressed set of table row indices, split like a roaring bitmap into containers of 2^16 rows each. A container
+    // holds a sorted array of the low 16 bits of its rows while it has few of them, and a 2^16 bit bitset otherwise,
+    // so memory stays proportional to the number of rows rather than to the size of the table.
+    class RowBitmap {
+    public:
+        void add(size_t row_ndx);
+
+        bool contains(size_t row_ndx) const;
+
+        // Returns the first row at or after row_ndx, or not_found.
+        size_t next(size_t row_ndx) const;
+
+        size_t size() const;
+
+        RowBitmap combine(const RowBitmap& rhs, RowSetOperation operation) const;
+
+        // The size of combine(rhs, operation), without building it.
+        size_t combined_size(const RowBitmap& rhs, RowSetOperation operation) const;
+
+    private:
+        struct Container {
+            uint32_t key;  // the row indices above the low 16 bits
+            std::vector<uint16_t> array;  // sorted, used while bits is empty
+            std::vector<uint64_t> bits;
+            size_t cardinality = 0;
+
+            bool is_bitset() const { return !bits.empty(); }
+        };
+
+        std::vector<Container> m_containers;  // sorted by key
+        size_t m_last_container = 0;  // rows usually come in order, so the container of the previous add is tried first
+
+        const Container* find_container(uint32_t key) const;
+        Container& get_container(uint32_t key);
+
+        static void add(Container& container, uint16_t low);
+        static bool contains(const Container& container, uint16_t low);
+        static size_t next(const Container& container, size_t low);
+        static size_t intersection_size(const Container& lhs, const Container& rhs);
+        static Container combine(const Container& lhs, const Container& rhs, RowSetOperation operation);
+        static void to_bitset(Container& container);
+        static void optimize(Container& container);
+    };
+
+    // The rows of results. Rows that have been deleted are left out.
+    RowBitmap row_bitmap(Results& results);
+
+    // A snapshot of the rows of table in bitmap, in table order. Core can only build a table view from a query, so the
+    // results' query matches the bitmap's row indices: it goes stale once rows move and must not be rerun or handed
+    // over. Handing it over throws; the managed handle also refuses to query or observe these results.
+    Results results_for_rows(SharedRealm realm, Table& table, std::shared_ptr<const RowBitmap> bitmap);
+
+} // namespace binding
+} // namespace realm
+
+#endif // ROW_BITMAP_HPP
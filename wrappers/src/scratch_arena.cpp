@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "scratch_arena.hpp"
+#include "realm_export_decls.hpp"
+
+using namespace realm::binding;
+
+std::atomic<uint64_t> ScratchArena::arena_allocations(0);
+std::atomic<uint64_t> ScratchArena::heap_allocations(0);
+
+extern "C" {
+
+REALM_EXPORT void scratch_arena_get_allocation_counters(uint64_t& arena_allocations, uint64_t& heap_allocations)
+{
+    arena_allocations = ScratchArena::arena_allocations.load(std::memory_order_relaxed);
+    heap_allocations = ScratchArena::heap_allocations.load(std::memory_order_relaxed);
+}
+
+REALM_EXPORT void scratch_arena_reset_allocation_counters()
+{
+    ScratchArena::arena_allocations.store(0, std::memory_order_relaxed);
+    ScratchArena::heap_allocations.store(0, std::memory_order_relaxed);
+}
+
+}
@@ -0,0 +1,100 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef SCRATCH_ARENA_HPP
+#define SCRATCH_ARENA_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include "thread_specific.hpp"
+
+namespace realm {
+namespace binding {
+
+// A per-thread bump allocator for short lived buffers, such as the UTF-8 copies of strings that are
+// passed in from C#. Memory is only handed out while a ScratchScope is active on the current thread
+// and is reclaimed, all at once, when that scope ends. Requests that do not fit in the remaining
+// space (or that are made outside of a scope) are declined and callers fall back to the heap.
+class ScratchArena {
+public:
+    static const size_t block_size = 64 * 1024;
+
+    static ScratchArena& current()
+    {
+        static ThreadSpecific<ScratchArena> arena;
+        return arena.get();
+    }
+
+    // Returns nullptr if the request can't be served from the arena.
+    char* allocate(size_t size)
+    {
+        const size_t rounded = (size + 7) & ~size_t(7);
+        if (m_depth == 0 || rounded < size || rounded > block_size - m_used) {
+            return nullptr;
+        }
+        if (!m_block) {
+            m_block.reset(new char[block_size]);
+        }
+        char* result = m_block.get() + m_used;
+        m_used += rounded;
+        return result;
+    }
+
+    size_t enter()
+    {
+        ++m_depth;
+        return m_used;
+    }
+
+    void leave(size_t mark)
+    {
+        --m_depth;
+        m_used = mark;
+    }
+
+    // Counters of string buffers served from an arena vs. from the heap, across all threads.
+    static std::atomic<uint64_t> arena_allocations;
+    static std::atomic<uint64_t> heap_allocations;
+
+private:
+    std::unique_ptr<char[]> m_block;
+    size_t m_used = 0;
+    size_t m_depth = 0;
+};
+
+// Scopes nest, so an export that calls another export only releases its scratch memory on the way out,
+// and anything allocated in an outer scope stays valid for the duration of the inner ones.
+class ScratchScope {
+public:
+    ScratchScope() : m_arena(ScratchArena::current()), m_mark(m_arena.enter()) {}
+    ~ScratchScope() { m_arena.leave(m_mark); }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+private:
+    ScratchArena& m_arena;
+    const size_t m_mark;
+};
+
+} // namespace binding
+} // namespace realm
+
+#endif // SCRATCH_ARENA_HPP
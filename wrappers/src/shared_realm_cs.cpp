@@ -20,12 +20,15 @@
 #include <realm/lang_bind_helper.hpp>
 #include "error_handling.hpp"
 #include "realm_export_decls.hpp"
+#include "handle_pool.hpp"
 #include "marshalling.hpp"
 #include "object_accessor.hpp"
 #include "object-store/src/object_store.hpp"
 #include "object-store/src/binding_context.hpp"
 #include <list>
 #include "shared_realm_cs.hpp"
+#include "primary_key_index.hpp"
+#include "object_cs.hpp"
 #include "object-store/src/binding_context.hpp"
 #include <unordered_set>
 #include "object-store/src/thread_safe_reference.hpp"
@@ -36,14 +39,128 @@ using namespace realm::binding;
 using NotifyRealmChangedDelegate = void(void* managed_state_handle);
 NotifyRealmChangedDelegate* notify_realm_changed = nullptr;
 
+namespace {
+
+const ObjectSchema& find_object_schema(const Realm& realm, const Table& table)
+{
+    const std::string object_name(ObjectStore::object_type_for_table_name(table.get_name()));
+    auto object_schema = realm.schema().find(object_name);
+    if (object_schema == realm.schema().end())
+        throw std::logic_error("The table named '" + std::string(table.get_name()) + "' is not part of the schema");
+    return *object_schema;
+}
+
+}
+
 namespace realm {
 namespace binding {
     CSharpBindingContext::CSharpBindingContext(void* managed_state_handle) : m_managed_state_handle(managed_state_handle) {}
+
+    CSharpBindingContext::~CSharpBindingContext() = default;
     
     void CSharpBindingContext::did_change(std::vector<CSharpBindingContext::ObserverState> const& observed, std::vector<void*> const& invalidated, bool version_changed)
     {
+        // Our own commits are reported without a version change, and the indexes were kept up to date by them.
+        if (version_changed)
+            drop_primary_key_indexes();
+
+        if (m_read_version_pins)
+            m_read_version_pins->release_pending();
+
         notify_realm_changed(m_managed_state_handle);
     }
+
+    void CSharpBindingContext::schema_did_change(Schema const& schema)
+    {
+        m_object_schemas.clear();
+        m_tables.clear();
+        drop_primary_key_indexes();
+    }
+
+    const ObjectSchema& CSharpBindingContext::get_object_schema(Realm& realm, const Table& table)
+    {
+        const size_t table_ndx = table.get_index_in_group();
+        if (table_ndx >= m_object_schemas.size())
+            m_object_schemas.resize(table_ndx + 1, nullptr);
+
+        auto& object_schema = m_object_schemas[table_ndx];
+        if (!object_schema)
+            object_schema = &find_object_schema(realm, table);
+        return *object_schema;
+    }
+
+    Table* CSharpBindingContext::get_table(Realm& realm, const uint16_t* object_type, size_t object_type_len)
+    {
+        const std::u16string key(reinterpret_cast<const char16_t*>(object_type), object_type_len);
+        auto& table = m_tables[key];
+        if (!table || !table->is_attached()) {
+            Utf16StringAccessor str(object_type, object_type_len);
+            std::string table_name = ObjectStore::table_name_for_object_type(str);
+            table = realm.read_group().get_table(table_name);
+            if (!table) {
+                m_tables.erase(key);
+                throw std::logic_error("The table named '" + table_name + "' was not found");
+            }
+        }
+
+        LangBindHelper::bind_table_ptr(table.get());
+        return table.get();
+    }
+
+    PrimaryKeyIndex* CSharpBindingContext::get_primary_key_index(Realm& realm, const Table& table)
+    {
+        const ObjectSchema& object_schema = get_object_schema(realm, table);
+        if (object_schema.primary_key.empty())
+            return nullptr;
+
+        if (!PrimaryKeyIndex::can_index(table)) {
+            drop_primary_key_index(table);
+            return nullptr;
+        }
+
+        const size_t table_ndx = table.get_index_in_group();
+        if (table_ndx >= m_primary_key_indexes.size())
+            m_primary_key_indexes.resize(table_ndx + 1);
+
+        auto& index = m_primary_key_indexes[table_ndx];
+        if (!index)
+            index.reset(new PrimaryKeyIndex(table, object_schema.primary_key_property()->table_column));
+        return index.get();
+    }
+
+    PrimaryKeyIndex* CSharpBindingContext::find_primary_key_index(const Table& table)
+    {
+        const size_t table_ndx = table.get_index_in_group();
+        return table_ndx < m_primary_key_indexes.size() ? m_primary_key_indexes[table_ndx].get() : nullptr;
+    }
+
+    void CSharpBindingContext::drop_primary_key_index(const Table& table)
+    {
+        const size_t table_ndx = table.get_index_in_group();
+        if (table_ndx < m_primary_key_indexes.size())
+            m_primary_key_indexes[table_ndx].reset();
+    }
+
+    const ObjectSchema& object_schema_for_table(const SharedRealm& realm, const Table& table)
+    {
+        if (auto context = static_cast<CSharpBindingContext*>(realm->m_binding_context.get()))
+            return context->get_object_schema(*realm, table);
+
+        return find_object_schema(*realm, table);
+    }
+
+    void drop_primary_key_indexes(const SharedRealm& realm)
+    {
+        if (auto context = static_cast<CSharpBindingContext*>(realm->m_binding_context.get()))
+            context->drop_primary_key_indexes();
+    }
+
+    void close_read_version_pins(const SharedRealm& realm)
+    {
+        auto context = static_cast<CSharpBindingContext*>(realm->m_binding_context.get());
+        if (context && context->read_version_pins())
+            context->read_version_pins()->close();
+    }
 }
     
 }
@@ -144,6 +261,7 @@ REALM_EXPORT void shared_realm_destroy(SharedRealm* realm)
 REALM_EXPORT void shared_realm_close_realm(SharedRealm* realm, NativeException::Marshallable& ex)
 {
     handle_errors(ex, [&]() {
+        close_read_version_pins(*realm);
         (*realm)->close();
     });
 }
@@ -151,6 +269,9 @@ REALM_EXPORT void shared_realm_close_realm(SharedRealm* realm, NativeException::
 REALM_EXPORT Table* shared_realm_get_table(SharedRealm* realm, uint16_t* object_type, size_t object_type_len, NativeException::Marshallable& ex)
 {
     return handle_errors(ex, [&]() {
+        if (auto context = static_cast<CSharpBindingContext*>((*realm)->m_binding_context.get()))
+            return context->get_table(**realm, object_type, object_type_len);
+
         Utf16StringAccessor str(object_type, object_type_len);
 
         std::string table_name = ObjectStore::table_name_for_object_type(str);
@@ -187,6 +308,7 @@ REALM_EXPORT void shared_realm_cancel_transaction(SharedRealm* realm, NativeExce
 {
     handle_errors(ex, [&]() {
         (*realm)->cancel_transaction();
+        drop_primary_key_indexes(*realm);
     });
 }
 
@@ -225,21 +347,21 @@ REALM_EXPORT bool shared_realm_compact(SharedRealm* realm, NativeException::Mars
 REALM_EXPORT Object* shared_realm_resolve_object_reference(SharedRealm* realm, ThreadSafeReference<Object>& reference, NativeException::Marshallable& ex)
 {
     return handle_errors(ex, [&]() {
-        return new Object((*realm)->resolve_thread_safe_reference(std::move(reference)));
+        return create_handle<Object>((*realm)->resolve_thread_safe_reference(std::move(reference)));
     });
 }
 
 REALM_EXPORT List* shared_realm_resolve_list_reference(SharedRealm* realm, ThreadSafeReference<List>& reference, NativeException::Marshallable& ex)
 {
     return handle_errors(ex, [&]() {
-        return new List((*realm)->resolve_thread_safe_reference(std::move(reference)));
+        return create_handle<List>((*realm)->resolve_thread_safe_reference(std::move(reference)));
     });
 }
 
 REALM_EXPORT Results* shared_realm_resolve_query_reference(SharedRealm* realm, ThreadSafeReference<Results>& reference, NativeException::Marshallable& ex)
 {
     return handle_errors(ex, [&]() {
-        return new Results((*realm)->resolve_thread_safe_reference(std::move(reference)));
+        return create_handle<Results>((*realm)->resolve_thread_safe_reference(std::move(reference)));
     });
 }
     
@@ -19,6 +19,10 @@
 #ifndef SHARED_REALM_CS_HPP
 #define SHARED_REALM_CS_HPP
 
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include "shared_realm.hpp"
 #include "schema_cs.hpp"
 #include "object-store/src/binding_context.hpp"
@@ -52,20 +56,70 @@ struct Configuration
 };
 
 namespace realm {
+    class ReadVersionPins;
+
 namespace binding {
     
+    class PrimaryKeyIndex;
+
     class CSharpBindingContext: public BindingContext {
     public:
         CSharpBindingContext(void* managed_state_handle);
+        ~CSharpBindingContext();
         void did_change(std::vector<CSharpBindingContext::ObserverState> const& observed, std::vector<void*> const& invalidated, bool version_changed) override;
+        void schema_did_change(Schema const& schema) override;
         
         void* get_managed_state_handle()
         {
             return m_managed_state_handle;
         }
+
+        // The schema of the objects in table, looked up by the table's index in the group instead of by name.
+        const ObjectSchema& get_object_schema(Realm& realm, const Table& table);
+
+        // The table of object_type, given in UTF-16, with its reference count increased like LangBindHelper::get_table.
+        Table* get_table(Realm& realm, const uint16_t* object_type, size_t object_type_len);
+
+        // The primary key index of table, built on first use, or null if the table has no primary key or is too large
+        // to be indexed. Indexes are kept across the binding's own write transactions and dropped when the Realm
+        // advances, its schema changes or a write transaction is rolled back.
+        PrimaryKeyIndex* get_primary_key_index(Realm& realm, const Table& table);
+
+        // The primary key index of table if it has been built, without building it.
+        PrimaryKeyIndex* find_primary_key_index(const Table& table);
+
+        void drop_primary_key_index(const Table& table);
+
+        void drop_primary_key_indexes()
+        {
+            m_primary_key_indexes.clear();
+        }
+
+        // The read version pins of the Realm, created by the first pin.
+        std::shared_ptr<ReadVersionPins>& read_version_pins()
+        {
+            return m_read_version_pins;
+        }
+
     private:
         void* m_managed_state_handle;
+
+        // Both caches point into the Realm's schema and group, so they are cleared whenever the schema changes.
+        std::vector<const ObjectSchema*> m_object_schemas;  // by table index, filled in on first use
+        std::unordered_map<std::u16string, TableRef> m_tables;  // by object type
+        std::vector<std::unique_ptr<PrimaryKeyIndex>> m_primary_key_indexes;  // by table index
+        std::shared_ptr<ReadVersionPins> m_read_version_pins;
     };
+
+    // Like CSharpBindingContext::get_object_schema, falling back to a lookup by name for Realms without a binding
+    // context, such as the ones passed to a migration.
+    const ObjectSchema& object_schema_for_table(const SharedRealm& realm, const Table& table);
+
+    // Calls CSharpBindingContext::drop_primary_key_indexes, if the Realm has a binding context.
+    void drop_primary_key_indexes(const SharedRealm& realm);
+
+    // Unpins every read version pinned on the Realm, which must happen on its thread before it is closed.
+    void close_read_version_pins(const SharedRealm& realm);
 }
     
 }
@@ -0,0 +1,176 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <realm.hpp>
+#include "string_query.hpp"
+#include "marshalling.hpp"
+#include "timestamp_helpers.hpp"
+#include "shared_realm_cs.hpp"
+#include "object-store/src/parser/parser.hpp"
+#include "object-store/src/parser/query_builder.hpp"
+#include "util/format.hpp"
+
+using namespace realm;
+using namespace realm::binding;
+
+namespace {
+
+const size_t predicate_cache_capacity = 64;
+
+// Parsed predicates, most recently used first. Entries are shared so that one evicted by another thread stays alive
+// for as long as it's being applied.
+class PredicateCache {
+public:
+    std::shared_ptr<const parser::Predicate> get(const std::string& object_type, const std::string& text)
+    {
+        Key key(object_type, text);
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            auto it = m_index.find(key);
+            if (it != m_index.end()) {
+                m_entries.splice(m_entries.begin(), m_entries, it->second);
+                return it->second->second;
+            }
+        }
+
+        // Parse outside of the lock. If another thread parsed the same predicate in the meantime, its entry is kept.
+        auto predicate = std::make_shared<const parser::Predicate>(parser::parse(text));
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        auto it = m_index.find(key);
+        if (it != m_index.end())
+            return it->second->second;
+
+        m_entries.emplace_front(key, predicate);
+        m_index.emplace(std::move(key), m_entries.begin());
+        if (m_entries.size() > predicate_cache_capacity) {
+            m_index.erase(m_entries.back().first);
+            m_entries.pop_back();
+        }
+        return predicate;
+    }
+
+private:
+    using Key = std::pair<std::string, std::string>;
+    using Entry = std::pair<Key, std::shared_ptr<const parser::Predicate>>;
+
+    std::mutex m_mutex;
+    std::list<Entry> m_entries;
+    std::map<Key, std::list<Entry>::iterator> m_index;
+};
+
+PredicateCache& predicate_cache()
+{
+    static PredicateCache cache;
+    return cache;
+}
+
+class BufferArguments : public query_builder::Arguments {
+public:
+    BufferArguments(const StringQueryArguments& arguments) : m_arguments(arguments) { }
+
+    bool bool_for_argument(size_t ndx) override
+    {
+        return argument(ndx, PropertyValueType::Bool).value.bool_value;
+    }
+
+    long long long_for_argument(size_t ndx) override
+    {
+        return argument(ndx, PropertyValueType::Int).value.int_value;
+    }
+
+    float float_for_argument(size_t ndx) override
+    {
+        return argument(ndx, PropertyValueType::Float).value.float_value;
+    }
+
+    double double_for_argument(size_t ndx) override
+    {
+        return argument(ndx, PropertyValueType::Double).value.double_value;
+    }
+
+    std::string string_for_argument(size_t ndx) override
+    {
+        auto& data = argument(ndx, PropertyValueType::String).value.data;
+        if (size_t(data.offset) + data.length > m_arguments.string_pool_size)
+            throw std::invalid_argument("Malformed string query arguments");
+        return Utf16StringAccessor(m_arguments.string_pool + data.offset, data.length).to_string();
+    }
+
+    std::string binary_for_argument(size_t ndx) override
+    {
+        auto& data = argument(ndx, PropertyValueType::Binary).value.data;
+        if (size_t(data.offset) + data.length > m_arguments.binary_pool_size)
+            throw std::invalid_argument("Malformed string query arguments");
+        return std::string(m_arguments.binary_pool + data.offset, data.length);
+    }
+
+    Timestamp timestamp_for_argument(size_t ndx) override
+    {
+        return from_ticks(argument(ndx, PropertyValueType::Timestamp).value.ticks);
+    }
+
+    size_t object_index_for_argument(size_t ndx) override
+    {
+        return size_t(argument(ndx, PropertyValueType::Link).value.link_row);
+    }
+
+    bool is_argument_null(size_t ndx) override
+    {
+        return argument(ndx).type == PropertyValueType::Null;
+    }
+
+private:
+    const StringQueryArguments& m_arguments;
+
+    const PropertyValue& argument(size_t ndx) const
+    {
+        if (ndx >= m_arguments.count)
+            throw std::invalid_argument(util::format("Request for argument at index %1 but only %2 arguments are provided", ndx, m_arguments.count));
+        return m_arguments.values[ndx];
+    }
+
+    const PropertyValue& argument(size_t ndx, PropertyValueType type) const
+    {
+        auto& value = argument(ndx);
+        if (value.type != type)
+            throw std::invalid_argument(util::format("Argument %1 doesn't have the type of the property it is compared with", ndx));
+        return value;
+    }
+};
+
+}
+
+namespace realm {
+namespace binding {
+
+void apply_string_predicate(Query& query, const SharedRealm& realm, const std::string& predicate, const StringQueryArguments& arguments)
+{
+    const std::string& object_type = object_schema_for_table(realm, *query.get_table()).name;
+    auto parsed = predicate_cache().get(object_type, predicate);
+
+    BufferArguments buffer_arguments(arguments);
+    query_builder::apply_predicate(query, *parsed, buffer_arguments, realm->schema(), object_type);
+}
+
+} // namespace binding
+} // namespace realm
@@ -0,0 +1,51 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef STRING_QUERY_HPP
+#define STRING_QUERY_HPP
+
+#include <string>
+#include "object_cs.hpp"
+#include "shared_realm.hpp"
+
+namespace realm {
+namespace binding {
+
+    // The values bound to the $0, $1, ... placeholders of a string predicate, in order. property_ndx is ignored;
+    // strings and binaries point into the pools as they do for object_set_values, and links are a row index in the
+    // target table.
+    struct StringQueryArguments {
+        const PropertyValue* values;
+        size_t count;
+        const uint16_t* string_pool;
+        size_t string_pool_size;
+        const char* binary_pool;
+        size_t binary_pool_size;
+    };
+
+    // Parses predicate, e.g. "age > $0 AND name BEGINSWITH $1", with the object store's query parser and appends its
+    // conditions to query. Parsed predicates are kept in a process-wide least recently used cache keyed by object type
+    // and predicate text, so a repeated filter is only bound to its arguments, not parsed again.
+    // Throws std::invalid_argument when an argument is missing or of the wrong type, and std::runtime_error when the
+    // predicate can't be parsed.
+    void apply_string_predicate(Query& query, const SharedRealm& realm, const std::string& predicate, const StringQueryArguments& arguments);
+
+} // namespace binding
+} // namespace realm
+
+#endif // STRING_QUERY_HPP
@@ -21,18 +21,131 @@
 #include "error_handling.hpp"
 #include "marshalling.hpp"
 #include "realm_export_decls.hpp"
+#include "handle_pool.hpp"
 #include "util/format.hpp"
 
 #include <memory>
+#include <string>
+#include <unordered_set>
 #include "timestamp_helpers.hpp"
 #include "object-store/src/results.hpp"
 #include "marshalable_sort_clause.hpp"
 #include "object_accessor.hpp"
+#include "object_cs.hpp"
 #include "schema.hpp"
+#include "shared_realm_cs.hpp"
 
 using namespace realm;
 using namespace realm::binding;
 
+namespace {
+
+bool has_nulls(const ColumnData& column, size_t row_count)
+{
+    if (!column.null_bitmap)
+        return false;
+
+    for (size_t i = 0; i < row_count / 8; ++i) {
+        if (column.null_bitmap[i])
+            return true;
+    }
+    for (size_t row = row_count / 8 * 8; row < row_count; ++row) {
+        if (column.is_null(row))
+            return true;
+    }
+    return false;
+}
+
+void set_primary_key(const SharedRealm& realm, Table& table, const ColumnData& column, size_t column_ndx, size_t row, size_t row_ndx)
+{
+    if (column.is_null(row)) {
+        set_null_unique(realm, table, row_ndx, column_ndx);
+    }
+    else if (column.type == PropertyValueType::Int) {
+        set_int_unique(realm, table, row_ndx, column_ndx, static_cast<const int64_t*>(column.values)[row]);
+    }
+    else {
+        const uint16_t* pool = static_cast<const uint16_t*>(column.values);
+        Utf16StringAccessor str(pool + column.offsets[row], column.offsets[row + 1] - column.offsets[row]);
+        set_string_unique(realm, table, row_ndx, column_ndx, str);
+    }
+}
+
+// Checks the keys of all the rows against each other and against the table, so that a duplicate is reported before
+// any row is added instead of after part of the batch has been written.
+void verify_primary_keys(const SharedRealm& realm, const Table& table, const ColumnData& column, size_t column_ndx, size_t row_count)
+{
+    bool has_null = false;
+    std::unordered_set<int64_t> ints;
+    std::unordered_set<std::string> strings;
+    if (column.type == PropertyValueType::Int)
+        ints.reserve(row_count);
+    else
+        strings.reserve(row_count);
+
+    for (size_t row = 0; row < row_count; ++row) {
+        if (column.is_null(row)) {
+            if (has_null || find_null_primary_key(realm, table, column_ndx) != not_found)
+                throw_duplicate_primary_key(table, column_ndx, "null");
+            has_null = true;
+        }
+        else if (column.type == PropertyValueType::Int) {
+            const int64_t value = static_cast<const int64_t*>(column.values)[row];
+            if (!ints.insert(value).second || find_primary_key(realm, table, column_ndx, value) != not_found)
+                throw_duplicate_primary_key(table, column_ndx, util::format("%1", value));
+        }
+        else {
+            ScratchScope row_scope;
+            const uint16_t* pool = static_cast<const uint16_t*>(column.values);
+            Utf16StringAccessor str(pool + column.offsets[row], column.offsets[row + 1] - column.offsets[row]);
+            std::string value = str.to_string();
+            if (!strings.insert(value).second || find_primary_key(realm, table, column_ndx, StringData(value)) != not_found)
+                throw_duplicate_primary_key(table, column_ndx, std::move(value));
+        }
+    }
+}
+
+void fill_column(Table& table, const ColumnData& column, size_t column_ndx, size_t first_row, size_t row_count)
+{
+    for (size_t row = 0; row < row_count; ++row) {
+        const size_t row_ndx = first_row + row;
+        if (column.is_null(row)) {
+            table.set_null(column_ndx, row_ndx);
+            continue;
+        }
+
+        switch (column.type) {
+            case PropertyValueType::Bool:
+                table.set_bool(column_ndx, row_ndx, static_cast<const uint8_t*>(column.values)[row] != 0);
+                break;
+            case PropertyValueType::Int:
+                table.set_int(column_ndx, row_ndx, static_cast<const int64_t*>(column.values)[row]);
+                break;
+            case PropertyValueType::Float:
+                table.set_float(column_ndx, row_ndx, static_cast<const float*>(column.values)[row]);
+                break;
+            case PropertyValueType::Double:
+                table.set_double(column_ndx, row_ndx, static_cast<const double*>(column.values)[row]);
+                break;
+            case PropertyValueType::Timestamp:
+                table.set_timestamp(column_ndx, row_ndx, from_ticks(static_cast<const int64_t*>(column.values)[row]));
+                break;
+            case PropertyValueType::String: {
+                // Rewind the scratch arena after every row rather than once for the whole batch.
+                ScratchScope row_scope;
+                const uint16_t* pool = static_cast<const uint16_t*>(column.values);
+                Utf16StringAccessor str(pool + column.offsets[row], column.offsets[row + 1] - column.offsets[row]);
+                table.set_string(column_ndx, row_ndx, str);
+                break;
+            }
+            default:
+                REALM_UNREACHABLE();
+        }
+    }
+}
+
+} // anonymous namespace
+
 
 extern "C" {
 
@@ -49,9 +162,67 @@ REALM_EXPORT Object* table_add_empty_object(Table* table_ptr, SharedRealm* realm
         realm->get()->verify_in_write();
         
         size_t row_ndx = table_ptr->add_empty_row(1);
-        const std::string object_name(ObjectStore::object_type_for_table_name(table_ptr->get_name()));
-        auto& object_schema = *realm->get()->schema().find(object_name);
-        return new Object(*realm, object_schema, Row((*table_ptr)[row_ndx]));
+        primary_key_row_added(*realm, *table_ptr, row_ndx);
+        auto& object_schema = object_schema_for_table(*realm, *table_ptr);
+        return create_handle<Object>(*realm, object_schema, Row((*table_ptr)[row_ndx]));
+    });
+}
+
+// Inserts row_count objects whose property values are given column by column and returns the index of
+// the first new row; the rest follow it. All columns, and the primary keys for uniqueness, are checked
+// before any row is added.
+REALM_EXPORT size_t table_add_objects(Table* table_ptr, SharedRealm* realm, size_t row_count, const ColumnData* columns, size_t column_count, NativeException::Marshallable& ex)
+{
+    return handle_errors(ex, [&]() {
+        realm->get()->verify_in_write();
+
+        auto& properties = object_schema_for_table(*realm, *table_ptr).persisted_properties;
+
+        const ColumnData* primary_key = nullptr;
+        bool has_primary_key = false;
+        for (auto& property : properties) {
+            has_primary_key |= property.is_primary;
+        }
+
+        for (const ColumnData* column = columns; column != columns + column_count; ++column) {
+            const Property& property = properties.at(column->property_ndx);
+            if (property.type == PropertyType::Data || property.type == PropertyType::Object)
+                throw std::invalid_argument(util::format("Property '%1' can't be bulk inserted", property.name));
+
+            if (value_type_for(property) != column->type)
+                throw std::invalid_argument(util::format("The values for property '%1' have the wrong type", property.name));
+
+            if (!property.is_nullable && has_nulls(*column, row_count))
+                throw std::invalid_argument(util::format("Property '%1' is not nullable", property.name));
+
+            if (property.is_primary)
+                primary_key = column;
+        }
+
+        if (has_primary_key && !primary_key && row_count > 0)
+            throw std::invalid_argument("Primary key values must be provided");
+
+        const size_t first_row = table_ptr->size();
+        if (primary_key) {
+            const size_t column_ndx = properties[primary_key->property_ndx].table_column;
+            verify_primary_keys(*realm, *table_ptr, *primary_key, column_ndx, row_count);
+
+            // Every row needs its key before the next one is added, as empty rows would all share the default key.
+            for (size_t row = 0; row < row_count; ++row) {
+                ScratchScope row_scope;
+                set_primary_key(*realm, *table_ptr, *primary_key, column_ndx, row, table_ptr->add_empty_row());
+            }
+        }
+        else {
+            table_ptr->add_empty_row(row_count);
+        }
+
+        for (const ColumnData* column = columns; column != columns + column_count; ++column) {
+            if (column != primary_key)
+                fill_column(*table_ptr, *column, properties[column->property_ndx].table_column, first_row, row_count);
+        }
+
+        return first_row;
     });
 }
 
@@ -83,7 +254,7 @@ REALM_EXPORT Results* table_create_results(Table* table_ptr, SharedRealm* realm,
     return handle_errors(ex, [&]() {
         realm->get()->verify_thread();
         
-        return new Results(*realm, *table_ptr);
+        return create_handle<Results>(*realm, *table_ptr);
     });
 }
 
@@ -97,7 +268,7 @@ REALM_EXPORT Results* table_create_sorted_results(Table* table_ptr, SharedRealm*
         unflatten_sort_clauses(sort_clauses, clause_count, flattened_column_indices, column_indices, ascending, properties);
 
         auto sort_descriptor = SortDescriptor(*table_ptr, column_indices, ascending);
-        return new Results(*realm, table_ptr->where(), sort_descriptor);
+        return create_handle<Results>(*realm, table_ptr->where(), sort_descriptor);
     });
 }
     
@@ -108,8 +279,7 @@ Object* object_for_primarykey(Table* table_ptr, SharedRealm* realm, std::functio
     return handle_errors(ex, [&]() -> Object*{
         realm->get()->verify_thread();
         
-        const std::string object_name(ObjectStore::object_type_for_table_name(table_ptr->get_name()));
-        auto& object_schema = *realm->get()->schema().find(object_name);
+        auto& object_schema = object_schema_for_table(*realm, *table_ptr);
         if (object_schema.primary_key.empty()) {
             const std::string name(table_ptr->get_name());
             throw MissingPrimaryKeyException(name);
@@ -120,21 +290,21 @@ Object* object_for_primarykey(Table* table_ptr, SharedRealm* realm, std::functio
         if (row_ndx == not_found)
             return nullptr;
         
-        return new Object(*realm, object_schema, Row(table_ptr->get(row_ndx)));
+        return create_handle<Object>(*realm, object_schema, Row(table_ptr->get(row_ndx)));
     });
 }
 
 REALM_EXPORT Object* object_for_int_primarykey(Table* table_ptr, SharedRealm* realm, int64_t value, NativeException::Marshallable& ex)
 {
     return object_for_primarykey(table_ptr, realm, [=](size_t column_index, Table* table) {
-        return table->find_first_int(column_index, value);
+        return find_primary_key(*realm, *table, column_index, value);
     }, ex);
 }
     
 REALM_EXPORT Object* object_for_null_primarykey(Table* table_ptr, SharedRealm* realm, NativeException::Marshallable& ex)
 {
     return object_for_primarykey(table_ptr, realm, [=](size_t column_index, Table* table) {
-        return table->find_first_null(column_index);
+        return find_null_primary_key(*realm, *table, column_index);
     }, ex);
 }
 
@@ -142,7 +312,7 @@ REALM_EXPORT Object* object_for_string_primarykey(Table* table_ptr, SharedRealm*
 {
     Utf16StringAccessor str(value, value_len);
     return object_for_primarykey(table_ptr, realm, [&](size_t column_index, Table* table) {
-        return table->find_first_string(column_index, str);
+        return find_primary_key(*realm, *table, column_index, StringData(str));
     }, ex);
 }
 
@@ -0,0 +1,59 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef THREAD_SPECIFIC_HPP
+#define THREAD_SPECIFIC_HPP
+
+#include <pthread.h>
+
+namespace realm {
+namespace binding {
+
+// One T per thread, created on first use and destroyed when the thread exits. This stands in for C++11 thread_local,
+// which Apple clang only supports from iOS 9 and which the wrappers still target below that. pthreads are available
+// everywhere the wrappers build, through core's port on Windows.
+template<typename T>
+class ThreadSpecific {
+public:
+    ThreadSpecific()
+    {
+        pthread_key_create(&m_key, [](void* value) { delete static_cast<T*>(value); });
+    }
+
+    // The key is never deleted: instances are function-local statics and threads may still exit after they are gone.
+    ThreadSpecific(const ThreadSpecific&) = delete;
+    ThreadSpecific& operator=(const ThreadSpecific&) = delete;
+
+    T& get()
+    {
+        void* value = pthread_getspecific(m_key);
+        if (!value) {
+            value = new T();
+            pthread_setspecific(m_key, value);
+        }
+        return *static_cast<T*>(value);
+    }
+
+private:
+    pthread_key_t m_key;
+};
+
+} // namespace binding
+} // namespace realm
+
+#endif // THREAD_SPECIFIC_HPP
@@ -0,0 +1,171 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+#include <vector>
+#include "match_scan.hpp"
+#include "top_k.hpp"
+
+using namespace realm;
+using namespace realm::binding;
+
+namespace {
+
+// A sort key of the leading sort column. first is false for null, which core sorts before every value.
+template<typename T>
+using SortKey = std::pair<bool, T>;
+
+// Narrowing costs a full scan of the matches, which only pays off when it leaves far fewer rows to sort.
+const size_t min_rows_per_k = 4;
+
+// NaN is unordered, so a heap or a threshold can't place it. Finding one abandons the narrowing.
+template<typename T>
+bool is_unordered(const T&)
+{
+    return false;
+}
+
+bool is_unordered(float value)
+{
+    return std::isnan(value);
+}
+
+bool is_unordered(double value)
+{
+    return std::isnan(value);
+}
+
+template<typename T, typename Getter>
+bool find_kth_key(Query& query, size_t column_ndx, bool ascending, size_t k, Getter get, SortKey<T>& kth)
+{
+    const Table& table = *query.get_table();
+    const bool nullable = table.is_nullable(column_ndx);
+
+    // A heap of the best k keys seen so far, with the one that sorts last on top. k is below the table size.
+    std::vector<SortKey<T>> heap;
+    heap.reserve(k);
+    auto sorts_before = [ascending](const SortKey<T>& lhs, const SortKey<T>& rhs) {
+        return ascending ? lhs < rhs : rhs < lhs;
+    };
+
+    const bool scanned = for_each_match(query, [&](size_t row_ndx) {
+        SortKey<T> key;
+        if (!nullable || !table.is_null(column_ndx, row_ndx)) {
+            key = SortKey<T>(true, get(table, column_ndx, row_ndx));
+            if (is_unordered(key.second))
+                return false;
+        }
+
+        if (heap.size() < k) {
+            heap.push_back(key);
+            std::push_heap(heap.begin(), heap.end(), sorts_before);
+        }
+        else if (sorts_before(key, heap.front())) {
+            std::pop_heap(heap.begin(), heap.end(), sorts_before);
+            heap.back() = key;
+            std::push_heap(heap.begin(), heap.end(), sorts_before);
+        }
+        return true;
+    });
+
+    if (!scanned || heap.size() < k)
+        return false;
+
+    kth = heap.front();
+    return true;
+}
+
+template<typename T, typename Value>
+void add_threshold(Query& query, size_t column_ndx, bool ascending, const SortKey<T>& kth, Value value)
+{
+    if (!ascending) {
+        // Nulls sort last, so a null k-th key keeps every row and a non-null one keeps no nulls.
+        if (kth.first)
+            query.greater_equal(column_ndx, value);
+        return;
+    }
+
+    if (!kth.first) {
+        query.equal(column_ndx, null());
+        return;
+    }
+
+    if (!query.get_table()->is_nullable(column_ndx)) {
+        query.less_equal(column_ndx, value);
+        return;
+    }
+
+    query.group();
+    query.less_equal(column_ndx, value);
+    query.Or();
+    query.equal(column_ndx, null());
+    query.end_group();
+}
+
+}
+
+namespace realm {
+namespace binding {
+
+void narrow_to_top_k(Query& query, size_t column_ndx, bool ascending, size_t k)
+{
+    if (k == 0 || k > query.get_table()->size() / min_rows_per_k)
+        return;
+
+    switch (query.get_table()->get_column_type(column_ndx)) {
+        case type_Int: {
+            SortKey<int64_t> kth;
+            auto get = [](const Table& table, size_t column, size_t row) { return table.get_int(column, row); };
+            if (find_kth_key(query, column_ndx, ascending, k, get, kth))
+                add_threshold(query, column_ndx, ascending, kth, kth.second);
+            break;
+        }
+        case type_Float: {
+            SortKey<float> kth;
+            auto get = [](const Table& table, size_t column, size_t row) { return table.get_float(column, row); };
+            if (find_kth_key(query, column_ndx, ascending, k, get, kth))
+                add_threshold(query, column_ndx, ascending, kth, kth.second);
+            break;
+        }
+        case type_Double: {
+            SortKey<double> kth;
+            auto get = [](const Table& table, size_t column, size_t row) { return table.get_double(column, row); };
+            if (find_kth_key(query, column_ndx, ascending, k, get, kth))
+                add_threshold(query, column_ndx, ascending, kth, kth.second);
+            break;
+        }
+        case type_Timestamp: {
+            // Compared as (seconds, nanoseconds) so null timestamps never reach Timestamp's comparison operators.
+            SortKey<std::pair<int64_t, int32_t>> kth;
+            auto get = [](const Table& table, size_t column, size_t row) {
+                auto timestamp = table.get_timestamp(column, row);
+                return std::make_pair(timestamp.get_seconds(), timestamp.get_nanoseconds());
+            };
+            if (find_kth_key(query, column_ndx, ascending, k, get, kth))
+                add_threshold(query, column_ndx, ascending, kth, Timestamp(kth.second.first, kth.second.second));
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+} // namespace binding
+} // namespace realm
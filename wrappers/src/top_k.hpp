@@ -0,0 +1,41 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef TOP_K_HPP
+#define TOP_K_HPP
+
+#include <realm.hpp>
+
+namespace realm {
+namespace binding {
+
+    // Restricts query to the rows that can be among the first k rows when sorting on column_ndx, so that only those
+    // rows are sorted rather than every match. The k-th sort key is found with one pass over the matches that keeps a
+    // bounded heap of k keys, and the query is then narrowed to the rows whose key sorts at or before it. Ties with
+    // the k-th key are kept, so ordering on further sort columns is still correct; callers cut the sorted results
+    // down to k rows. Does nothing when the query has fewer than k matches, k isn't much smaller than the table, the
+    // column type can't be compared or a match has a NaN key.
+    //
+    // The threshold is fixed when the query is narrowed, so the narrowed query only holds the first k rows of the
+    // version it was built on. Use it for results that are read and discarded before the realm can change.
+    void narrow_to_top_k(Query& query, size_t column_ndx, bool ascending, size_t k);
+
+} // namespace binding
+} // namespace realm
+
+#endif // TOP_K_HPP
@@ -0,0 +1,557 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include "utf_transcoder.hpp"
+
+#include <atomic>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define REALM_UTF_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+#if REALM_UTF_X86 && (defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+#define REALM_UTF_HAVE_SSE2 1
+#endif
+
+// AVX2 kernels are always compiled on x86 but only ever called after checking cpuid, so they
+// must not leak into code that runs unconditionally. MSVC allows the intrinsics anywhere,
+// GCC and Clang need them scoped to the function.
+#if REALM_UTF_HAVE_SSE2 && (defined(_MSC_VER) || defined(__clang__) || (defined(__GNUC__) && __GNUC__ >= 5))
+#define REALM_UTF_HAVE_AVX2 1
+#if defined(_MSC_VER) && !defined(__clang__)
+#define REALM_UTF_TARGET_AVX2
+#else
+#define REALM_UTF_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace realm {
+namespace binding {
+namespace utf {
+
+namespace {
+
+inline unsigned count_trailing_zeros(uint32_t value)
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long index;
+    _BitScanForward(&index, value);
+    return index;
+#else
+    return __builtin_ctz(value);
+#endif
+}
+
+// POPCNT is not part of the SSE2/AVX2 baseline, so count bits the portable way.
+inline unsigned count_bits(uint32_t value)
+{
+    value = value - ((value >> 1) & 0x55555555);
+    value = (value & 0x33333333) + ((value >> 2) & 0x33333333);
+    return (((value + (value >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24;
+}
+
+inline bool is_continuation(unsigned char c)
+{
+    return (c & 0xC0) == 0x80;
+}
+
+// Decodes a single code point and advances both cursors. Returns false on malformed input.
+template <Validation validation>
+inline bool decode_one(const unsigned char*& in, const unsigned char* end, uint16_t*& out)
+{
+    const unsigned char c0 = in[0];
+    if (c0 < 0x80) {
+        *out++ = c0;
+        in += 1;
+        return true;
+    }
+
+    const size_t available = end - in;
+    if (c0 < 0xE0) {
+        if (available < 2)
+            return false;
+        if (validation == Validation::Strict && (c0 < 0xC2 || !is_continuation(in[1])))
+            return false;
+        *out++ = static_cast<uint16_t>(((c0 & 0x1F) << 6) | (in[1] & 0x3F));
+        in += 2;
+        return true;
+    }
+
+    if (c0 < 0xF0) {
+        if (available < 3)
+            return false;
+        const unsigned char c1 = in[1];
+        if (validation == Validation::Strict) {
+            if (!is_continuation(c1) || !is_continuation(in[2]))
+                return false;
+            if (c0 == 0xE0 && c1 < 0xA0) // overlong
+                return false;
+            if (c0 == 0xED && c1 >= 0xA0) // encoded surrogate
+                return false;
+        }
+        *out++ = static_cast<uint16_t>(((c0 & 0x0F) << 12) | ((c1 & 0x3F) << 6) | (in[2] & 0x3F));
+        in += 3;
+        return true;
+    }
+
+    if (available < 4)
+        return false;
+    const unsigned char c1 = in[1];
+    if (validation == Validation::Strict) {
+        if (c0 > 0xF4 || !is_continuation(c1) || !is_continuation(in[2]) || !is_continuation(in[3]))
+            return false;
+        if (c0 == 0xF0 && c1 < 0x90) // overlong
+            return false;
+        if (c0 == 0xF4 && c1 >= 0x90) // past U+10FFFF
+            return false;
+    }
+    const uint32_t code_point = ((c0 & 0x07) << 18) | ((c1 & 0x3F) << 12) | ((in[2] & 0x3F) << 6) | (in[3] & 0x3F);
+    const uint32_t offset = code_point - 0x10000;
+    *out++ = static_cast<uint16_t>(0xD800 + ((offset >> 10) & 0x3FF));
+    *out++ = static_cast<uint16_t>(0xDC00 + (offset & 0x3FF));
+    in += 4;
+    return true;
+}
+
+// Encodes a single code point and advances both cursors. Returns false on an unpaired surrogate.
+inline bool encode_one(const uint16_t*& in, const uint16_t* end, unsigned char*& out)
+{
+    const uint32_t u0 = in[0];
+    if (u0 < 0x80) {
+        *out++ = static_cast<unsigned char>(u0);
+        in += 1;
+        return true;
+    }
+    if (u0 < 0x800) {
+        *out++ = static_cast<unsigned char>(0xC0 | (u0 >> 6));
+        *out++ = static_cast<unsigned char>(0x80 | (u0 & 0x3F));
+        in += 1;
+        return true;
+    }
+    if (u0 < 0xD800 || u0 >= 0xE000) {
+        *out++ = static_cast<unsigned char>(0xE0 | (u0 >> 12));
+        *out++ = static_cast<unsigned char>(0x80 | ((u0 >> 6) & 0x3F));
+        *out++ = static_cast<unsigned char>(0x80 | (u0 & 0x3F));
+        in += 1;
+        return true;
+    }
+    if (u0 >= 0xDC00 || end - in < 2)
+        return false;
+    const uint32_t u1 = in[1];
+    if (u1 < 0xDC00 || u1 >= 0xE000)
+        return false;
+    const uint32_t code_point = 0x10000 + (((u0 - 0xD800) << 10) | (u1 - 0xDC00));
+    *out++ = static_cast<unsigned char>(0xF0 | (code_point >> 18));
+    *out++ = static_cast<unsigned char>(0x80 | ((code_point >> 12) & 0x3F));
+    *out++ = static_cast<unsigned char>(0x80 | ((code_point >> 6) & 0x3F));
+    *out++ = static_cast<unsigned char>(0x80 | (code_point & 0x3F));
+    in += 2;
+    return true;
+}
+
+// 1 byte below U+0080, 2 below U+0800, 3 otherwise - except that each half of a surrogate pair
+// counts for 2, so the pair adds up to the 4 bytes it encodes to.
+inline size_t utf8_length_of_unit(uint16_t u)
+{
+    return 1 + (u >= 0x80) + (u >= 0x800) - ((u & 0xF800) == 0xD800);
+}
+
+// Scalar kernels
+
+size_t utf8_length_scalar(const uint16_t* in, size_t in_len)
+{
+    size_t length = 0;
+    for (size_t i = 0; i < in_len; ++i) {
+        length += utf8_length_of_unit(in[i]);
+    }
+    return length;
+}
+
+size_t utf16_to_utf8_scalar(const uint16_t* in, size_t in_len, char* out)
+{
+    const uint16_t* end = in + in_len;
+    unsigned char* cursor = reinterpret_cast<unsigned char*>(out);
+    while (in < end) {
+        if (!encode_one(in, end, cursor))
+            return invalid;
+    }
+    return cursor - reinterpret_cast<unsigned char*>(out);
+}
+
+template <Validation validation>
+size_t utf8_to_utf16_scalar(const char* in, size_t in_len, uint16_t* out)
+{
+    const unsigned char* cursor = reinterpret_cast<const unsigned char*>(in);
+    const unsigned char* end = cursor + in_len;
+    uint16_t* out_cursor = out;
+    while (cursor < end) {
+        // Word-at-a-time ASCII skip, so even the portable kernel avoids per-byte branching on plain text.
+        while (end - cursor >= 8) {
+            uint64_t block;
+            memcpy(&block, cursor, sizeof(block));
+            if (block & 0x8080808080808080ULL)
+                break;
+            for (int i = 0; i < 8; ++i)
+                out_cursor[i] = cursor[i];
+            cursor += 8;
+            out_cursor += 8;
+        }
+        if (cursor == end)
+            break;
+        if (!decode_one<validation>(cursor, end, out_cursor))
+            return invalid;
+    }
+    return out_cursor - out;
+}
+
+#if REALM_UTF_HAVE_SSE2
+
+// SSE2 kernels
+
+size_t utf8_length_sse2(const uint16_t* in, size_t in_len)
+{
+    const __m128i mask_ascii = _mm_set1_epi16(static_cast<int16_t>(0xFF80));
+    const __m128i mask_two_bytes = _mm_set1_epi16(static_cast<int16_t>(0xF800));
+    const __m128i surrogate = _mm_set1_epi16(static_cast<int16_t>(0xD800));
+    const __m128i zero = _mm_setzero_si128();
+
+    size_t length = 0;
+    size_t i = 0;
+    for (; i + 8 <= in_len; i += 8) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i high_bits = _mm_and_si128(v, mask_two_bytes);
+        // movemask yields two bits per 16-bit lane, so every count below is doubled
+        const unsigned ascii = _mm_movemask_epi8(_mm_cmpeq_epi16(_mm_and_si128(v, mask_ascii), zero));
+        const unsigned below_800 = _mm_movemask_epi8(_mm_cmpeq_epi16(high_bits, zero));
+        const unsigned surrogates = _mm_movemask_epi8(_mm_cmpeq_epi16(high_bits, surrogate));
+        length += (3 * 16 - count_bits(ascii) - count_bits(below_800) - count_bits(surrogates)) / 2;
+    }
+    return length + utf8_length_scalar(in + i, in_len - i);
+}
+
+size_t utf16_to_utf8_sse2(const uint16_t* in, size_t in_len, char* out)
+{
+    const __m128i mask_ascii = _mm_set1_epi16(static_cast<int16_t>(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+
+    const uint16_t* end = in + in_len;
+    unsigned char* cursor = reinterpret_cast<unsigned char*>(out);
+    while (in < end) {
+        if (end - in >= 16) {
+            const __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in));
+            const __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 8));
+            const __m128i non_ascii = _mm_and_si128(_mm_or_si128(lo, hi), mask_ascii);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi16(non_ascii, zero)) == 0xFFFF) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(cursor), _mm_packus_epi16(lo, hi));
+                in += 16;
+                cursor += 16;
+                continue;
+            }
+        }
+        if (!encode_one(in, end, cursor))
+            return invalid;
+    }
+    return cursor - reinterpret_cast<unsigned char*>(out);
+}
+
+template <Validation validation>
+size_t utf8_to_utf16_sse2(const char* in, size_t in_len, uint16_t* out)
+{
+    const __m128i zero = _mm_setzero_si128();
+
+    const unsigned char* cursor = reinterpret_cast<const unsigned char*>(in);
+    const unsigned char* end = cursor + in_len;
+    uint16_t* out_cursor = out;
+    while (cursor < end) {
+        if (end - cursor >= 16) {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(cursor));
+            const unsigned non_ascii = _mm_movemask_epi8(v);
+            if (non_ascii == 0) {
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out_cursor), _mm_unpacklo_epi8(v, zero));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(out_cursor + 8), _mm_unpackhi_epi8(v, zero));
+                cursor += 16;
+                out_cursor += 16;
+                continue;
+            }
+
+            // widen the ASCII prefix of the block, then fall through to decode the first multi-byte sequence
+            for (unsigned prefix = count_trailing_zeros(non_ascii); prefix > 0; --prefix) {
+                *out_cursor++ = *cursor++;
+            }
+        }
+        if (!decode_one<validation>(cursor, end, out_cursor))
+            return invalid;
+    }
+    return out_cursor - out;
+}
+
+#endif // REALM_UTF_HAVE_SSE2
+
+#if REALM_UTF_HAVE_AVX2
+
+// AVX2 kernels
+
+REALM_UTF_TARGET_AVX2
+size_t utf8_length_avx2(const uint16_t* in, size_t in_len)
+{
+    const __m256i mask_ascii = _mm256_set1_epi16(static_cast<int16_t>(0xFF80));
+    const __m256i mask_two_bytes = _mm256_set1_epi16(static_cast<int16_t>(0xF800));
+    const __m256i surrogate = _mm256_set1_epi16(static_cast<int16_t>(0xD800));
+    const __m256i zero = _mm256_setzero_si256();
+
+    size_t length = 0;
+    size_t i = 0;
+    for (; i + 16 <= in_len; i += 16) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        const __m256i high_bits = _mm256_and_si256(v, mask_two_bytes);
+        const uint32_t ascii = _mm256_movemask_epi8(_mm256_cmpeq_epi16(_mm256_and_si256(v, mask_ascii), zero));
+        const uint32_t below_800 = _mm256_movemask_epi8(_mm256_cmpeq_epi16(high_bits, zero));
+        const uint32_t surrogates = _mm256_movemask_epi8(_mm256_cmpeq_epi16(high_bits, surrogate));
+        length += (3 * 32 - count_bits(ascii) - count_bits(below_800) - count_bits(surrogates)) / 2;
+    }
+    return length + utf8_length_sse2(in + i, in_len - i);
+}
+
+REALM_UTF_TARGET_AVX2
+size_t utf16_to_utf8_avx2(const uint16_t* in, size_t in_len, char* out)
+{
+    const __m256i mask_ascii = _mm256_set1_epi16(static_cast<int16_t>(0xFF80));
+
+    const uint16_t* end = in + in_len;
+    unsigned char* cursor = reinterpret_cast<unsigned char*>(out);
+    while (in < end) {
+        if (end - in >= 16) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+            if (_mm256_testz_si256(v, mask_ascii)) {
+                const __m128i packed = _mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1));
+                _mm_storeu_si128(reinterpret_cast<__m128i*>(cursor), packed);
+                in += 16;
+                cursor += 16;
+                continue;
+            }
+        }
+        if (!encode_one(in, end, cursor))
+            return invalid;
+    }
+    return cursor - reinterpret_cast<unsigned char*>(out);
+}
+
+template <Validation validation>
+REALM_UTF_TARGET_AVX2
+size_t utf8_to_utf16_avx2(const char* in, size_t in_len, uint16_t* out)
+{
+    const unsigned char* cursor = reinterpret_cast<const unsigned char*>(in);
+    const unsigned char* end = cursor + in_len;
+    uint16_t* out_cursor = out;
+    while (cursor < end) {
+        if (end - cursor >= 32) {
+            const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(cursor));
+            const uint32_t non_ascii = _mm256_movemask_epi8(v);
+            if (non_ascii == 0) {
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_cursor), _mm256_cvtepu8_epi16(_mm256_castsi256_si128(v)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out_cursor + 16), _mm256_cvtepu8_epi16(_mm256_extracti128_si256(v, 1)));
+                cursor += 32;
+                out_cursor += 32;
+                continue;
+            }
+
+            for (unsigned prefix = count_trailing_zeros(non_ascii); prefix > 0; --prefix) {
+                *out_cursor++ = *cursor++;
+            }
+        }
+        if (!decode_one<validation>(cursor, end, out_cursor))
+            return invalid;
+    }
+    return out_cursor - out;
+}
+
+#endif // REALM_UTF_HAVE_AVX2
+
+// Runtime dispatch
+
+struct Kernels {
+    Implementation implementation;
+    size_t (*utf8_length)(const uint16_t*, size_t);
+    size_t (*utf16_to_utf8)(const uint16_t*, size_t, char*);
+    size_t (*utf8_to_utf16_strict)(const char*, size_t, uint16_t*);
+    size_t (*utf8_to_utf16_trusted)(const char*, size_t, uint16_t*);
+};
+
+const Kernels scalar_kernels = {
+    Implementation::Scalar,
+    utf8_length_scalar,
+    utf16_to_utf8_scalar,
+    utf8_to_utf16_scalar<Validation::Strict>,
+    utf8_to_utf16_scalar<Validation::Trusted>
+};
+
+#if REALM_UTF_HAVE_SSE2
+const Kernels sse2_kernels = {
+    Implementation::SSE2,
+    utf8_length_sse2,
+    utf16_to_utf8_sse2,
+    utf8_to_utf16_sse2<Validation::Strict>,
+    utf8_to_utf16_sse2<Validation::Trusted>
+};
+#endif
+
+#if REALM_UTF_HAVE_AVX2
+const Kernels avx2_kernels = {
+    Implementation::AVX2,
+    utf8_length_avx2,
+    utf16_to_utf8_avx2,
+    utf8_to_utf16_avx2<Validation::Strict>,
+    utf8_to_utf16_avx2<Validation::Trusted>
+};
+
+bool cpu_supports_avx2()
+{
+    unsigned regs[4] = {};
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    regs[2] = info[2];
+#else
+    if (__get_cpuid_max(0, nullptr) < 7)
+        return false;
+    __cpuid(1, regs[0], regs[1], regs[2], regs[3]);
+#endif
+
+    // the OS has to save the YMM registers on context switches (OSXSAVE + XCR0 bits 1 and 2)
+    const bool osxsave = (regs[2] & (1u << 27)) != 0;
+    const bool cpu_avx = (regs[2] & (1u << 28)) != 0;
+    if (!osxsave || !cpu_avx)
+        return false;
+
+#if defined(_MSC_VER)
+    const unsigned long long xcr0 = _xgetbv(0);
+#else
+    unsigned xcr0_lo, xcr0_hi;
+    __asm__ volatile("xgetbv" : "=a"(xcr0_lo), "=d"(xcr0_hi) : "c"(0));
+    const unsigned long long xcr0 = (static_cast<unsigned long long>(xcr0_hi) << 32) | xcr0_lo;
+#endif
+    if ((xcr0 & 0x6) != 0x6)
+        return false;
+
+#if defined(_MSC_VER)
+    __cpuidex(info, 7, 0);
+    regs[1] = info[1];
+#else
+    __cpuid_count(7, 0, regs[0], regs[1], regs[2], regs[3]);
+#endif
+    return (regs[1] & (1u << 5)) != 0;
+}
+#endif
+
+const Kernels& kernels_for(Implementation implementation)
+{
+    switch (implementation) {
+#if REALM_UTF_HAVE_AVX2
+        case Implementation::AVX2:
+            return avx2_kernels;
+#endif
+#if REALM_UTF_HAVE_SSE2
+        case Implementation::SSE2:
+            return sse2_kernels;
+#endif
+        default:
+            return scalar_kernels;
+    }
+}
+
+Implementation detect_best_implementation()
+{
+#if REALM_UTF_HAVE_AVX2
+    if (cpu_supports_avx2())
+        return Implementation::AVX2;
+#endif
+#if REALM_UTF_HAVE_SSE2
+    return Implementation::SSE2;
+#else
+    return Implementation::Scalar;
+#endif
+}
+
+std::atomic<const Kernels*> active_kernels(nullptr);
+
+inline const Kernels& kernels()
+{
+    const Kernels* current = active_kernels.load(std::memory_order_relaxed);
+    if (current == nullptr) {
+        current = &kernels_for(best_supported_implementation());
+        active_kernels.store(current, std::memory_order_relaxed);
+    }
+    return *current;
+}
+
+} // anonymous namespace
+
+Implementation best_supported_implementation()
+{
+    static const Implementation best = detect_best_implementation();
+    return best;
+}
+
+Implementation active_implementation()
+{
+    return kernels().implementation;
+}
+
+Implementation select_implementation(Implementation requested)
+{
+    if (static_cast<int>(requested) > static_cast<int>(best_supported_implementation())) {
+        requested = best_supported_implementation();
+    }
+
+    const Kernels& selected = kernels_for(requested);
+    active_kernels.store(&selected, std::memory_order_relaxed);
+    return selected.implementation;
+}
+
+size_t utf8_length(const uint16_t* in, size_t in_len)
+{
+    return kernels().utf8_length(in, in_len);
+}
+
+size_t utf16_to_utf8(const uint16_t* in, size_t in_len, char* out)
+{
+    return kernels().utf16_to_utf8(in, in_len, out);
+}
+
+size_t utf8_to_utf16(const char* in, size_t in_len, uint16_t* out, Validation validation)
+{
+    const Kernels& active = kernels();
+    if (validation == Validation::Strict) {
+        return active.utf8_to_utf16_strict(in, in_len, out);
+    }
+    return active.utf8_to_utf16_trusted(in, in_len, out);
+}
+
+} // namespace utf
+} // namespace binding
+} // namespace realm
@@ -0,0 +1,74 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef UTF_TRANSCODER_HPP
+#define UTF_TRANSCODER_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace realm {
+namespace binding {
+namespace utf {
+
+// Returned by the transcoding functions when the input is not well formed.
+static const size_t invalid = static_cast<size_t>(-1);
+
+// The kernels available to the transcoder. Which ones are actually usable depends on the
+// architecture the wrappers were compiled for and on the CPU they are running on.
+enum class Implementation {
+    Scalar,
+    SSE2,
+    AVX2
+};
+
+// Strict validation rejects overlong encodings, encoded surrogates and code points past U+10FFFF.
+// Trusted input (e.g. names that were validated when they were written) only gets bounds checks.
+enum class Validation {
+    Strict,
+    Trusted
+};
+
+// The best implementation supported by the current CPU. Detected once, on first use.
+Implementation best_supported_implementation();
+
+Implementation active_implementation();
+
+// Forces the transcoder to use a particular implementation, which is mostly useful for
+// benchmarking. Requests for kernels the CPU does not support fall back to the best
+// supported one. Returns the implementation that was actually selected.
+Implementation select_implementation(Implementation requested);
+
+// The exact number of UTF-8 bytes needed to encode a well formed UTF-16 string.
+size_t utf8_length(const uint16_t* in, size_t in_len);
+
+// Encodes UTF-16 as UTF-8. `out` must have room for utf8_length(in, in_len) bytes - or simply
+// 3 * in_len bytes, which is always enough. Returns the number of bytes written, or `invalid`
+// if the input contains an unpaired surrogate.
+size_t utf16_to_utf8(const uint16_t* in, size_t in_len, char* out);
+
+// Decodes UTF-8 into UTF-16 in a single pass. `out` must have room for in_len 16-bit units,
+// since no UTF-8 sequence decodes to more units than it has bytes. Returns the number of units
+// written, or `invalid` if the input is malformed.
+size_t utf8_to_utf16(const char* in, size_t in_len, uint16_t* out, Validation validation = Validation::Strict);
+
+} // namespace utf
+} // namespace binding
+} // namespace realm
+
+#endif // UTF_TRANSCODER_HPP
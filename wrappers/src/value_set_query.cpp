@@ -0,0 +1,196 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#include <memory>
+#include <stdexcept>
+#include <unordered_set>
+#include <realm/query_expression.hpp>
+#include <realm/util/format.hpp>
+#include "value_set_query.hpp"
+
+using namespace realm;
+using namespace realm::binding;
+
+namespace {
+
+// Up to this many values an equality group is cheaper than building and probing a hash set.
+const size_t small_list_size = 8;
+
+// Equality on an indexed column is answered from the index, so the group stays worth it for longer lists.
+const size_t indexed_list_size = 256;
+
+struct StringDataHash {
+    size_t operator()(StringData value) const noexcept
+    {
+        // FNV-1a
+        uint64_t hash = 14695981039346656037ULL;
+        for (size_t i = 0; i < value.size(); ++i) {
+            hash ^= static_cast<unsigned char>(value.data()[i]);
+            hash *= 1099511628211ULL;
+        }
+        return static_cast<size_t>(hash);
+    }
+};
+
+struct IntSet {
+    std::unordered_set<int64_t> values;
+
+    bool contains(const Table& table, size_t column_ndx, size_t row_ndx) const
+    {
+        return values.count(table.get_int(column_ndx, row_ndx)) != 0;
+    }
+};
+
+struct StringSet {
+    // The set refers into storage, which is not modified once the set is built.
+    std::vector<std::string> storage;
+    std::unordered_set<StringData, StringDataHash> values;
+
+    bool contains(const Table& table, size_t column_ndx, size_t row_ndx) const
+    {
+        return values.count(table.get_string(column_ndx, row_ndx)) != 0;
+    }
+};
+
+// A query node matching the rows whose value is in Set. The set is shared between the clones core makes of the
+// query, for example when it is handed over to another thread or copied into Results, since it never changes.
+// The table comes from set_base_table, which core calls again after a handover, so no handover patch is needed.
+template<typename Set>
+class ValueSetExpression : public Expression {
+public:
+    ValueSetExpression(size_t column_ndx, std::shared_ptr<const Set> set, bool match_null)
+    : m_column_ndx(column_ndx), m_set(std::move(set)), m_match_null(match_null) { }
+
+    size_t find_first(size_t start, size_t end) const override
+    {
+        const bool nullable = m_table->is_nullable(m_column_ndx);
+        for (size_t row_ndx = start; row_ndx < end; ++row_ndx) {
+            if (nullable && m_table->is_null(m_column_ndx, row_ndx)) {
+                if (m_match_null)
+                    return row_ndx;
+            }
+            else if (m_set->contains(*m_table, m_column_ndx, row_ndx)) {
+                return row_ndx;
+            }
+        }
+        return not_found;
+    }
+
+    void set_base_table(const Table* table) override
+    {
+        m_table = table;
+    }
+
+    const Table* get_base_table() const override
+    {
+        return m_table;
+    }
+
+    void verify_column() const override
+    {
+        if (m_column_ndx >= m_table->get_column_count())
+            throw LogicError(LogicError::column_index_out_of_range);
+    }
+
+    std::unique_ptr<Expression> clone(QueryNodeHandoverPatches*) const override
+    {
+        return std::unique_ptr<Expression>(new ValueSetExpression(*this));
+    }
+
+private:
+    const Table* m_table = nullptr;
+    const size_t m_column_ndx;
+    const std::shared_ptr<const Set> m_set;
+    const bool m_match_null;
+};
+
+void check_column_type(const Query& query, size_t column_ndx, DataType type)
+{
+    auto& table = *query.get_table();
+    if (table.get_column_type(column_ndx) != type)
+        throw std::invalid_argument(util::format("Column '%1' can't be compared with these values", table.get_column_name(column_ndx)));
+}
+
+bool use_equality_group(const Query& query, size_t column_ndx, size_t count)
+{
+    return count > 0 && (count <= small_list_size || (count <= indexed_list_size && query.get_table()->has_search_index(column_ndx)));
+}
+
+template<typename Set>
+void add_value_set(Query& query, size_t column_ndx, std::shared_ptr<const Set> set, bool match_null)
+{
+    auto& table = *query.get_table();
+    query.and_query(Query(table, std::unique_ptr<Expression>(new ValueSetExpression<Set>(column_ndx, std::move(set), match_null))));
+}
+
+template<typename T>
+void add_equality_group(Query& query, size_t column_ndx, const std::vector<T>& values, bool match_null)
+{
+    query.group();
+    for (size_t i = 0; i < values.size(); ++i) {
+        if (i > 0)
+            query.Or();
+        query.equal(column_ndx, values[i]);
+    }
+    if (match_null) {
+        query.Or();
+        query.equal(column_ndx, null());
+    }
+    query.end_group();
+}
+
+}
+
+namespace realm {
+namespace binding {
+
+void add_int_in(Query& query, size_t column_ndx, const int64_t* values, size_t count, bool match_null)
+{
+    check_column_type(query, column_ndx, type_Int);
+
+    if (use_equality_group(query, column_ndx, count)) {
+        add_equality_group(query, column_ndx, std::vector<int64_t>(values, values + count), match_null);
+        return;
+    }
+
+    auto set = std::make_shared<IntSet>();
+    set->values.reserve(count);
+    set->values.insert(values, values + count);
+    add_value_set<IntSet>(query, column_ndx, std::move(set), match_null);
+}
+
+void add_string_in(Query& query, size_t column_ndx, std::vector<std::string> values, bool match_null)
+{
+    check_column_type(query, column_ndx, type_String);
+
+    if (use_equality_group(query, column_ndx, values.size())) {
+        std::vector<StringData> strings(values.begin(), values.end());
+        add_equality_group(query, column_ndx, strings, match_null);
+        return;
+    }
+
+    auto set = std::make_shared<StringSet>();
+    set->storage = std::move(values);
+    set->values.reserve(set->storage.size());
+    for (auto& value : set->storage)
+        set->values.insert(value);
+    add_value_set<StringSet>(query, column_ndx, std::move(set), match_null);
+}
+
+} // namespace binding
+} // namespace realm
@@ -0,0 +1,40 @@
+////////////////////////////////////////////////////////////////////////////
+//
+// Copyright 2017 Realm Inc.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+// http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+////////////////////////////////////////////////////////////////////////////
+
+#ifndef VALUE_SET_QUERY_HPP
+#define VALUE_SET_QUERY_HPP
+
+#include <string>
+#include <vector>
+#include <realm.hpp>
+
+namespace realm {
+namespace binding {
+
+    // Appends a condition to query matching the rows whose value in column_ndx is one of values, or is null when
+    // match_null is set. Short lists, and longer ones on an indexed column, become a group of equality conditions that
+    // core can answer from the search index. Longer lists are matched by a single node that looks each row's value up
+    // in a hash set, so evaluation no longer grows with the number of values. An empty list without match_null
+    // matches nothing.
+    void add_int_in(Query& query, size_t column_ndx, const int64_t* values, size_t count, bool match_null);
+    void add_string_in(Query& query, size_t column_ndx, std::vector<std::string> values, bool match_null);
+
+} // namespace binding
+} // namespace realm
+
+#endif // VALUE_SET_QUERY_HPP